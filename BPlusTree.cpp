@@ -0,0 +1,588 @@
+/**
+ * @file BPlusTree.cpp
+ * @brief Implementation of the BPlusTree class.
+ *
+ * @details
+ * This file contains the iterative implementation of the B+-tree engine.
+ * Every descent records the inner nodes it passes through, and the child
+ * slot it took in each, in small fixed-size arrays. Splits on insert and
+ * borrow/merge repairs on remove then walk that recorded path back upward,
+ * so no recursion and no parent pointers are needed.
+ *
+ * Node type is implied by depth: the tree tracks its number of levels, and
+ * every node on the last level is a Leaf while every node above it is an
+ * Inner node.
+ */
+
+#include "BPlusTree.h"
+#include <iostream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BPLUS_USE_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+/**
+ * Number of set bits in a SIMD movemask result (at most eight bits).
+ * GCC and Clang emit a single popcnt where the target has it; MSVC's
+ * __popcnt requires that instruction, which every AVX2 processor has, so
+ * the SSE2-only MSVC build keeps a nibble table.
+ */
+inline int maskBits(int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(static_cast<unsigned int>(mask));
+#elif defined(_MSC_VER) && defined(__AVX2__)
+    return static_cast<int>(__popcnt(static_cast<unsigned int>(mask)));
+#else
+    static const unsigned char bits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+    return bits[mask & 15] + bits[(mask >> 4) & 15];
+#endif
+}
+
+/**
+ * Number of keys in keys[0..count) strictly greater than value when
+ * greater is true, or strictly less than value when it is false. Keys are
+ * compared a whole SIMD register at a time; the movemask of the comparison
+ * has one bit per matching key, and only the bit count is needed.
+ */
+inline int countCompare(const int* keys, int count, int value, bool greater) {
+    int result = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i v8 = _mm256_set1_epi32(value);
+    for (; i + 8 <= count; i += 8) {
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i cmp = greater ? _mm256_cmpgt_epi32(k, v8) : _mm256_cmpgt_epi32(v8, k);
+        result += maskBits(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+    }
+#endif
+
+#if defined(__AVX2__) || defined(BPLUS_USE_SSE2)
+    const __m128i v4 = _mm_set1_epi32(value);
+    for (; i + 4 <= count; i += 4) {
+        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i cmp = greater ? _mm_cmpgt_epi32(k, v4) : _mm_cmpgt_epi32(v4, k);
+        result += maskBits(_mm_movemask_ps(_mm_castsi128_ps(cmp)));
+    }
+#endif
+
+    for (; i < count; i++)
+        result += greater ? (keys[i] > value) : (keys[i] < value);
+
+    return result;
+}
+
+} // namespace
+
+/**
+ * Initializes an empty tree with no levels.
+ */
+BPlusTree::BPlusTree() : root(nullptr), levels(0), valueCount(0) {}
+
+/**
+ * Calls destroyTree() to free all nodes.
+ */
+BPlusTree::~BPlusTree() {
+    destroyTree();
+}
+
+/**
+ * For sorted keys, the number of keys below value is also the index of the
+ * first key not less than value.
+ */
+int BPlusTree::countLess(const int* keys, int count, int value) {
+    return countCompare(keys, count, value, false);
+}
+
+/**
+ * For sorted separators, the number of keys not greater than value is the
+ * index of the child whose range contains value.
+ */
+int BPlusTree::countLessEqual(const int* keys, int count, int value) {
+    return count - countCompare(keys, count, value, true);
+}
+
+/**
+ * Descends to the leaf whose range contains the value, recording the path.
+ * A leaf with room takes the value in sorted position. A full leaf is
+ * split in half, the new right leaf is linked into the leaf chain, and its
+ * first key is passed up to the parent as a separator.
+ */
+void BPlusTree::insert(int value) {
+    // Special case: empty tree
+    if (!root) {
+        Leaf* leaf = new Leaf;
+        leaf->count = 1;
+        leaf->next = nullptr;
+        leaf->keys[0] = value;
+        root = leaf;
+        levels = 1;
+        valueCount = 1;
+        return;
+    }
+
+    Inner* path[kMaxLevels];
+    int depth = 0;
+    void* node = root;
+
+    while (depth < levels - 1) {
+        Inner* in = static_cast<Inner*>(node);
+        path[depth++] = in;
+        node = in->children[countLessEqual(in->keys, in->count, value)];
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    int pos = countLess(leaf->keys, leaf->count, value);
+
+    if (pos < leaf->count && leaf->keys[pos] == value)
+        return; // Duplicate value detected; nothing to insert
+
+    valueCount++;
+
+    if (leaf->count < kLeafKeys) {
+        for (int i = leaf->count; i > pos; i--)
+            leaf->keys[i] = leaf->keys[i - 1];
+        leaf->keys[pos] = value;
+        leaf->count++;
+        return;
+    }
+
+    // Leaf is full: merge the new value into a temporary array and split it
+    int merged[kLeafKeys + 1];
+    for (int i = 0, j = 0; i <= kLeafKeys; i++)
+        merged[i] = (i == pos) ? value : leaf->keys[j++];
+
+    Leaf* right = new Leaf;
+    int leftCount = (kLeafKeys + 1) / 2;
+
+    leaf->count = leftCount;
+    for (int i = 0; i < leftCount; i++)
+        leaf->keys[i] = merged[i];
+
+    right->count = kLeafKeys + 1 - leftCount;
+    for (int i = 0; i < right->count; i++)
+        right->keys[i] = merged[leftCount + i];
+
+    right->next = leaf->next;
+    leaf->next = right;
+
+    insertIntoParent(path, depth, right->keys[0], right);
+}
+
+/**
+ * Walks up the recorded path inserting the separator and its right child.
+ * A full inner node is split around its middle key, which moves up (rather
+ * than being copied, as for leaves) to become the next separator. If the
+ * root itself splits, a new root is created and the tree grows by a level.
+ */
+void BPlusTree::insertIntoParent(Inner** path, int depth, int separator, void* rightChild) {
+    while (depth > 0) {
+        Inner* in = path[--depth];
+        int pos = countLess(in->keys, in->count, separator);
+
+        if (in->count < kInnerKeys) {
+            for (int i = in->count; i > pos; i--) {
+                in->keys[i] = in->keys[i - 1];
+                in->children[i + 1] = in->children[i];
+            }
+            in->keys[pos] = separator;
+            in->children[pos + 1] = rightChild;
+            in->count++;
+            return;
+        }
+
+        // Inner node is full: build the merged key and child arrays
+        int keys[kInnerKeys + 1];
+        void* children[kInnerKeys + 2];
+
+        children[0] = in->children[0];
+        for (int i = 0, j = 0; i <= kInnerKeys; i++) {
+            if (i == pos) {
+                keys[i] = separator;
+                children[i + 1] = rightChild;
+            }
+            else {
+                keys[i] = in->keys[j];
+                children[i + 1] = in->children[j + 1];
+                j++;
+            }
+        }
+
+        int mid = (kInnerKeys + 1) / 2;
+        Inner* right = new Inner;
+
+        in->count = mid;
+        for (int i = 0; i < mid; i++) {
+            in->keys[i] = keys[i];
+            in->children[i] = children[i];
+        }
+        in->children[mid] = children[mid];
+
+        right->count = kInnerKeys - mid;
+        for (int i = 0; i < right->count; i++) {
+            right->keys[i] = keys[mid + 1 + i];
+            right->children[i] = children[mid + 1 + i];
+        }
+        right->children[right->count] = children[kInnerKeys + 1];
+
+        separator = keys[mid];
+        rightChild = right;
+    }
+
+    // The root was split: grow the tree by one level
+    Inner* newRoot = new Inner;
+    newRoot->count = 1;
+    newRoot->keys[0] = separator;
+    newRoot->children[0] = root;
+    newRoot->children[1] = rightChild;
+    root = newRoot;
+    levels++;
+}
+
+/**
+ * Descends through the inner nodes and checks the leaf for the value.
+ */
+bool BPlusTree::search(int value) const {
+    if (!root) return false;
+
+    const void* node = root;
+    for (int d = 0; d < levels - 1; d++) {
+        const Inner* in = static_cast<const Inner*>(node);
+        node = in->children[countLessEqual(in->keys, in->count, value)];
+    }
+
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    int pos = countLess(leaf->keys, leaf->count, value);
+    return pos < leaf->count && leaf->keys[pos] == value;
+}
+
+void BPlusTree::searchBatch(const int* values, std::size_t count, bool* results) const {
+    for (std::size_t i = 0; i < count; i++)
+        results[i] = search(values[i]);
+}
+
+/**
+ * Removes the value from its leaf. A root leaf may shrink to empty; any
+ * other leaf that drops below half full is repaired by fixUnderflow().
+ */
+bool BPlusTree::remove(int value) {
+    if (!root) return false;
+
+    Inner* path[kMaxLevels];
+    int slots[kMaxLevels];
+    int depth = 0;
+    void* node = root;
+
+    while (depth < levels - 1) {
+        Inner* in = static_cast<Inner*>(node);
+        int slot = countLessEqual(in->keys, in->count, value);
+        path[depth] = in;
+        slots[depth] = slot;
+        depth++;
+        node = in->children[slot];
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    int pos = countLess(leaf->keys, leaf->count, value);
+
+    if (pos >= leaf->count || leaf->keys[pos] != value)
+        return false; // Value not found
+
+    for (int i = pos; i < leaf->count - 1; i++)
+        leaf->keys[i] = leaf->keys[i + 1];
+    leaf->count--;
+    valueCount--;
+
+    if (levels == 1) {
+        if (leaf->count == 0) {
+            delete leaf;
+            root = nullptr;
+            levels = 0;
+        }
+        return true;
+    }
+
+    if (leaf->count < kLeafKeys / 2)
+        fixUnderflow(path, slots, depth);
+
+    return true;
+}
+
+/**
+ * Repairs the underfull node at the bottom of the path, one level per loop
+ * iteration:
+ * - If an adjacent sibling has more than the minimum, one key moves across
+ *   and the separator in the parent is updated; the repair is complete.
+ * - Otherwise the node is merged with a sibling and the separator between
+ *   them is removed from the parent, which may leave the parent underfull
+ *   and continues the repair one level up.
+ * When the root is left with no separators, its only child becomes the new
+ * root and the tree shrinks by a level.
+ */
+void BPlusTree::fixUnderflow(Inner** path, int* slots, int depth) {
+    bool isLeaf = true;
+
+    while (depth > 0) {
+        Inner* parent = path[depth - 1];
+        int ci = slots[depth - 1];
+        int removeAt;   // separator index to drop from parent after a merge
+
+        if (isLeaf) {
+            Leaf* n = static_cast<Leaf*>(parent->children[ci]);
+            Leaf* left = ci > 0 ? static_cast<Leaf*>(parent->children[ci - 1]) : nullptr;
+            Leaf* right = ci < parent->count ? static_cast<Leaf*>(parent->children[ci + 1]) : nullptr;
+            const int minKeys = kLeafKeys / 2;
+
+            if (left && left->count > minKeys) {
+                for (int i = n->count; i > 0; i--)
+                    n->keys[i] = n->keys[i - 1];
+                n->keys[0] = left->keys[--left->count];
+                n->count++;
+                parent->keys[ci - 1] = n->keys[0];
+                return;
+            }
+
+            if (right && right->count > minKeys) {
+                n->keys[n->count++] = right->keys[0];
+                for (int i = 0; i < right->count - 1; i++)
+                    right->keys[i] = right->keys[i + 1];
+                right->count--;
+                parent->keys[ci] = right->keys[0];
+                return;
+            }
+
+            // Merge the right-hand leaf of the pair into the left-hand one
+            Leaf* dst = left ? left : n;
+            Leaf* src = left ? n : right;
+            for (int i = 0; i < src->count; i++)
+                dst->keys[dst->count + i] = src->keys[i];
+            dst->count += src->count;
+            dst->next = src->next;
+            delete src;
+            removeAt = left ? ci - 1 : ci;
+        }
+        else {
+            Inner* n = static_cast<Inner*>(parent->children[ci]);
+            Inner* left = ci > 0 ? static_cast<Inner*>(parent->children[ci - 1]) : nullptr;
+            Inner* right = ci < parent->count ? static_cast<Inner*>(parent->children[ci + 1]) : nullptr;
+            const int minKeys = kInnerKeys / 2;
+
+            if (left && left->count > minKeys) {
+                // Rotate right: parent separator moves down, left's last key moves up
+                n->children[n->count + 1] = n->children[n->count];
+                for (int i = n->count; i > 0; i--) {
+                    n->keys[i] = n->keys[i - 1];
+                    n->children[i] = n->children[i - 1];
+                }
+                n->keys[0] = parent->keys[ci - 1];
+                n->children[0] = left->children[left->count];
+                n->count++;
+                parent->keys[ci - 1] = left->keys[--left->count];
+                return;
+            }
+
+            if (right && right->count > minKeys) {
+                // Rotate left: parent separator moves down, right's first key moves up
+                n->keys[n->count] = parent->keys[ci];
+                n->children[n->count + 1] = right->children[0];
+                n->count++;
+                parent->keys[ci] = right->keys[0];
+                for (int i = 0; i < right->count - 1; i++) {
+                    right->keys[i] = right->keys[i + 1];
+                    right->children[i] = right->children[i + 1];
+                }
+                right->children[right->count - 1] = right->children[right->count];
+                right->count--;
+                return;
+            }
+
+            // Merge: left keys + parent separator + right keys
+            Inner* dst = left ? left : n;
+            Inner* src = left ? n : right;
+            int sepIndex = left ? ci - 1 : ci;
+
+            dst->keys[dst->count] = parent->keys[sepIndex];
+            for (int i = 0; i < src->count; i++) {
+                dst->keys[dst->count + 1 + i] = src->keys[i];
+                dst->children[dst->count + 1 + i] = src->children[i];
+            }
+            dst->children[dst->count + 1 + src->count] = src->children[src->count];
+            dst->count += 1 + src->count;
+            delete src;
+            removeAt = sepIndex;
+        }
+
+        // Drop separator removeAt and the child to its right from the parent
+        for (int i = removeAt; i < parent->count - 1; i++) {
+            parent->keys[i] = parent->keys[i + 1];
+            parent->children[i + 1] = parent->children[i + 2];
+        }
+        parent->count--;
+
+        isLeaf = false;
+        depth--;
+
+        if (depth == 0) {
+            // Parent is the root; collapse it once it has a single child
+            if (parent->count == 0) {
+                root = parent->children[0];
+                delete parent;
+                levels--;
+            }
+            return;
+        }
+
+        if (parent->count >= kInnerKeys / 2)
+            return;
+    }
+}
+
+/**
+ * Prints every value through forEachInorder(), which follows the leaf chain.
+ */
+void BPlusTree::inorder() const {
+    if (!root) return;
+
+    forEachInorder([](int value) { std::cout << value << " "; });
+
+    std::cout << std::endl;
+}
+
+/**
+ * Follows the first child of every inner node down to the leaf level.
+ */
+const BPlusTree::Leaf* BPlusTree::firstLeaf() const {
+    if (!root) return nullptr;
+
+    const void* node = root;
+    for (int d = 0; d < levels - 1; d++)
+        node = static_cast<const Inner*>(node)->children[0];
+    return static_cast<const Leaf*>(node);
+}
+
+/**
+ * Prints each level in turn, from the root down to the leaves.
+ */
+void BPlusTree::levelOrder() const {
+    for (int level = 0; level < levels; level++) {
+        printLevel(level);
+        std::cout << std::endl;
+    }
+}
+
+std::size_t BPlusTree::size() const {
+    return valueCount;
+}
+
+int BPlusTree::height() const {
+    return levels;
+}
+
+/**
+ * Depth-first walk, using a fixed-size stack of (inner node, next child)
+ * pairs, that prints the nodes found at exactly the requested level from
+ * left to right. Inner nodes and leaves share the bracketed format.
+ */
+void BPlusTree::printLevel(int level) const {
+    const Inner* stack[kMaxLevels];
+    int next[kMaxLevels];
+    int top = 0;
+
+    const void* start = root;
+    if (level > 0) {
+        stack[top] = static_cast<const Inner*>(root);
+        next[top] = 0;
+        top++;
+        start = nullptr;
+    }
+
+    while (start || top > 0) {
+        const void* node = start;
+        start = nullptr;
+
+        if (!node) {
+            const Inner* in = stack[top - 1];
+            if (next[top - 1] > in->count) {
+                top--;
+                continue;
+            }
+            node = in->children[next[top - 1]++];
+
+            if (top < level) {
+                stack[top] = static_cast<const Inner*>(node);
+                next[top] = 0;
+                top++;
+                continue;
+            }
+        }
+
+        const int* keys;
+        int count;
+        if (level == levels - 1) {
+            keys = static_cast<const Leaf*>(node)->keys;
+            count = static_cast<const Leaf*>(node)->count;
+        }
+        else {
+            keys = static_cast<const Inner*>(node)->keys;
+            count = static_cast<const Inner*>(node)->count;
+        }
+
+        std::cout << "[";
+        for (int i = 0; i < count; i++)
+            std::cout << (i ? " " : "") << keys[i];
+        std::cout << "] ";
+    }
+}
+
+/**
+ * Post-order walk with a fixed-size stack that deletes each inner node
+ * after all of its children, and each leaf as soon as it is reached.
+ */
+void BPlusTree::destroyTree() {
+    if (levels == 1)
+        delete static_cast<Leaf*>(root);
+
+    if (levels > 1) {
+        Inner* stack[kMaxLevels];
+        int next[kMaxLevels];
+        int top = 0;
+
+        stack[top] = static_cast<Inner*>(root);
+        next[top] = 0;
+        top++;
+
+        while (top > 0) {
+            Inner* in = stack[top - 1];
+
+            if (next[top - 1] > in->count) {
+                delete in;
+                top--;
+                continue;
+            }
+
+            void* child = in->children[next[top - 1]++];
+
+            if (top == levels - 1) {
+                delete static_cast<Leaf*>(child);
+            }
+            else {
+                stack[top] = static_cast<Inner*>(child);
+                next[top] = 0;
+                top++;
+            }
+        }
+    }
+
+    root = nullptr;
+    levels = 0;
+    valueCount = 0;
+}
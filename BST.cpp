@@ -10,20 +10,94 @@
  * and queue data structures where appropriate. The BST owns all dynamically
  * allocated Node objects and is responsible for their lifetime management.
  *
+ * When the tree is constructed with BalancePolicy::AVL, insert and remove
+ * record their search path on an explicit stack and walk it back upward,
+ * updating node heights and applying single or double rotations wherever
+ * the AVL invariant is violated.
+ *
+ * Under BalancePolicy::Splay, insert and search record the same path and
+ * use it to splay the accessed node to the root with zig, zig-zig, and
+ * zig-zag rotations.
+ *
+ * Mutations reuse a stack owned by the tree, so they do not allocate once it
+ * has grown to the depth the tree requires. Const traversals use a local
+ * stack, whose inline buffer covers any balanced tree without allocating, or
+ * a local queue, so concurrent readers never share scratch space.
+ *
+ * Nodes are allocated from the tree's NodePool rather than individually
+ * with new, and are returned to the pool when removed.
+ *
  * This implementation is intentionally pointer-based and avoids the use of
  * STL containers or smart pointers to demonstrate fundamental memory
  * management concepts in C++.
  */
 
 #include "BST.h"
-#include "Stack.h"
-#include "Queue.h"
+#include "MappedFile.h"
+#include "OutputBuffer.h"
+#include "Prefetch.h"
+#include <algorithm>
 #include <iostream>
+#include <new>
+#include <thread>
+
+namespace {
+
+/**
+ * Whether insert and remove must refresh subtree sizes along their path.
+ */
+#if BST_ORDER_STATISTICS
+const bool kTrackSizes = true;
+#else
+const bool kTrackSizes = false;
+#endif
+
+/**
+ * Adds to a counter that const lookups may update concurrently. A relaxed
+ * load and store compile to a plain increment and keep concurrent readers
+ * free of data races; an increment may be lost when two threads race.
+ */
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * Adds delta to a node's subtree size; does nothing when sizes are not
+ * maintained.
+ */
+#if BST_ORDER_STATISTICS
+inline void adjustSize(Node* n, int delta) {
+    n->setSize(n->getSize() + static_cast<unsigned int>(delta));
+}
+#else
+inline void adjustSize(Node*, int) {}
+#endif
+
+} // namespace
+
+/**
+ * Adds to one of the operation counters; expands to nothing unless
+ * BST_ENABLE_STATS is set, so uninstrumented builds carry no trace of it.
+ */
+#if BST_ENABLE_STATS
+#define BST_COUNT(counter, amount) bump(counters.counter, (amount))
+#else
+#define BST_COUNT(counter, amount) ((void)0)
+#endif
 
 /**
- * @brief Initializes the BST root pointer to nullptr.
+ * @brief Initializes the BST root pointer to nullptr and records the
+ * balancing policy.
  */
-BST::BST() : root(nullptr) {}
+BST::BST(BalancePolicy p)
+    : root(nullptr), nodeCount(0), policy(p), splayInterval(1), splayCountdown(1) {}
+
+/**
+ * Delegates to buildFromRange() after initializing an empty tree.
+ */
+BST::BST(const int* first, const int* last, BalancePolicy p) : BST(p) {
+    buildFromRange(first, last);
+}
 
 /**
  * Calls destroyTree() to deallocate all nodes in the tree.
@@ -37,39 +111,115 @@ BST::~BST() {
  *
  * The tree is traversed from the root to locate the appropriate insertion
  * point. Duplicate values are detected and ignored to preserve BST invariants.
+ * The node is only allocated once the insertion point is known, so duplicates
+ * never touch the allocator. In AVL mode the visited nodes are recorded and
+ * repaired afterwards. In splay mode the recorded path is used to splay the
+ * new node (or the duplicate that was found) to the root; the splay
+ * rotations also refresh every size on the path. Without balancing the
+ * insert stays a single pass: when subtree sizes are maintained, each node
+ * is counted on the way down, and a duplicate walks the same path again to
+ * take the counts back.
  */
 void BST::insert(int value) {
-    Node* newNode = new Node(value);
+    BST_COUNT(inserts, 1);
+    filterCheckDrift();
 
     // Special case: empty tree
     if (!root) {
-        root = newNode;
+        root = pool.allocate(value);
+        nodeCount = 1;
+        filterAdd(value);
         return;
     }
 
+    const bool splaying = (policy == BalancePolicy::Splay);
+    const bool trackPath = (policy != BalancePolicy::None);
+    const bool countDown = !trackPath && kTrackSizes;
+    Stack& path = scratchStack;
+    path.clear();
     Node* current = root;
     Node* parent = nullptr;
 
     // Traverse the tree to find the insertion point
     while (current) {
+        BST_COUNT(nodesVisited, 1);
+        BST_COUNT(comparisons, 1);
         parent = current;
+        if (trackPath)
+            path.push(current);
+        else if (countDown)
+            adjustSize(current, 1);
 
         if (value < current->getValue())
             current = current->getLeft();
         else if (value > current->getValue())
             current = current->getRight();
         else {
-            // Duplicate value detected; discard new node
-            delete newNode;
+            // Duplicate value detected; nothing to insert
+            if (splaying) {
+                path.pop();
+                splayPath(path, current);
+            }
+            else if (countDown) {
+                for (Node* n = root; ; n = value < n->getValue() ? n->getLeft() : n->getRight()) {
+                    adjustSize(n, -1);
+                    if (n == current)
+                        break;
+                }
+            }
             return;
         }
     }
 
     // Attach the new node to its parent
+    Node* newNode = pool.allocate(value);
+    nodeCount++;
     if (value < parent->getValue())
         parent->setLeft(newNode);
     else
         parent->setRight(newNode);
+
+    filterAdd(value);
+    filterCheckGrowth();
+
+    if (splaying)
+        splayPath(path, newNode);
+    else if (trackPath)
+        rebalancePath(path);
+}
+
+/**
+ * Asks the membership filter first, then descends the tree. A miss that got
+ * past the filter is reported back to it as a false positive.
+ */
+bool BST::search(int value) const {
+    BST_COUNT(searches, 1);
+    if (filterRejects(value))
+        return false;
+
+    bool found = find(value);
+    if (!found)
+        filterMissed();
+    return found;
+}
+
+/**
+ * Same as search(), except that in splay mode a lookup that is due to
+ * splay takes a separate path that records the ancestors it passes.
+ */
+bool BST::access(int value) {
+    if (policy != BalancePolicy::Splay || --splayCountdown != 0)
+        return search(value);
+    splayCountdown = splayInterval;
+
+    BST_COUNT(searches, 1);
+    if (filterRejects(value))
+        return false;
+
+    bool found = splaySearch(value);
+    if (!found)
+        filterMissed();
+    return found;
 }
 
 /**
@@ -78,10 +228,12 @@ void BST::insert(int value) {
  * Traverses the tree according to BST ordering rules until the value
  * is found or a null pointer is reached.
  */
-bool BST::search(int value) const {
+bool BST::find(int value) const {
     Node* current = root;
 
     while (current) {
+        BST_COUNT(nodesVisited, 1);
+        BST_COUNT(comparisons, 1);
         if (value == current->getValue())
             return true;
         else if (value < current->getValue())
@@ -94,53 +246,146 @@ bool BST::search(int value) const {
 }
 
 /**
- * Traverses the tree in-order using an iterative approach.
- *
- * Uses an explicit stack to traverse the tree without recursion and
- * prints values in ascending order.
+ * Runs the interleaved batch lookup, recording a flag per value.
  */
-void BST::inorder() const {
-    if (!root) return;
+void BST::searchBatch(const int* values, std::size_t count, bool* results) const {
+    batchLookup(values, count, results);
+}
 
-    Stack s;
-    Node* current = root;
+/**
+ * Runs the interleaved batch lookup, only counting the values found.
+ */
+std::size_t BST::containsMany(const int* values, std::size_t count) const {
+    return batchLookup(values, count, nullptr);
+}
 
-    while (current || !s.isEmpty()) {
-        while (current) {
-            s.push(current);
-            current = current->getLeft();
+/**
+ * Advances up to kBatchWidth independent searches in lockstep.
+ *
+ * Each in-flight lookup occupies a slot holding its current node and the
+ * index of its value. A pass over the slots advances every lookup by one
+ * level and prefetches the child it moves to. A lookup that finishes (value
+ * found or null child reached) records its result and its slot is refilled
+ * with the next pending value, starting again at the root; once no values
+ * remain, finished slots are dropped by moving the last active slot into
+ * their place. Values the membership filter rejects are skipped while
+ * refilling, so slots only hold lookups that need the tree.
+ */
+std::size_t BST::batchLookup(const int* values, std::size_t count, bool* results) const {
+    const Node* cursor[kBatchWidth];
+    std::size_t index[kBatchWidth];
+    std::size_t next = 0;
+    std::size_t found = 0;
+    int active = 0;
+    BST_COUNT(searches, count);
+
+    // Advances next past values the filter answers on its own
+    auto skipRejected = [&]() {
+        while (next < count && filterRejects(values[next])) {
+            if (results) results[next] = false;
+            next++;
         }
+    };
 
-        current = s.pop();
-        std::cout << current->getValue() << " ";
-        current = current->getRight();
+    prefetchRead(root);
+    skipRejected();
+    while (active < kBatchWidth && next < count) {
+        cursor[active] = root;
+        index[active] = next++;
+        active++;
+        skipRejected();
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < active; s++) {
+            const Node* n = cursor[s];
+            int value = values[index[s]];
+            if (n) {
+                BST_COUNT(nodesVisited, 1);
+                BST_COUNT(comparisons, 1);
+            }
+
+            if (n && value != n->getValue()) {
+                // Step one level down and request the child's cache line
+                n = (value < n->getValue()) ? n->getLeft() : n->getRight();
+                prefetchRead(n);
+                cursor[s] = n;
+                continue;
+            }
+
+            // Lookup finished: n is the match, or nullptr for a miss
+            if (n) found++;
+            else filterMissed();
+            if (results) results[index[s]] = (n != nullptr);
+
+            skipRejected();
+            if (next < count) {
+                cursor[s] = root;
+                index[s] = next++;
+            }
+            else {
+                active--;
+                cursor[s] = cursor[active];
+                index[s] = index[active];
+                s--;
+            }
+        }
     }
 
-    std::cout << std::endl;
+    return found;
 }
 
 /**
- * Visits nodes level by level (breadth-first traversal).
+ * Prints values in ascending order.
  *
- * Uses a queue to visit nodes level by level starting from the root.
+ * std::cout is flushed first so that earlier stream output appears before
+ * the buffered dump, which is written straight to stdout.
+ */
+void BST::inorder() const {
+    if (!root) return;
+
+    std::cout.flush();
+    writeInorder(stdout);
+    std::fflush(stdout);
+}
+
+/**
+ * Prints values level by level, starting from the root.
  */
 void BST::levelOrder() const {
     if (!root) return;
 
-    Queue q;
-    q.enqueue(root);
+    std::cout.flush();
+    writeLevelOrder(stdout);
+    std::fflush(stdout);
+}
+
+/**
+ * Formats every value into an OutputBuffer during an in-order visit.
+ */
+void BST::writeInorder(std::FILE* out) const {
+    OutputBuffer buffer(out);
 
-    while (!q.isEmpty()) {
-        Node* current = q.dequeue();
-        std::cout << current->getValue() << " ";
+    forEachInorder([&buffer](int value) {
+        buffer.appendInt(value);
+        buffer.append(' ');
+    });
 
-        if (current->getLeft())
-            q.enqueue(current->getLeft());
-        if (current->getRight())
-            q.enqueue(current->getRight());
-    }
+    buffer.append('\n');
+}
+
+/**
+ * Formats every value into an OutputBuffer during a level-order visit.
+ */
+void BST::writeLevelOrder(std::FILE* out) const {
+    OutputBuffer buffer(out);
 
-    std::cout << std::endl;
+    forEachLevelOrder([&buffer](int value) {
+        buffer.appendInt(value);
+        buffer.append(' ');
+    });
+
+    buffer.append('\n');
 }
 
 /**
@@ -150,14 +395,27 @@ void BST::levelOrder() const {
  * 1. Node is a leaf
  * 2. Node has one child
  * 3. Node has two children (using inorder successor replacement)
+ *
+ * In AVL mode, or when subtree sizes are maintained, every ancestor of the
+ * physically removed node is recorded, and the path is rebalanced and its
+ * sizes refreshed once the node has been unlinked.
  */
 bool BST::remove(int value) {
+    BST_COUNT(removes, 1);
+    filterCheckDrift();
+    const bool trackPath = (policy == BalancePolicy::AVL) || kTrackSizes;
+    Stack& path = scratchStack;
+    path.clear();
     Node* parent = nullptr;
     Node* current = root;
 
     // Locate the node to delete
     while (current && current->getValue() != value) {
+        BST_COUNT(nodesVisited, 1);
+        BST_COUNT(comparisons, 1);
         parent = current;
+        if (trackPath)
+            path.push(current);
         if (value < current->getValue())
             current = current->getLeft();
         else
@@ -167,6 +425,10 @@ bool BST::remove(int value) {
     if (!current)
         return false; // Value not found
 
+    BST_COUNT(nodesVisited, 1);
+    BST_COUNT(comparisons, 1);
+    nodeCount--;
+
     // ------------------------------------------------------------
     // Case 1: Node has no children (leaf)
     // ------------------------------------------------------------
@@ -178,7 +440,7 @@ bool BST::remove(int value) {
         else
             parent->setRight(nullptr);
 
-        delete current;
+        pool.release(current);
     }
 
     // ------------------------------------------------------------
@@ -196,7 +458,7 @@ bool BST::remove(int value) {
         else
             parent->setRight(child);
 
-        delete current;
+        pool.release(current);
     }
 
     // ------------------------------------------------------------
@@ -207,8 +469,15 @@ bool BST::remove(int value) {
         Node* succParent = current;
         Node* successor = current->getRight();
 
+        if (trackPath)
+            path.push(current);
+
+        BST_COUNT(nodesVisited, 1);
         while (successor->getLeft()) {
+            BST_COUNT(nodesVisited, 1);
             succParent = successor;
+            if (trackPath)
+                path.push(successor);
             successor = successor->getLeft();
         }
 
@@ -223,35 +492,1520 @@ bool BST::remove(int value) {
         else
             succParent->setRight(child);
 
-        delete successor;
+        pool.release(successor);
     }
 
+    if (trackPath)
+        rebalancePath(path);
+
     return true;
 }
 
+BalancePolicy BST::getBalancePolicy() const {
+    return policy;
+}
+
 /**
- * Iteratively deletes all nodes in the tree.
- *
- * Uses an explicit stack to traverse and delete each node,
- * ensuring all dynamically allocated memory is released.
- * This method is called internally by the destructor.
+ * Restarts the countdown so the new interval applies from the next lookup.
  */
-void BST::destroyTree() {
-    if (!root) return;
+void BST::setSplayInterval(unsigned int interval) {
+    splayInterval = interval ? interval : 1;
+    splayCountdown = splayInterval;
+}
+
+/**
+ * Only AVL relies on stored heights, so only a switch to AVL has to
+ * restore them; the balanced relink does so for every node.
+ */
+void BST::setBalancePolicy(BalancePolicy p) {
+    if (p == BalancePolicy::AVL && policy != BalancePolicy::AVL)
+        relinkBalanced();
+    policy = p;
+}
+
+/**
+ * Builds the filter immediately; the build itself is not counted as a
+ * rebuild.
+ */
+bool BST::enableFilter(unsigned int bitsPerKey, double maxFalsePositiveRate) {
+    if (bitsPerKey == 0 || !(maxFalsePositiveRate > 0 && maxFalsePositiveRate <= 1))
+        return false;
+
+    filter.enabled = true;
+    filter.bitsPerKey = bitsPerKey;
+    filter.maxFalsePositiveRate = maxFalsePositiveRate;
+    filter.queries = 0;
+    filter.rejected = 0;
+    filter.falsePositives = 0;
+    rebuildFilter();
+    filter.rebuilds = 0;
+    return true;
+}
+
+void BST::disableFilter() {
+    filter.enabled = false;
+    filter.bloom.release();
+    filter.queries = 0;
+    filter.rejected = 0;
+    filter.falsePositives = 0;
+    filter.rebuilds = 0;
+}
+
+bool BST::hasFilter() const {
+    return filter.enabled;
+}
+
+#if BST_ORDER_STATISTICS
+/**
+ * Counts the values strictly below value.
+ */
+std::size_t BST::rank(int value) const {
+    return countBelow(value, false);
+}
+
+/**
+ * Descends from the root comparing k with the size of the left subtree:
+ * a smaller k lies to the left, an equal k is the current node, and a larger
+ * k lies to the right after skipping the left subtree and the node itself.
+ */
+bool BST::select(std::size_t k, int& value) const {
+    const Node* current = root;
+
+    while (current) {
+        std::size_t leftSize = sizeOf(current->getLeft());
+
+        if (k < leftSize) {
+            current = current->getLeft();
+        }
+        else if (k == leftSize) {
+            value = current->getValue();
+            return true;
+        }
+        else {
+            k -= leftSize + 1;
+            current = current->getRight();
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Difference of two O(height) rank computations.
+ */
+std::size_t BST::countRange(int low, int high) const {
+    if (low > high) return 0;
+    return countBelow(high, true) - countBelow(low, false);
+}
+
+/**
+ * Treats an empty subtree as having size 0.
+ */
+std::size_t BST::sizeOf(const Node* n) {
+    return n ? n->getSize() : 0;
+}
+
+/**
+ * Descends from the root; every time the search moves right, the current
+ * node and its entire left subtree are below the value and are counted.
+ */
+std::size_t BST::countBelow(int value, bool inclusive) const {
+    const Node* current = root;
+    std::size_t count = 0;
+
+    while (current) {
+        bool below = inclusive ? current->getValue() <= value
+                               : current->getValue() < value;
+        if (below) {
+            count += sizeOf(current->getLeft()) + 1;
+            current = current->getRight();
+        }
+        else {
+            current = current->getLeft();
+        }
+    }
+
+    return count;
+}
+#endif
+
+/**
+ * Reports the number of nodes currently in the tree.
+ */
+std::size_t BST::size() const {
+    return nodeCount;
+}
+
+/**
+ * Walks the tree level by level with the scratch queue, using a null entry
+ * to mark the end of each level, so every node's depth is known without
+ * storing it.
+ */
+BSTStats BST::stats() const {
+    BSTStats result;
+    result.size = nodeCount;
+    result.height = 0;
+    for (std::size_t d = 0; d < BSTStats::kDepthBuckets; d++)
+        result.depthHistogram[d] = 0;
+
+    std::uint64_t depthSum = 0;
+    if (root) {
+        Queue q;
+        q.enqueue(root);
+        q.enqueue(nullptr);
+        std::size_t depth = 0;
+
+        while (!q.isEmpty()) {
+            Node* current = q.dequeue();
+            if (!current) {
+                depth++;
+                if (!q.isEmpty())
+                    q.enqueue(nullptr);
+                continue;
+            }
+
+            std::size_t bucket = depth < BSTStats::kDepthBuckets ? depth : BSTStats::kDepthBuckets - 1;
+            result.depthHistogram[bucket]++;
+            depthSum += depth + 1;
+            if (current->getLeft()) q.enqueue(current->getLeft());
+            if (current->getRight()) q.enqueue(current->getRight());
+        }
+        result.height = depth;
+    }
+    result.averageSearchDepth = nodeCount ? static_cast<double>(depthSum) / static_cast<double>(nodeCount) : 0.0;
+
+    result.nodeBytes = nodeCount * sizeof(Node);
+    result.reservedBytes = pool.reservedNodes() * sizeof(Node);
+    result.slabCount = pool.slabCount();
+    result.freeNodes = pool.freeNodes();
+
+#if BST_ENABLE_STATS
+    result.countersEnabled = true;
+    result.searches = counters.searches;
+    result.inserts = counters.inserts;
+    result.removes = counters.removes;
+    result.comparisons = counters.comparisons;
+    result.nodesVisited = counters.nodesVisited;
+    result.rebalances = counters.rebalances;
+    result.allocations = pool.allocationCount();
+    result.frees = pool.releaseCount();
+#else
+    result.countersEnabled = false;
+    result.searches = result.inserts = result.removes = 0;
+    result.comparisons = result.nodesVisited = result.rebalances = 0;
+    result.allocations = result.frees = 0;
+#endif
+
+    result.filterEnabled = filter.enabled;
+    result.filterBytes = filter.bloom.memoryBytes();
+    result.filterQueries = filter.queries.load(std::memory_order_relaxed);
+    result.filterRejected = filter.rejected.load(std::memory_order_relaxed);
+    result.filterFalsePositives = filter.falsePositives.load(std::memory_order_relaxed);
+    result.filterRebuilds = filter.rebuilds;
+    std::uint64_t negatives = result.filterRejected + result.filterFalsePositives;
+    result.filterFalsePositiveRate = negatives
+        ? static_cast<double>(result.filterFalsePositives) / static_cast<double>(negatives) : 0.0;
+    return result;
+}
+
+void BST::resetCounters() {
+#if BST_ENABLE_STATS
+    counters.searches = 0;
+    counters.inserts = 0;
+    counters.removes = 0;
+    counters.comparisons = 0;
+    counters.nodesVisited = 0;
+    counters.rebalances = 0;
+    pool.resetCounts();
+#endif
+    filter.queries = 0;
+    filter.rejected = 0;
+    filter.falsePositives = 0;
+    filter.rebuilds = 0;
+}
+
+/**
+ * Walks the tree in-order with a local stack and stores each value at the
+ * next Eytzinger index in in-order sequence, so no intermediate sorted
+ * copy is needed.
+ */
+FrozenBST BST::freeze() const {
+    FrozenBST snapshot;
+    snapshot.allocate(nodeCount);
 
     Stack s;
-    s.push(root);
+    Node* current = root;
+    std::size_t k = snapshot.firstIndex();
+
+    while (current || !s.isEmpty()) {
+        while (current) {
+            s.push(current);
+            current = current->getLeft();
+        }
+
+        current = s.pop();
+        snapshot.keys[k] = current->getValue();
+        k = snapshot.nextIndex(k);
+        current = current->getRight();
+    }
 
-    while (!s.isEmpty()) {
-        Node* current = s.pop();
+    return snapshot;
+}
 
-        if (current->getLeft())
-            s.push(current->getLeft());
-        if (current->getRight())
-            s.push(current->getRight());
+/**
+ * Streams the in-order values through a KeyWriter, which fills in the
+ * header once the payload is complete.
+ */
+bool BST::save(const char* path, KeyEncoding encoding) const {
+    std::FILE* out = std::fopen(path, "wb");
+    if (!out) return false;
 
-        delete current;
+    bool ok;
+    {
+        KeyWriter writer(out, encoding);
+        forEachInorder([&writer](int value) { writer.append(value); });
+        ok = writer.finish();
     }
 
-    root = nullptr;
+    return (std::fclose(out) == 0) && ok;
+}
+
+/**
+ * Validates the header and checksum before touching the tree, then decodes
+ * each key directly into its slot in a freshly allocated node block. Keys
+ * arrive in ascending order, so the block is already in the order
+ * linkBalanced() expects. Once the old contents are gone a membership
+ * filter is rebuilt on every path, including an empty file and a payload
+ * that fails to decode, so it never describes keys the tree lost.
+ */
+bool BST::load(const char* path) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    KeyFileHeader header;
+    if (!header.read(file.data(), file.size())) return false;
+
+    const unsigned char* payload = file.data() + KeyFileHeader::kSize;
+    KeyChecksum checksum;
+    checksum.update(payload, header.payloadBytes);
+    if (checksum.value() != header.checksum) return false;
+
+    destroyTree();
+
+    bool decoded = true;
+    if (header.count != 0) {
+        std::size_t count = static_cast<std::size_t>(header.count);
+        Node* nodes = pool.allocateBlock(count);
+        decoded = decodeKeys(header, payload, [nodes](std::size_t i, int key) {
+            new (nodes + i) Node(key);
+        });
+
+        if (decoded) {
+            root = linkBalanced(nodes, count);
+            nodeCount = count;
+        }
+        else {
+            destroyTree();
+        }
+    }
+
+    if (filter.enabled)
+        rebuildFilter();
+    return decoded;
+}
+
+BST::const_iterator BST::begin() const {
+    const_iterator it(this);
+    it.seek(const_iterator::Seek::First, 0);
+    return it;
+}
+
+BST::const_iterator BST::end() const {
+    return const_iterator(this);
+}
+
+BST::const_iterator BST::lower_bound(int value) const {
+    const_iterator it(this);
+    it.seek(const_iterator::Seek::LowerBound, value);
+    return it;
+}
+
+BST::const_iterator BST::upper_bound(int value) const {
+    const_iterator it(this);
+    it.seek(const_iterator::Seek::UpperBound, value);
+    return it;
+}
+
+/**
+ * An empty or inverted interval yields two equal iterators.
+ */
+BST::Range BST::range(int low, int high) const {
+    if (high <= low)
+        return Range(end(), end());
+    return Range(lower_bound(low), lower_bound(high));
+}
+
+// ----------------------------------------------------------------------
+// BST::const_iterator
+// ----------------------------------------------------------------------
+
+BST::const_iterator::const_iterator()
+    : tree(nullptr), current(nullptr), depth(0), tracked(true) {}
+
+BST::const_iterator::const_iterator(const BST* t)
+    : tree(t), current(nullptr), depth(0), tracked(true) {}
+
+int BST::const_iterator::operator*() const {
+    return current->getValue();
+}
+
+/**
+ * With a tracked path, the successor is the leftmost node of the right
+ * subtree, or else the nearest ancestor reached through a left link.
+ * Without one, the successor is found by searching from the root.
+ */
+BST::const_iterator& BST::const_iterator::operator++() {
+    if (!current) return *this;
+
+    if (!tracked) {
+        seek(Seek::UpperBound, current->getValue());
+        return *this;
+    }
+
+    if (current->getRight()) {
+        pushAncestor(current);
+        current = current->getRight();
+        while (current->getLeft()) {
+            pushAncestor(current);
+            current = current->getLeft();
+        }
+        return *this;
+    }
+
+    const Node* child = current;
+    while (depth > 0 && path[depth - 1]->getRight() == child)
+        child = path[--depth];
+
+    current = depth > 0 ? path[--depth] : nullptr;
+    return *this;
+}
+
+BST::const_iterator BST::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+/**
+ * Mirror image of operator++(). Decrementing end() seeks the largest value.
+ */
+BST::const_iterator& BST::const_iterator::operator--() {
+    if (!current) {
+        seek(Seek::Last, 0);
+        return *this;
+    }
+
+    if (!tracked) {
+        seek(Seek::Before, current->getValue());
+        return *this;
+    }
+
+    if (current->getLeft()) {
+        pushAncestor(current);
+        current = current->getLeft();
+        while (current->getRight()) {
+            pushAncestor(current);
+            current = current->getRight();
+        }
+        return *this;
+    }
+
+    const Node* child = current;
+    while (depth > 0 && path[depth - 1]->getLeft() == child)
+        child = path[--depth];
+
+    current = depth > 0 ? path[--depth] : nullptr;
+    return *this;
+}
+
+BST::const_iterator BST::const_iterator::operator--(int) {
+    const_iterator previous = *this;
+    --*this;
+    return previous;
+}
+
+/**
+ * Descends from the root, recording every visited node. Each node that
+ * satisfies the target condition becomes the candidate, and the descent
+ * continues toward a closer candidate. When the descent ends, the ancestors
+ * of the last candidate are exactly the recorded nodes above it.
+ *
+ * - First / Last: the leftmost / rightmost node.
+ * - LowerBound: the smallest value >= value.
+ * - UpperBound: the smallest value > value.
+ * - Before: the largest value < value.
+ */
+void BST::const_iterator::seek(Seek mode, int value) {
+    const Node* n = tree->root;
+    const Node* candidate = nullptr;
+    int candidateDepth = 0;
+    int visited = 0;
+
+    depth = 0;
+    tracked = true;
+
+    while (n) {
+        bool match;
+        bool goLeft;
+
+        switch (mode) {
+        case Seek::First:
+            match = true;
+            goLeft = true;
+            break;
+        case Seek::Last:
+            match = true;
+            goLeft = false;
+            break;
+        case Seek::LowerBound:
+            match = n->getValue() >= value;
+            goLeft = match;
+            break;
+        case Seek::UpperBound:
+            match = n->getValue() > value;
+            goLeft = match;
+            break;
+        default: // Seek::Before
+            match = n->getValue() < value;
+            goLeft = !match;
+            break;
+        }
+
+        if (match) {
+            candidate = n;
+            candidateDepth = visited;
+        }
+
+        if (visited < kMaxDepth)
+            path[visited] = n;
+        visited++;
+
+        n = goLeft ? n->getLeft() : n->getRight();
+    }
+
+    current = candidate;
+    depth = candidateDepth;
+
+    if (depth > kMaxDepth) {
+        tracked = false;
+        depth = 0;
+    }
+}
+
+/**
+ * Records an ancestor; once the inline array is full the path can no
+ * longer be trusted and the iterator falls back to searching from the root.
+ */
+void BST::const_iterator::pushAncestor(const Node* n) {
+    if (!tracked) return;
+
+    if (depth == kMaxDepth) {
+        tracked = false;
+        depth = 0;
+        return;
+    }
+
+    path[depth++] = n;
+}
+
+/**
+ * Treats an empty subtree as having height 0.
+ */
+int BST::heightOf(const Node* n) {
+    return n ? n->getHeight() : 0;
+}
+
+/**
+ * Sets a node's height to one more than the taller of its children.
+ */
+void BST::updateHeight(Node* n) {
+    int hl = heightOf(n->getLeft());
+    int hr = heightOf(n->getRight());
+    n->setHeight(1 + (hl > hr ? hl : hr));
+}
+
+/**
+ * Sets a node's size to one more than the sizes of its two subtrees.
+ */
+void BST::updateSize(Node* n) {
+#if BST_ORDER_STATISTICS
+    n->setSize(static_cast<unsigned int>(1 + sizeOf(n->getLeft()) + sizeOf(n->getRight())));
+#else
+    (void)n;
+#endif
+}
+
+/**
+ * Promotes the right child of n, making n its left child.
+ */
+Node* BST::rotateLeft(Node* n) {
+    Node* pivot = n->getRight();
+    n->setRight(pivot->getLeft());
+    pivot->setLeft(n);
+    updateHeight(n);
+    updateHeight(pivot);
+    updateSize(n);
+    updateSize(pivot);
+    return pivot;
+}
+
+/**
+ * Promotes the left child of n, making n its right child.
+ */
+Node* BST::rotateRight(Node* n) {
+    Node* pivot = n->getLeft();
+    n->setLeft(pivot->getRight());
+    pivot->setRight(n);
+    updateHeight(n);
+    updateHeight(pivot);
+    updateSize(n);
+    updateSize(pivot);
+    return pivot;
+}
+
+/**
+ * Promotes the right child of n; only the two moved nodes' sizes change.
+ */
+Node* BST::splayRotateLeft(Node* n) {
+    Node* pivot = n->getRight();
+    n->setRight(pivot->getLeft());
+    pivot->setLeft(n);
+    updateSize(n);
+    updateSize(pivot);
+    return pivot;
+}
+
+/**
+ * Promotes the left child of n; only the two moved nodes' sizes change.
+ */
+Node* BST::splayRotateRight(Node* n) {
+    Node* pivot = n->getLeft();
+    n->setLeft(pivot->getRight());
+    pivot->setRight(n);
+    updateSize(n);
+    updateSize(pivot);
+    return pivot;
+}
+
+/**
+ * Updates the node's height and, if its balance factor has reached +/-2,
+ * applies the single (LL/RR) or double (LR/RL) rotation that restores it.
+ */
+Node* BST::rebalance(Node* n) {
+    updateHeight(n);
+    updateSize(n);
+    int balance = heightOf(n->getLeft()) - heightOf(n->getRight());
+
+    if (balance > 1) {
+        // Left-heavy; a right-leaning left child needs a double rotation
+        if (heightOf(n->getLeft()->getLeft()) < heightOf(n->getLeft()->getRight()))
+            n->setLeft(rotateLeft(n->getLeft()));
+        return rotateRight(n);
+    }
+
+    if (balance < -1) {
+        // Right-heavy; a left-leaning right child needs a double rotation
+        if (heightOf(n->getRight()->getRight()) < heightOf(n->getRight()->getLeft()))
+            n->setRight(rotateRight(n->getRight()));
+        return rotateLeft(n);
+    }
+
+    return n;
+}
+
+/**
+ * Pops nodes from deepest to shallowest, rebalancing each one and linking
+ * any rotated subtree back into its parent (or the root). Once a node keeps
+ * both its identity and its height, nothing above it can need rebalancing;
+ * the walk then either stops or, when subtree sizes are maintained,
+ * continues only to refresh the sizes of the remaining ancestors.
+ */
+void BST::rebalancePath(Stack& path) {
+    bool balancing = (policy == BalancePolicy::AVL);
+
+    while (!path.isEmpty()) {
+        Node* n = path.pop();
+
+        if (!balancing) {
+            if (!kTrackSizes)
+                break;
+            updateSize(n);
+            continue;
+        }
+
+        int oldHeight = n->getHeight();
+        Node* subtree = rebalance(n);
+
+        if (subtree != n) {
+            BST_COUNT(rebalances, 1);
+            Node* parent = path.peek();
+            if (!parent)
+                root = subtree;
+            else if (parent->getLeft() == n)
+                parent->setLeft(subtree);
+            else
+                parent->setRight(subtree);
+        }
+        else if (n->getHeight() == oldHeight) {
+            balancing = false;
+        }
+    }
+
+    // Discard any ancestors left over from an early exit
+    path.clear();
+}
+
+/**
+ * Lifts n two levels at a time. With its parent p and grandparent g:
+ * - zig-zig (n and p are children on the same side): rotate g, then p, so
+ *   the whole chain is reversed and the path roughly halves in depth;
+ * - zig-zag (opposite sides): rotate p, then g, lifting n above both;
+ * - zig (p is the root): a single rotation finishes the splay.
+ * After each step n is linked to the node that was above the rotated
+ * part. The rotations refresh the sizes of the nodes they move, and every
+ * ancestor of n is moved, so all sizes end up correct.
+ */
+void BST::splayPath(Stack& path, Node* n) {
+    while (!path.isEmpty()) {
+        BST_COUNT(rebalances, 1);
+        Node* p = path.pop();
+        Node* g = path.pop();
+        bool nLeft = (p->getLeft() == n);
+
+        if (!g) {
+            n = nLeft ? splayRotateRight(p) : splayRotateLeft(p);
+            root = n;
+            break;
+        }
+
+        bool pLeft = (g->getLeft() == p);
+        if (nLeft == pLeft) {
+            if (pLeft) {
+                splayRotateRight(g);
+                n = splayRotateRight(p);
+            }
+            else {
+                splayRotateLeft(g);
+                n = splayRotateLeft(p);
+            }
+        }
+        else if (pLeft) {
+            g->setLeft(splayRotateLeft(p));
+            n = splayRotateRight(g);
+        }
+        else {
+            g->setRight(splayRotateRight(p));
+            n = splayRotateLeft(g);
+        }
+
+        Node* above = path.peek();
+        if (!above)
+            root = n;
+        else if (above->getLeft() == g)
+            above->setLeft(n);
+        else
+            above->setRight(n);
+    }
+
+    path.clear();
+}
+
+/**
+ * Same descent as search(), recording each node passed so the node where
+ * the search ends can be splayed.
+ */
+bool BST::splaySearch(int value) {
+    if (!root) return false;
+
+    Stack& path = scratchStack;
+    path.clear();
+    Node* current = root;
+    bool found = false;
+
+    for (;;) {
+        BST_COUNT(nodesVisited, 1);
+        BST_COUNT(comparisons, 1);
+        Node* next;
+        if (value == current->getValue()) {
+            found = true;
+            break;
+        }
+        else if (value < current->getValue())
+            next = current->getLeft();
+        else
+            next = current->getRight();
+
+        if (!next)
+            break;
+        path.push(current);
+        current = next;
+    }
+
+    splayPath(path, current);
+    return found;
+}
+
+/**
+ * Validates the order of the range in one pass while counting distinct
+ * values. Ascending input is built directly; anything else is sorted into a
+ * temporary copy first.
+ */
+void BST::buildFromRange(const int* first, const int* last) {
+    destroyTree();
+
+    std::size_t count = static_cast<std::size_t>(last - first);
+    if (count == 0) return;
+
+    std::size_t unique = 1;
+    bool ascending = true;
+
+    for (std::size_t i = 1; i < count; i++) {
+        if (first[i] < first[i - 1]) {
+            ascending = false;
+            break;
+        }
+        if (first[i] != first[i - 1])
+            unique++;
+    }
+
+    if (ascending) {
+        buildFromSorted(first, count, unique);
+        return;
+    }
+
+    int* sorted = new int[count];
+    std::copy(first, last, sorted);
+    std::sort(sorted, sorted + count);
+    unique = static_cast<std::size_t>(std::unique(sorted, sorted + count) - sorted);
+    buildFromSorted(sorted, unique, unique);
+    delete[] sorted;
+}
+
+/**
+ * Constructs one node per distinct value in a single contiguous block, in
+ * ascending order, then links the block into a balanced tree.
+ */
+void BST::buildFromSorted(const int* sorted, std::size_t count, std::size_t unique) {
+    Node* nodes = pool.allocateBlock(unique);
+    std::size_t k = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (i == 0 || sorted[i] != sorted[i - 1])
+            new (nodes + k++) Node(sorted[i]);
+    }
+
+    root = linkBalanced(nodes, unique);
+    nodeCount = unique;
+}
+
+/**
+ * Iteratively links an ascending array of nodes into a perfectly balanced
+ * tree. Each pending subrange is recorded as a frame on a small fixed-size
+ * stack; the middle element of a subrange becomes its subtree root and the
+ * two halves are pushed as its children. Because a subrange of m nodes
+ * always yields a subtree of height floor(log2(m)) + 1, heights (and
+ * subtree sizes) are assigned directly without a second pass, and the frame stack never holds more than
+ * about two entries per level.
+ */
+template <class NodeAt>
+Node* BST::linkBalancedBy(NodeAt nodeAt, std::size_t count) {
+    struct Frame {
+        std::size_t lo;
+        std::size_t hi;     // exclusive
+        Node* parent;
+        bool isLeft;
+    };
+
+    if (count == 0) return nullptr;
+
+    Frame frames[2 * 64 + 2];
+    int top = 0;
+    Node* result = nullptr;
+
+    frames[top++] = Frame{ 0, count, nullptr, false };
+
+    while (top > 0) {
+        Frame f = frames[--top];
+        std::size_t size = f.hi - f.lo;
+        std::size_t mid = f.lo + size / 2;
+        Node* n = nodeAt(mid);
+
+        int height = 0;
+        for (std::size_t m = size; m; m >>= 1)
+            height++;
+        n->setHeight(height);
+#if BST_ORDER_STATISTICS
+        n->setSize(static_cast<unsigned int>(size));
+#endif
+        n->setLeft(nullptr);
+        n->setRight(nullptr);
+
+        if (!f.parent)
+            result = n;
+        else if (f.isLeft)
+            f.parent->setLeft(n);
+        else
+            f.parent->setRight(n);
+
+        if (mid + 1 < f.hi)
+            frames[top++] = Frame{ mid + 1, f.hi, n, false };
+        if (f.lo < mid)
+            frames[top++] = Frame{ f.lo, mid, n, true };
+    }
+
+    return result;
+}
+
+/**
+ * Links a contiguous block of freshly constructed nodes.
+ */
+Node* BST::linkBalanced(Node* nodes, std::size_t count) {
+    return linkBalancedBy([nodes](std::size_t i) { return nodes + i; }, count);
+}
+
+/**
+ * Deletes all nodes in the tree.
+ *
+ * Every node lives in the tree's NodePool, so releasing the pool's slabs
+ * reclaims all dynamically allocated memory without visiting individual
+ * nodes. This method is called internally by the destructor.
+ */
+void BST::destroyTree() {
+    pool.releaseAll();
+    root = nullptr;
+    nodeCount = 0;
+}
+
+// ----------------------------------------------------------------------
+// Split, join, and set operations
+// ----------------------------------------------------------------------
+
+namespace {
+
+/**
+ * Subtrees lower than this are merged on the current thread; forking a
+ * thread costs more than merging a few hundred nodes.
+ */
+const int kForkHeight = 14;
+
+/**
+ * Levels of recursion allowed to fork: enough for about twice as many
+ * branches as there are hardware threads.
+ */
+int forkDepthLimit() {
+    unsigned int threads = std::thread::hardware_concurrency();
+    int depth = 1;
+    while (threads > 1) {
+        threads >>= 1;
+        depth++;
+    }
+    return depth;
+}
+
+} // namespace
+
+/**
+ * The pivot is located with splitNodes(); the values moved to greater are
+ * counted from the subtree sizes when they are maintained. Sharing the
+ * slabs would let a handful of values on one side pin the whole of the
+ * other side's storage, so a side smaller than one slab is copied out
+ * instead and the other side keeps the original storage outright. This
+ * tree's filter only loses values, so it is left alone; greater's is
+ * rebuilt.
+ */
+bool BST::split(int key, BST& greater) {
+    if (&greater == this) return false;
+
+    greater.destroyTree();
+    prepareForJoin();
+
+    Node* less;
+    Node* more;
+    Node* found = splitNodes(root, key, less, more);
+
+    if (found)
+        pool.release(found);
+
+#if BST_ORDER_STATISTICS
+    std::size_t moved = sizeOf(more);
+#else
+    std::size_t moved = 0;
+    greater.root = more;
+    greater.forEachInorder([&moved](int) { moved++; });
+#endif
+    std::size_t kept = nodeCount - moved - (found ? 1 : 0);
+
+    if (moved < pool.nodesPerSlab()) {
+        more = compactSubtree(more, moved, pool, greater.pool);
+    }
+    else if (kept < pool.nodesPerSlab()) {
+        greater.pool.adopt(pool);
+        less = compactSubtree(less, kept, greater.pool, pool);
+    }
+    else {
+        pool.share(greater.pool);
+    }
+
+    root = less;
+    nodeCount = kept;
+    greater.root = more;
+    greater.nodeCount = moved;
+    if (greater.filter.enabled)
+        greater.rebuildFilter();
+    return found != nullptr;
+}
+
+/**
+ * Verifies the ordering against this tree's maximum and greater's minimum
+ * before taking over greater's nodes.
+ */
+bool BST::join(int key, BST& greater) {
+    if (&greater == this) return false;
+
+    const Node* n = root;
+    while (n && n->getRight())
+        n = n->getRight();
+    if (n && n->getValue() >= key)
+        return false;
+
+    n = greater.root;
+    while (n && n->getLeft())
+        n = n->getLeft();
+    if (n && n->getValue() <= key)
+        return false;
+
+    prepareForJoin();
+    std::size_t moved;
+    Node* right = adoptTree(greater, moved);
+    filterAdd(key);
+    filterAddTree(right);
+
+    root = joinNodes(root, pool.allocate(key), right);
+    nodeCount += moved + 1;
+    filterCheckGrowth();
+    return true;
+}
+
+void BST::unionWith(const BST& other) {
+    prepareForJoin();
+    std::size_t count = other.nodeCount;
+    setOperation(SetOp::Union, cloneFrom(other), count);
+}
+
+void BST::unionWith(BST&& other) {
+    if (&other == this) return;
+
+    prepareForJoin();
+    std::size_t count;
+    Node* tree = adoptTree(other, count);
+    setOperation(SetOp::Union, tree, count);
+}
+
+void BST::intersectWith(const BST& other) {
+    prepareForJoin();
+    std::size_t count = other.nodeCount;
+    setOperation(SetOp::Intersection, cloneFrom(other), count);
+}
+
+void BST::intersectWith(BST&& other) {
+    if (&other == this) return;
+
+    prepareForJoin();
+    std::size_t count;
+    Node* tree = adoptTree(other, count);
+    setOperation(SetOp::Intersection, tree, count);
+}
+
+void BST::differenceWith(const BST& other) {
+    prepareForJoin();
+    std::size_t count = other.nodeCount;
+    setOperation(SetOp::Difference, cloneFrom(other), count);
+}
+
+void BST::differenceWith(BST&& other) {
+    if (&other == this) {
+        destroyTree();
+        return;
+    }
+
+    prepareForJoin();
+    std::size_t count;
+    Node* tree = adoptTree(other, count);
+    setOperation(SetOp::Difference, tree, count);
+}
+
+/**
+ * Collects the nodes in order with the scratch stack, then relinks them
+ * with the same balanced layout a bulk build produces.
+ */
+void BST::relinkBalanced() {
+    if (nodeCount < 2) {
+        if (root) {
+            root->setHeight(1);
+            updateSize(root);
+        }
+        return;
+    }
+
+    Node** nodes = new Node*[nodeCount];
+    std::size_t k = 0;
+
+    Stack& s = scratchStack;
+    s.clear();
+    Node* current = root;
+
+    while (current || !s.isEmpty()) {
+        while (current) {
+            s.push(current);
+            current = current->getLeft();
+        }
+
+        current = s.pop();
+        nodes[k++] = current;
+        current = current->getRight();
+    }
+
+    root = linkBalancedBy([nodes](std::size_t i) { return nodes[i]; }, nodeCount);
+    delete[] nodes;
+}
+
+/**
+ * AVL trees already carry accurate heights.
+ */
+void BST::prepareForJoin() {
+    if (policy != BalancePolicy::AVL)
+        relinkBalanced();
+}
+
+/**
+ * Constructs the copies in one contiguous block in ascending order, as a
+ * bulk build does, and links them into a balanced tree.
+ */
+Node* BST::cloneFrom(const BST& other) {
+    if (other.nodeCount == 0) return nullptr;
+
+    Node* nodes = pool.allocateBlock(other.nodeCount);
+    std::size_t k = 0;
+    other.forEachInorder([nodes, &k](int value) { new (nodes + k++) Node(value); });
+
+    return linkBalanced(nodes, other.nodeCount);
+}
+
+/**
+ * Walks the subtree in order, constructing each copy in the next slot of
+ * one block from the destination pool. An original is visited after its
+ * left subtree and before its right child is followed, so its left link is
+ * free to thread it onto a chain that goes back to the source pool in one
+ * step.
+ */
+Node* BST::compactSubtree(Node* tree, std::size_t count, NodePool& from, NodePool& to) {
+    if (count == 0) return nullptr;
+
+    Node* nodes = to.allocateBlock(count);
+    std::size_t k = 0;
+    Node* first = nullptr;
+    Node* last = nullptr;
+    Stack s;
+    Node* current = tree;
+
+    while (current || !s.isEmpty()) {
+        while (current) {
+            s.push(current);
+            current = current->getLeft();
+        }
+        Node* n = s.pop();
+        current = n->getRight();
+
+        new (nodes + k++) Node(n->getValue());
+        n->setLeft(first);
+        first = n;
+        if (!last)
+            last = n;
+    }
+
+    from.releaseChain(first, last, count);
+    return linkBalanced(nodes, count);
+}
+
+/**
+ * Runs the recursive operation, returns every discarded node to the pool
+ * in one step, and derives the new size from the nodes discarded: none are
+ * created, so the two trees' nodes are either kept or dropped. Only a
+ * union can bring in new values, so only a union updates the filter.
+ */
+void BST::setOperation(SetOp op, Node* other, std::size_t otherCount) {
+    if (op == SetOp::Union)
+        filterAddTree(other);
+
+    DropList dropped;
+    root = setOperationNodes(op, root, other, dropped, forkDepthLimit());
+    pool.releaseChain(dropped.first, dropped.last, dropped.count);
+    nodeCount = nodeCount + otherCount - dropped.count;
+    filterCheckGrowth();
+}
+
+/**
+ * Balances other if its policy leaves heights stale, then moves its nodes
+ * (and the storage they live in) into this tree's pool.
+ */
+Node* BST::adoptTree(BST& other, std::size_t& count) {
+    other.prepareForJoin();
+
+    Node* tree = other.root;
+    count = other.nodeCount;
+
+    pool.adopt(other.pool);
+    other.root = nullptr;
+    other.nodeCount = 0;
+    return tree;
+}
+
+/**
+ * When the heights are within one, mid simply becomes the root. Otherwise,
+ * descend the inner spine of the taller tree (the right spine of left, or
+ * the left spine of right) to the first subtree no more than one level
+ * taller than the shorter tree, hang mid there with the shorter tree, and
+ * rebalance each spine node back up. Each step up needs at most one single
+ * or double rotation, as after an AVL insertion.
+ */
+Node* BST::joinNodes(Node* left, Node* mid, Node* right) {
+    int hl = heightOf(left);
+    int hr = heightOf(right);
+    Node* path[kMaxJoinPath];
+    int depth = 0;
+
+    if (hl > hr + 1) {
+        Node* c = left;
+        while (heightOf(c) > hr + 1) {
+            path[depth++] = c;
+            c = c->getRight();
+        }
+
+        mid->setLeft(c);
+        mid->setRight(right);
+        updateHeight(mid);
+        updateSize(mid);
+
+        Node* subtree = mid;
+        while (depth > 0) {
+            Node* p = path[--depth];
+            p->setRight(subtree);
+            subtree = rebalance(p);
+        }
+        return subtree;
+    }
+
+    if (hr > hl + 1) {
+        Node* c = right;
+        while (heightOf(c) > hl + 1) {
+            path[depth++] = c;
+            c = c->getLeft();
+        }
+
+        mid->setLeft(left);
+        mid->setRight(c);
+        updateHeight(mid);
+        updateSize(mid);
+
+        Node* subtree = mid;
+        while (depth > 0) {
+            Node* p = path[--depth];
+            p->setLeft(subtree);
+            subtree = rebalance(p);
+        }
+        return subtree;
+    }
+
+    mid->setLeft(left);
+    mid->setRight(right);
+    updateHeight(mid);
+    updateSize(mid);
+    return mid;
+}
+
+/**
+ * Removes the rightmost node of left, rebalancing the right spine on the
+ * way back up, and joins around it.
+ */
+Node* BST::joinPair(Node* left, Node* right) {
+    if (!left) return right;
+    if (!right) return left;
+
+    Node* path[kMaxJoinPath];
+    int depth = 0;
+    Node* last = left;
+    while (last->getRight()) {
+        path[depth++] = last;
+        last = last->getRight();
+    }
+
+    Node* subtree = last->getLeft();
+    while (depth > 0) {
+        Node* p = path[--depth];
+        p->setRight(subtree);
+        subtree = rebalance(p);
+    }
+
+    return joinNodes(subtree, last, right);
+}
+
+/**
+ * Records the search path for key, then walks it back up. Each node on the
+ * path goes, with its subtree on the far side of the path, to the half it
+ * belongs to, joined onto what that half has collected so far from below.
+ * The joins on each side have telescoping height differences, so the total
+ * cost is O(log n).
+ */
+Node* BST::splitNodes(Node* t, int key, Node*& less, Node*& greater) {
+    Node* path[kMaxJoinPath];
+    int depth = 0;
+    Node* found = nullptr;
+
+    while (t) {
+        if (key == t->getValue()) {
+            found = t;
+            break;
+        }
+        path[depth++] = t;
+        t = key < t->getValue() ? t->getLeft() : t->getRight();
+    }
+
+    Node* l = found ? found->getLeft() : nullptr;
+    Node* r = found ? found->getRight() : nullptr;
+
+    while (depth > 0) {
+        Node* p = path[--depth];
+        if (key < p->getValue())
+            r = joinNodes(r, p, p->getRight());
+        else
+            l = joinNodes(p->getLeft(), p, l);
+    }
+
+    if (found) {
+        found->setLeft(nullptr);
+        found->setRight(nullptr);
+    }
+
+    less = l;
+    greater = r;
+    return found;
+}
+
+/**
+ * Splits a around b's root key, recurses on the matching halves, and
+ * reassembles:
+ * - union keeps b's root as the middle node and drops a's copy of the key;
+ * - intersection keeps the key only if a held it too;
+ * - difference drops the key from both sides.
+ * When both trees are large and fork levels remain, the right halves are
+ * processed on a new thread while this thread handles the left halves.
+ */
+Node* BST::setOperationNodes(SetOp op, Node* a, Node* b, DropList& dropped, int forkDepth) {
+    if (!a || !b) {
+        switch (op) {
+        case SetOp::Union:
+            return a ? a : b;
+        case SetOp::Intersection:
+            dropped.addTree(a);
+            dropped.addTree(b);
+            return nullptr;
+        case SetOp::Difference:
+            dropped.addTree(b);
+            return a;
+        }
+    }
+
+    Node* bl = b->getLeft();
+    Node* br = b->getRight();
+    Node* al;
+    Node* ar;
+    Node* duplicate = splitNodes(a, b->getValue(), al, ar);
+
+    Node* l;
+    Node* r;
+    if (forkDepth > 0 && heightOf(a) >= kForkHeight && heightOf(b) >= kForkHeight) {
+        DropList rightDropped;
+        std::thread worker([&] { r = setOperationNodes(op, ar, br, rightDropped, forkDepth - 1); });
+        l = setOperationNodes(op, al, bl, dropped, forkDepth - 1);
+        worker.join();
+        dropped.append(rightDropped);
+    }
+    else {
+        l = setOperationNodes(op, al, bl, dropped, 0);
+        r = setOperationNodes(op, ar, br, dropped, 0);
+    }
+
+    switch (op) {
+    case SetOp::Union:
+        if (duplicate)
+            dropped.add(duplicate);
+        return joinNodes(l, b, r);
+    case SetOp::Intersection:
+        if (duplicate) {
+            dropped.add(duplicate);
+            return joinNodes(l, b, r);
+        }
+        dropped.add(b);
+        return joinPair(l, r);
+    case SetOp::Difference:
+    default:
+        if (duplicate)
+            dropped.add(duplicate);
+        dropped.add(b);
+        return joinPair(l, r);
+    }
+}
+
+void BST::DropList::add(Node* n) {
+    n->setLeft(first);
+    if (!first)
+        last = n;
+    first = n;
+    count++;
+}
+
+/**
+ * Rotates left children up until the current node has none, then moves it
+ * to the list; this flattens the subtree in O(size) time and O(1) space.
+ */
+void BST::DropList::addTree(Node* subtree) {
+    while (subtree) {
+        Node* left = subtree->getLeft();
+        if (left) {
+            subtree->setLeft(left->getRight());
+            left->setRight(subtree);
+            subtree = left;
+        }
+        else {
+            Node* next = subtree->getRight();
+            add(subtree);
+            subtree = next;
+        }
+    }
+}
+
+void BST::DropList::append(DropList& other) {
+    if (!other.first) return;
+
+    other.last->setLeft(first);
+    if (!first)
+        last = other.last;
+    first = other.first;
+    count += other.count;
+    other.first = other.last = nullptr;
+    other.count = 0;
+}
+
+// ----------------------------------------------------------------------
+// Membership filter
+// ----------------------------------------------------------------------
+
+namespace {
+
+/** Smallest number of values a filter is sized for. */
+const std::size_t kMinFilterKeys = 64;
+
+} // namespace
+
+bool BST::filterRejects(int value) const {
+    if (!filter.enabled) return false;
+
+    bump(filter.queries);
+    if (filter.bloom.mayContain(value))
+        return false;
+
+    bump(filter.rejected);
+    bump(filter.windowNegatives);
+    return true;
+}
+
+void BST::filterMissed() const {
+    if (!filter.enabled) return;
+
+    bump(filter.falsePositives);
+    bump(filter.windowNegatives);
+    bump(filter.windowFalsePositives);
+}
+
+/**
+ * Removed values leave their bits set, so the false-positive rate creeps
+ * up as the tree churns. A window is at least as long as the tree is
+ * large, which pays for the O(n) rebuild it may end with. The rate is
+ * measured rather than predicted, so lookups that keep asking for values
+ * removed long ago trigger a rebuild as readily as accumulated removals.
+ */
+bool BST::filterCheckDrift() {
+    if (!filter.enabled) return false;
+
+    std::uint64_t negatives = filter.windowNegatives.load(std::memory_order_relaxed);
+    std::uint64_t window = nodeCount > kFilterWindow ? nodeCount : kFilterWindow;
+    if (negatives < window)
+        return false;
+
+    std::uint64_t falsePositives = filter.windowFalsePositives.load(std::memory_order_relaxed);
+    if (static_cast<double>(falsePositives) > filter.maxFalsePositiveRate * static_cast<double>(negatives)) {
+        rebuildFilter();
+        return true;
+    }
+    filter.windowNegatives.store(0, std::memory_order_relaxed);
+    filter.windowFalsePositives.store(0, std::memory_order_relaxed);
+    return false;
+}
+
+bool BST::maintainFilter() {
+    return filterCheckDrift();
+}
+
+void BST::filterAdd(int value) {
+    if (filter.enabled)
+        filter.bloom.add(value);
+}
+
+/**
+ * Preorder walk; the order values are added in does not matter.
+ */
+void BST::filterAddTree(const Node* tree) {
+    if (!filter.enabled || !tree) return;
+
+    Stack& s = scratchStack;
+    s.clear();
+    s.push(const_cast<Node*>(tree));
+    while (Node* n = s.pop()) {
+        filter.bloom.add(n->getValue());
+        if (n->getRight()) s.push(n->getRight());
+        if (n->getLeft()) s.push(n->getLeft());
+    }
+}
+
+/**
+ * Doubling the size between rebuilds keeps their cost O(1) amortized per
+ * inserted value.
+ */
+void BST::filterCheckGrowth() {
+    if (filter.enabled && nodeCount > 2 * filter.sizedFor)
+        rebuildFilter();
+}
+
+/**
+ * Only ever called from operations that may modify the tree, never from a
+ * lookup, so const lookups keep a bounded cost.
+ */
+void BST::rebuildFilter() {
+    filter.sizedFor = nodeCount > kMinFilterKeys ? nodeCount : kMinFilterKeys;
+    filter.bloom.reset(filter.sizedFor, filter.bitsPerKey);
+    filterAddTree(root);
+
+    filter.rebuilds++;
+    filter.windowNegatives.store(0, std::memory_order_relaxed);
+    filter.windowFalsePositives.store(0, std::memory_order_relaxed);
 }
@@ -18,7 +18,118 @@
 #ifndef BST_H
 #define BST_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <type_traits>
 #include "Node.h"
+#include "NodePool.h"
+#include "BloomFilter.h"
+#include "FrozenBST.h"
+#include "KeyFormat.h"
+#include "Stack.h"
+#include "Queue.h"
+
+/**
+ * @enum BalancePolicy
+ * @brief Selects how the BST restructures itself after modifications.
+ *
+ * @details
+ * - None: Classic unbalanced BST. Nodes are attached exactly where the
+ *   search ends, so sorted input degrades the tree into a linked list.
+ * - AVL: Height-balanced AVL tree. Insert and remove walk back up the
+ *   search path, updating node heights and applying rotations so that the
+ *   height of the tree stays O(log n) for any input order.
+ * - Splay: Self-adjusting splay tree. access() and insert() rotate the
+ *   node they reach to the root, so recently and frequently accessed
+ *   values stay near the top. Any sequence of operations costs O(log n)
+ *   amortized each, but a single one may take O(n). Shallower hot paths
+ *   do not by themselves make lookups faster, because every splay
+ *   rewrites the nodes it passes: in bench/SplayBenchmark.cpp (10^6 keys,
+ *   Zipf theta 0.99) splaying on every lookup is about twice as slow as
+ *   AVL, and splaying one lookup in 16 is still 10-30% slower. Splaying
+ *   only came out ahead with stronger skew (theta 1.2, sampled) or when a
+ *   warmed-up splay tree was frozen by switching it to None.
+ */
+enum class BalancePolicy {
+    None,
+    AVL,
+    Splay
+};
+
+/**
+ * @struct BSTStats
+ * @brief A snapshot of a tree's shape, memory use, and operation counters.
+ *
+ * @details
+ * The shape and memory fields are computed by BST::stats() with one
+ * breadth-first walk of the tree. The operation counters accumulate from
+ * construction (or the last BST::resetCounters()) and are only maintained
+ * when BST_ENABLE_STATS is 1; otherwise countersEnabled is false and they
+ * read zero.
+ */
+struct BSTStats {
+    /** Depths at or beyond the last bucket are counted in the last bucket. */
+    static const std::size_t kDepthBuckets = 64;
+
+    /** Number of values stored. */
+    std::size_t size;
+    /** Number of nodes on the longest root-to-leaf path (0 when empty). */
+    std::size_t height;
+    /** Mean number of nodes a successful search visits (root depth counts as 1). */
+    double averageSearchDepth;
+    /** depthHistogram[d] is the number of nodes at depth d (the root is at depth 0). */
+    std::size_t depthHistogram[kDepthBuckets];
+
+    /** Bytes occupied by the live nodes. */
+    std::size_t nodeBytes;
+    /** Bytes of node storage reserved in the pool's slabs, live or not. */
+    std::size_t reservedBytes;
+    /** Number of slabs backing the pool. */
+    std::size_t slabCount;
+    /** Released nodes waiting for reuse. */
+    std::size_t freeNodes;
+
+    /** Whether the counters below are maintained (BST_ENABLE_STATS). */
+    bool countersEnabled;
+    std::uint64_t searches;
+    std::uint64_t inserts;
+    std::uint64_t removes;
+    /**
+     * Three-way key comparisons made by search(), insert(), remove(), and
+     * the batched lookups: one per node on each search path.
+     */
+    std::uint64_t comparisons;
+    /** Nodes examined by the same operations, including remove()'s successor walk. */
+    std::uint64_t nodesVisited;
+    /** Single or double rotations made by insert() and remove(). */
+    std::uint64_t rebalances;
+    /** Nodes handed out by the pool. */
+    std::uint64_t allocations;
+    /** Nodes returned to the pool individually or in chains. */
+    std::uint64_t frees;
+
+    /**
+     * Whether a membership filter is enabled (BST::enableFilter()). The
+     * filter fields below are maintained whenever it is, independently of
+     * BST_ENABLE_STATS, and read zero otherwise.
+     */
+    bool filterEnabled;
+    /** Bytes held by the filter's bit array. */
+    std::size_t filterBytes;
+    /** Lookups that consulted the filter. */
+    std::uint64_t filterQueries;
+    /** Lookups the filter answered alone, without touching the tree. */
+    std::uint64_t filterRejected;
+    /** Lookups the filter let through for values the tree did not hold. */
+    std::uint64_t filterFalsePositives;
+    /** Rebuilds after growth or false-positive drift, excluding the first build. */
+    std::uint64_t filterRebuilds;
+    /** filterFalsePositives as a fraction of all lookups for absent values. */
+    double filterFalsePositiveRate;
+};
 
 /**
  * @class BST
@@ -39,26 +150,229 @@
  * - Right subtree contains values greater than the node.
  * - Duplicate values are ignored.
  *
+ * Balancing:
+ * The balancing behavior is selected at construction time through a
+ * BalancePolicy. With BalancePolicy::AVL the tree keeps the AVL invariant
+ * (subtree heights differ by at most one at every node), so search, insert,
+ * and remove run in O(log n) even for sorted or adversarial input. With
+ * BalancePolicy::Splay, access() and insert() restructure the tree so that
+ * hot values migrate toward the root; search(), remove(), and the batched,
+ * ranged, and positional lookups do not adjust it. setBalancePolicy() changes the
+ * policy later, for example to BalancePolicy::None to stop a splay tree
+ * from adjusting once it is only read. The public interface is identical
+ * in every mode.
+ *
+ * Order Statistics:
+ * When BST_ORDER_STATISTICS is enabled (it is off by default), every node
+ * records the size of its subtree. insert, remove, rotations, and bulk
+ * builds keep the sizes current, and rank(), select(), and countRange() use them to
+ * answer positional queries in O(height) instead of walking the whole tree.
+ *
+ * Split, Join, and Set Operations:
+ * split() and join() cut a tree around a key and concatenate two trees in
+ * O(log n) by relinking nodes rather than copying values. unionWith(),
+ * intersectWith(), and differenceWith() are built on them: each splits this
+ * tree around the root of the other, recurses on the two sides, and joins
+ * the results, for O(m log(n / m + 1)) work when merging m values into n.
+ * The two recursive calls touch disjoint subtrees, so near the top of the
+ * recursion they run on separate threads. Results are always AVL-balanced.
+ * These operations rely on accurate node heights, which only
+ * BalancePolicy::AVL maintains; a tree under any other policy is first
+ * relinked into a perfectly balanced shape in O(n).
+ *
+ * Membership Filter:
+ * enableFilter() puts a blocked Bloom filter (see BloomFilter) in front of
+ * search() and the batched lookups. A lookup for a value the filter has
+ * never seen is answered after touching one cache line of filter bits
+ * instead of a full root-to-leaf descent, which pays off when many lookups
+ * are for absent values. insert() and the bulk operations add their values
+ * to the filter. remove() leaves the removed value's bits set, because
+ * other values may share them; instead, lookups measure the filter's
+ * false-positive rate over windows of lookups for absent values. Lookups
+ * only record the measurement. The filter is rebuilt from the tree's
+ * values by the next insert(), remove(), or maintainFilter() call after a
+ * window whose rate exceeded the configured maximum. It is also rebuilt,
+ * at twice the size, whenever the tree outgrows it by a factor of two.
+ *
+ * Instrumentation:
+ * stats() reports the tree's height, depth histogram, average search depth,
+ * and memory footprint at any time. Building with BST_ENABLE_STATS set to 1
+ * additionally counts comparisons, visited nodes, rebalances, and node
+ * allocations and frees in insert, search, remove, and the batched lookups;
+ * with the default of 0 that bookkeeping is not compiled at all.
+ *
  * Memory Management:
- * The BST owns all its nodes. The destructor invokes a private destroyTree()
- * helper method, ensuring that all nodes are properly freed and preventing
- * memory leaks.
+ * The BST owns all its nodes. Nodes are obtained from a NodePool owned by the
+ * tree, so insertions draw from slab storage instead of calling new for each
+ * node, and removed nodes are recycled for later insertions. The destructor
+ * invokes a private destroyTree() helper method, which releases the pool's
+ * slabs, ensuring that all nodes are properly freed and preventing memory
+ * leaks.
  * 
+ * Insertion, removal, and rebalancing reuse a Stack owned by the tree, so
+ * once it has grown to the tree's height updates perform no allocation.
+ * Const operations never write the tree or any scratch space it owns: they
+ * walk with a function-local Stack, whose inline buffer holds the path of
+ * any balanced tree without allocating, or a function-local Queue, and the
+ * operation counters are relaxed atomics. Any number of threads may
+ * therefore call const members concurrently, provided none of them
+ * modifies the tree at the same time.
+ *
  * @see Node
+ * @see NodePool
  */
 
 class BST {
 public:
+    /**
+     * @class const_iterator
+     * @brief Allocation-free bidirectional iterator over the tree's values.
+     *
+     * @details
+     * The iterator keeps the chain of ancestors of its current node in a
+     * fixed-size inline array, so moving to the next or previous value only
+     * follows child links and pops ancestors, in amortized O(1) time, and
+     * never touches the heap.
+     *
+     * The inline array holds kMaxDepth ancestors, which covers any balanced
+     * tree that fits in memory. If an unbalanced tree is deeper than that,
+     * the iterator stops tracking ancestors and instead finds the next or
+     * previous value by searching again from the root, which costs O(height)
+     * per step but remains correct.
+     *
+     * Any insert or remove invalidates all iterators into the tree, and so
+     * does access() under BalancePolicy::Splay.
+     */
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef int reference;
+
+        /**
+         * @brief Number of ancestors tracked inline.
+         */
+        static const int kMaxDepth = 64;
+
+        /**
+         * @brief Constructs a singular iterator that compares equal to end().
+         */
+        const_iterator();
+
+        /**
+         * @brief Returns the value at the current position.
+         */
+        int operator*() const;
+
+        /**
+         * @brief Advances to the next larger value.
+         */
+        const_iterator& operator++();
+
+        /**
+         * @brief Advances to the next larger value (postfix).
+         */
+        const_iterator operator++(int);
+
+        /**
+         * @brief Moves back to the next smaller value.
+         * @note Decrementing end() yields the largest value.
+         */
+        const_iterator& operator--();
+
+        /**
+         * @brief Moves back to the next smaller value (postfix).
+         */
+        const_iterator operator--(int);
+
+        bool operator==(const const_iterator& other) const { return current == other.current; }
+        bool operator!=(const const_iterator& other) const { return current != other.current; }
+
+    private:
+        friend class BST;
+
+        /**
+         * @brief How seek() chooses its target node.
+         */
+        enum class Seek { First, Last, LowerBound, UpperBound, Before };
+
+        const BST* tree;
+        const Node* current;
+        const Node* path[kMaxDepth];
+        int depth;
+        bool tracked;
+
+        explicit const_iterator(const BST* tree);
+
+        /**
+         * @brief Descends from the root to the target node, recording its
+         *        ancestors.
+         */
+        void seek(Seek mode, int value);
+
+        /**
+         * @brief Appends an ancestor, dropping tracking if the array is full.
+         */
+        void pushAncestor(const Node* n);
+    };
+
+    /**
+     * @class Range
+     * @brief A pair of iterators delimiting a half-open range of values.
+     * @details Returned by range(); usable directly in a range-based for loop.
+     */
+    class Range {
+    public:
+        Range(const_iterator first, const_iterator last) : first(first), last(last) {}
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+
+    private:
+        const_iterator first;
+        const_iterator last;
+    };
+
     /**
      * @brief Constructs an empty BST.
+     * @param policy The balancing policy used by insert and remove.
      */
-    BST();
+    explicit BST(BalancePolicy policy = BalancePolicy::None);
+
+    /**
+     * @brief Builds a perfectly balanced BST from a range of values.
+     * @param first  Pointer to the first value.
+     * @param last   Pointer one past the last value.
+     * @param policy The balancing policy used by later inserts and removes.
+     *
+     * @details
+     * When the range is already in ascending order (duplicates allowed) the
+     * tree is built in O(n) time with no comparisons beyond a single
+     * validation pass; otherwise a sorted copy is made first, which costs
+     * O(n log n). Duplicate values are ignored. All nodes are allocated in
+     * one contiguous block, and the resulting tree has the minimum possible
+     * height, floor(log2(n)) + 1, with valid AVL heights at every node.
+     */
+    BST(const int* first, const int* last, BalancePolicy policy = BalancePolicy::None);
+
+    /**
+     * @brief Builds a perfectly balanced BST from an iterator range.
+     * @details Ranges that are not contiguous int arrays are first copied
+     * into a temporary buffer; see BST(const int*, const int*, BalancePolicy).
+     */
+    template <class InputIt,
+              class = typename std::iterator_traits<InputIt>::value_type>
+    BST(InputIt first, InputIt last, BalancePolicy policy = BalancePolicy::None);
 
     /**
      * @brief Destroys the BST and frees all dynamically allocated nodes.
      */
     ~BST();
 
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
     /**
      * @brief Inserts a value into the BST.
      * @param value The integer value to insert.
@@ -70,21 +384,146 @@ public:
      * @brief Searches for a value in the BST.
      * @param value The value to search for.
      * @return true if the value exists in the tree; otherwise false.
+     * @details Never restructures the tree, under any policy; use access()
+     * for lookups that should splay. With a membership filter enabled, a
+     * value the filter rejects is reported absent without descending the
+     * tree.
      */
     bool search(int value) const;
 
+    /**
+     * @brief Looks up a value, letting a splay tree adapt to the lookup.
+     * @param value The value to search for.
+     * @return true if the value exists in the tree; otherwise false.
+     * @details Under BalancePolicy::Splay the node found (or, on a miss,
+     * the last node visited) is splayed to the root, subject to
+     * setSplayInterval(). That changes the tree's shape but never its
+     * contents, and invalidates iterators like an insert would. Under any
+     * other policy this is the same as search().
+     */
+    bool access(int value);
+
+    /**
+     * @brief Searches for many values at once, overlapping their cache misses.
+     * @param values  Array of count values to look up.
+     * @param count   Number of values in the array.
+     * @param results Output array of count flags; results[i] is set to true
+     *                if values[i] exists in the tree, otherwise false.
+     *
+     * @details
+     * Up to kBatchWidth lookups are kept in flight and advanced one tree
+     * level at a time in round-robin order. After each step the next node of
+     * that lookup is prefetched, so by the time the lookup is advanced again
+     * its node is usually already in cache. On trees much larger than the
+     * last-level cache this hides most of the latency that a loop of
+     * search() calls pays serially, one dependent miss per level. With a
+     * membership filter enabled, values it rejects never occupy a slot.
+     */
+    void searchBatch(const int* values, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Counts how many of the given values exist in the tree.
+     * @param values Array of count values to look up.
+     * @param count  Number of values in the array.
+     * @return Number of values (including repeats) found in the tree.
+     * @details Uses the same interleaved, prefetching traversal as
+     * searchBatch() without producing per-value results.
+     */
+    std::size_t containsMany(const int* values, std::size_t count) const;
+
     /**
      * @brief Performs an inorder traversal of the tree.
      * @details
      * Prints node values in ascending order using an iterative traversal.
+     * Output goes through writeInorder(), so large trees are printed in
+     * buffered chunks rather than one formatted stream insertion per value.
      */
     void inorder() const;
 
     /**
      * @brief Performs a level-order (breadth-first) traversal of the tree.
+     * @details Output goes through writeLevelOrder().
      */
     void levelOrder() const;
 
+    /**
+     * @brief Calls a visitor with every value in ascending order.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @details
+     * The visitor is a template parameter, so simple lambdas are inlined
+     * into the traversal loop. The walk keeps its path on a local Stack, so
+     * it runs in O(n) on any shape and allocates only when the tree is
+     * deeper than the stack's inline buffer. The visitor may call const
+     * members of the same tree; it must not insert or remove values.
+     */
+    template <class Visitor>
+    void forEachInorder(Visitor visit) const;
+
+    /**
+     * @brief Calls a visitor with every value in ascending order, using
+     *        no auxiliary memory.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @details
+     * Morris traversal: before descending into a left subtree, the empty
+     * right link of that subtree's largest node is pointed back at the
+     * current node, and the walk later follows this thread up instead of
+     * popping a stack. Every thread is removed again on the way back, so the
+     * tree is unchanged once the call returns. The walk runs in O(n) time
+     * with O(1) extra space regardless of the tree's shape, which makes it
+     * the traversal of choice for degenerate (unbalanced) trees.
+     * @note While the walk runs the tree is temporarily rewired, so it is
+     *       non-const: the visitor must not access this tree at all (not
+     *       even search()), no other thread may read it, and the visitor
+     *       must not throw.
+     */
+    template <class Visitor>
+    void forEachInorderStackless(Visitor visit);
+
+    /**
+     * @brief Calls a visitor with every value in [low, high), ascending.
+     * @param low   Inclusive lower bound.
+     * @param high  Exclusive upper bound.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @note Runs in O(height + k) for k visited values.
+     */
+    template <class Visitor>
+    void forEachInRange(int low, int high, Visitor visit) const;
+
+    /**
+     * @brief Calls a visitor with every value in level (breadth-first) order.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @note Uses a local queue, so the visitor may call const members of
+     *       the same tree; it must not insert or remove values.
+     */
+    template <class Visitor>
+    void forEachLevelOrder(Visitor visit) const;
+
+    /**
+     * @brief Copies every value, in ascending order, to an output iterator.
+     * @param out Destination iterator (for example a std::back_inserter or
+     *            a pointer into a large enough array).
+     * @return The output iterator advanced past the last written value.
+     */
+    template <class OutputIt>
+    OutputIt copyInorder(OutputIt out) const;
+
+    /**
+     * @brief Writes all values in ascending order to a C stream.
+     * @param out Destination stream.
+     * @details Values are formatted with std::to_chars into a large buffer
+     * and written one chunk at a time, each followed by a space; a newline
+     * ends the output. The walk is forEachInorder(), so printing stays
+     * linear even when the tree has degenerated into a chain.
+     */
+    void writeInorder(std::FILE* out) const;
+
+    /**
+     * @brief Writes all values in level order to a C stream.
+     * @param out Destination stream.
+     * @details Same format and buffering as writeInorder().
+     */
+    void writeLevelOrder(std::FILE* out) const;
+
     /**
      * @brief Removes a value from the BST if it exists.
      * @param value The value to remove.
@@ -92,14 +531,707 @@ public:
      */
     bool remove(int value);
 
+    /**
+     * @brief Returns the current balancing policy.
+     */
+    BalancePolicy getBalancePolicy() const;
+
+    /**
+     * @brief Changes how later operations restructure the tree.
+     * @param policy The new policy.
+     * @details Switching to BalancePolicy::AVL from another policy first
+     * relinks the tree into a perfectly balanced shape in O(n), because
+     * the other policies leave node heights stale. Switching away from AVL,
+     * or between None and Splay, takes effect immediately; in particular,
+     * switching a splay tree to None freezes its current shape, so lookups
+     * no longer write to the tree.
+     */
+    void setBalancePolicy(BalancePolicy policy);
+
+    /**
+     * @brief Makes a splay tree splay only every interval-th access().
+     * @param interval 1 (the default) splays on every lookup, as a classic
+     *        splay tree does; 0 is treated as 1.
+     * @details The lookups in between descend without recording their
+     * path or writing to the tree, so they cost what search() costs. Hot values are sampled often, so they
+     * still rise toward the root, while the restructuring work (and the
+     * cache lines it dirties) shrinks by the interval. Inserts always
+     * splay. Has no effect under other policies.
+     */
+    void setSplayInterval(unsigned int interval);
+
+    /**
+     * @brief Puts a membership filter in front of the tree's lookups.
+     * @param bitsPerKey            Minimum filter bits per stored value;
+     *                              16 keeps false positives near 0.1%, and
+     *                              8 near 3%.
+     * @param maxFalsePositiveRate  Measured false-positive rate above which
+     *                              the filter is rebuilt from the tree.
+     * @return false, with the filter unchanged, if bitsPerKey is 0 or the
+     *         rate is not in (0, 1].
+     * @details Builds the filter from the current values in O(n) and resets
+     * its counters. Calling it again with the filter enabled rebuilds it
+     * with the new settings. The rate is judged once per window of
+     * max(kFilterWindow, size()) lookups for absent values, so a rebuild
+     * costs O(1) amortized per lookup even when the rate cannot be met.
+     */
+    bool enableFilter(unsigned int bitsPerKey = 16, double maxFalsePositiveRate = 0.02);
+
+    /**
+     * @brief Rebuilds the filter if its measured false-positive rate has
+     *        drifted above the maximum.
+     * @return true if the filter was rebuilt.
+     * @details insert() and remove() make the same check, so only a tree
+     * that is no longer modified, while lookups keep finding removed
+     * values, needs to call this; once per window of lookups is enough.
+     * Runs in O(1) unless a completed window calls for an O(n) rebuild.
+     */
+    bool maintainFilter();
+
+    /**
+     * @brief Removes the membership filter and frees its storage.
+     */
+    void disableFilter();
+
+    /**
+     * @brief Returns whether a membership filter is enabled.
+     */
+    bool hasFilter() const;
+
+    /**
+     * @brief Returns the number of values stored in the tree.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Reports the tree's shape, memory footprint, and operation counters.
+     * @note Runs in O(n) time and allocates a local queue; intended for
+     *       diagnostics, not hot paths.
+     */
+    BSTStats stats() const;
+
+    /**
+     * @brief Zeroes the operation counters reported by stats().
+     * @note The filter counters are zeroed whenever a filter is enabled;
+     *       the others only when BST_ENABLE_STATS is.
+     */
+    void resetCounters();
+
+#if BST_ORDER_STATISTICS
+    /**
+     * @brief Counts the values strictly less than the given value.
+     * @param value The value to rank; it need not be present in the tree.
+     * @return The number of stored values smaller than value, which is also
+     *         the zero-based position value has (or would have) in order.
+     * @note Runs in O(height).
+     */
+    std::size_t rank(int value) const;
+
+    /**
+     * @brief Finds the value at a zero-based position in ascending order.
+     * @param k      Position of the value to find (0 is the smallest).
+     * @param value  Receives the k-th smallest value when found.
+     * @return true if k < size(); otherwise false and value is unchanged.
+     * @details For example, the 99th percentile of a tree holding n values
+     * is select((n - 1) * 99 / 100, value).
+     * @note Runs in O(height).
+     */
+    bool select(std::size_t k, int& value) const;
+
+    /**
+     * @brief Counts the values in the closed interval [low, high].
+     * @return The number of stored values v with low <= v <= high, or 0
+     *         when low > high.
+     * @note Runs in O(height).
+     */
+    std::size_t countRange(int low, int high) const;
+#endif
+
+    /**
+     * @brief Returns an iterator to the smallest value.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Returns the past-the-end iterator.
+     */
+    const_iterator end() const;
+
+    /**
+     * @brief Returns an iterator to the first value not less than value.
+     * @return The matching position, or end() if every value is smaller.
+     * @note Runs in O(height).
+     */
+    const_iterator lower_bound(int value) const;
+
+    /**
+     * @brief Returns an iterator to the first value greater than value.
+     * @return The matching position, or end() if no value is greater.
+     * @note Runs in O(height).
+     */
+    const_iterator upper_bound(int value) const;
+
+    /**
+     * @brief Returns the values in the half-open interval [low, high).
+     * @param low  Inclusive lower bound.
+     * @param high Exclusive upper bound.
+     * @details Locating both ends costs O(height); iterating the k values
+     * in the range costs O(k) more for a balanced tree, with no allocation.
+     */
+    Range range(int low, int high) const;
+
+    /**
+     * @brief Creates an immutable, read-optimized snapshot of the tree.
+     * @return A FrozenBST holding the tree's current values in Eytzinger
+     *         layout.
+     * @details The values are written straight into the snapshot's array
+     * during a single in-order traversal, in O(n) time. Later changes to
+     * the tree do not affect the snapshot.
+     */
+    FrozenBST freeze() const;
+
+    /**
+     * @brief Writes the tree's values to a compact binary key file.
+     * @param path     Destination file; it is created or overwritten.
+     * @param encoding Payload encoding; delta-varint files of dense keys
+     *                 take about one byte per key.
+     * @return true on success, false if the file could not be written.
+     * @details The values are streamed in ascending order during one
+     * in-order traversal. See KeyFormat.h for the file layout.
+     */
+    bool save(const char* path, KeyEncoding encoding = KeyEncoding::DeltaVarint) const;
+
+    /**
+     * @brief Replaces the tree's contents with a key file written by save().
+     * @param path Source file.
+     * @return true on success. If the file is missing, has a bad header, or
+     *         fails its checksum, false is returned and the tree is left
+     *         unchanged; a payload that passes its checksum but cannot be
+     *         decoded leaves the tree empty.
+     * @details The file is memory-mapped and verified, then decoded straight
+     * into one contiguous block of nodes that is linked into a perfectly
+     * balanced tree, in O(n) time with no key comparisons and no
+     * rebalancing. Whenever the contents are replaced, an enabled
+     * membership filter is rebuilt to match them.
+     */
+    bool load(const char* path);
+
+    /**
+     * @brief Splits the tree around a key.
+     * @param key     The pivot value.
+     * @param greater Receives every value greater than key; its previous
+     *                contents are discarded.
+     * @return true if key was present. The key itself ends up in neither tree.
+     * @details This tree keeps the values less than key. Runs in O(log n);
+     * with BST_ORDER_STATISTICS disabled, counting the values moved to
+     * greater adds O(size of greater). If either side holds fewer values
+     * than one pool slab, its values are copied into slabs of its own
+     * tree's pool (O(size of that side)) and the other tree keeps all of
+     * the original storage. Otherwise both trees keep using the node
+     * storage they now share, and a slab is only freed once both have
+     * released it.
+     */
+    bool split(int key, BST& greater);
+
+    /**
+     * @brief Appends key and every value of greater to this tree.
+     * @param key     A value greater than every value in this tree.
+     * @param greater A tree whose values are all greater than key; it is
+     *                left empty.
+     * @return true on success; false, with both trees unchanged, if the
+     *         ordering requirement does not hold.
+     * @note Runs in O(|height difference| + 1) after the O(log n) ordering
+     *       check.
+     */
+    bool join(int key, BST& greater);
+
+    /**
+     * @brief Adds every value of other to this tree.
+     * @details other is unchanged; its values are first copied, in O(m), into
+     *          this tree's storage.
+     */
+    void unionWith(const BST& other);
+
+    /**
+     * @brief Moves every value of other into this tree, leaving other empty.
+     * @details Nodes of other are relinked, not copied. Runs in
+     *          O(m log(n / m + 1)) work for trees of sizes m <= n.
+     */
+    void unionWith(BST&& other);
+
+    /**
+     * @brief Keeps only the values that are also in other.
+     * @details other is unchanged; see unionWith(const BST&).
+     */
+    void intersectWith(const BST& other);
+
+    /**
+     * @brief Keeps only the values that are also in other, leaving other empty.
+     */
+    void intersectWith(BST&& other);
+
+    /**
+     * @brief Removes every value that is also in other.
+     * @details other is unchanged; see unionWith(const BST&).
+     */
+    void differenceWith(const BST& other);
+
+    /**
+     * @brief Removes every value that is also in other, leaving other empty.
+     */
+    void differenceWith(BST&& other);
+
+    /**
+     * @brief Number of lookups kept in flight by searchBatch().
+     */
+    static const int kBatchWidth = 16;
+
+    /**
+     * @brief Fewest lookups for absent values between filter rate checks.
+     */
+    static const std::size_t kFilterWindow = 4096;
+
 private:
+    /**
+     * @brief Set operation selector for setOperation().
+     */
+    enum class SetOp { Union, Intersection, Difference };
+
+    /**
+     * @struct DropList
+     * @brief Nodes discarded by a set operation, awaiting return to the pool.
+     * @details Linked through their left pointers, the free-list layout, so
+     *          the whole list is released with one NodePool::releaseChain().
+     *          Each parallel branch fills its own list; lists are spliced
+     *          together once the branches have joined.
+     */
+    struct DropList {
+        Node* first = nullptr;
+        Node* last = nullptr;
+        std::size_t count = 0;
+
+        void add(Node* n);
+        void addTree(Node* subtree);
+        void append(DropList& other);
+    };
+
+    /**
+     * @brief Longest root-to-leaf path the join helpers can record.
+     * @details Every tree passed to them is AVL-balanced, and an AVL tree
+     *          of 2^64 nodes is less than 93 levels high.
+     */
+    static const int kMaxJoinPath = 128;
+
     Node* root;
+    std::size_t nodeCount;
+    BalancePolicy policy;
+    /** Lookups per splay, and lookups left until the next splay. */
+    unsigned int splayInterval;
+    unsigned int splayCountdown;
+    NodePool pool;
+    /** Path stack reused by insert, remove, and rebalancing. */
+    Stack scratchStack;
+
+#if BST_ENABLE_STATS
+    /**
+     * @struct OpCounters
+     * @brief Per-operation counters behind BSTStats.
+     */
+    struct OpCounters {
+        std::atomic<std::uint64_t> searches{0};
+        std::atomic<std::uint64_t> inserts{0};
+        std::atomic<std::uint64_t> removes{0};
+        std::atomic<std::uint64_t> comparisons{0};
+        std::atomic<std::uint64_t> nodesVisited{0};
+        std::atomic<std::uint64_t> rebalances{0};
+    };
+
+    /**
+     * Mutable so that const lookups can count their work; updated with
+     * relaxed loads and stores, so concurrent readers may lose counts but
+     * never race.
+     */
+    mutable OpCounters counters;
+#endif
+
+    /**
+     * @struct FilterState
+     * @brief The membership filter, its settings, and its measurements.
+     */
+    struct FilterState {
+        BloomFilter bloom;
+        bool enabled = false;
+        unsigned int bitsPerKey = 0;
+        double maxFalsePositiveRate = 0;
+        /** Values the bloom filter was last sized for. */
+        std::size_t sizedFor = 0;
+        std::uint64_t rebuilds = 0;
+        /**
+         * Measurements recorded by const lookups. Relaxed loads and stores
+         * keep concurrent lookups free of data races at the cost of a plain
+         * increment; an increment may be lost when two threads race.
+         */
+        mutable std::atomic<std::uint64_t> queries{0};
+        mutable std::atomic<std::uint64_t> rejected{0};
+        mutable std::atomic<std::uint64_t> falsePositives{0};
+        /** Lookups for absent values, and false positives among them, in the current window. */
+        mutable std::atomic<std::uint64_t> windowNegatives{0};
+        mutable std::atomic<std::uint64_t> windowFalsePositives{0};
+    };
+
+    FilterState filter;
+
+    /**
+     * @brief Returns the stored height of a subtree, or 0 for nullptr.
+     */
+    static int heightOf(const Node* n);
+
+    /**
+     * @brief Recomputes a node's height from its children's heights.
+     */
+    static void updateHeight(Node* n);
+
+    /**
+     * @brief Recomputes a node's subtree size from its children's sizes.
+     * @note Does nothing when BST_ORDER_STATISTICS is disabled.
+     */
+    static void updateSize(Node* n);
+
+#if BST_ORDER_STATISTICS
+    /**
+     * @brief Returns the stored size of a subtree, or 0 for nullptr.
+     */
+    static std::size_t sizeOf(const Node* n);
+
+    /**
+     * @brief Counts values less than (or, if inclusive, not greater than) value.
+     */
+    std::size_t countBelow(int value, bool inclusive) const;
+#endif
+
+    /**
+     * @brief Rotates the subtree rooted at n to the left.
+     * @return The new root of the subtree.
+     */
+    static Node* rotateLeft(Node* n);
+
+    /**
+     * @brief Rotates the subtree rooted at n to the right.
+     * @return The new root of the subtree.
+     */
+    static Node* rotateRight(Node* n);
+
+    /**
+     * @brief Left rotation for splaying.
+     * @details Heights are only meaningful under BalancePolicy::AVL, so
+     *          unlike rotateLeft() this refreshes subtree sizes only, and
+     *          does not read the heights of the moved nodes' children.
+     */
+    static Node* splayRotateLeft(Node* n);
+
+    /**
+     * @brief Right rotation for splaying; see splayRotateLeft().
+     */
+    static Node* splayRotateRight(Node* n);
+
+    /**
+     * @brief Restores the AVL invariant at a single node.
+     * @return The new root of the subtree, which may differ from n.
+     */
+    static Node* rebalance(Node* n);
+
+    /**
+     * @brief Rebalances every node on a recorded root-to-leaf path and
+     *        refreshes the subtree sizes along it.
+     * @param path Stack holding the path, deepest node on top.
+     * @note The stack is emptied by this call.
+     */
+    void rebalancePath(Stack& path);
+
+    /**
+     * @brief Splays a node to the root of the tree.
+     * @param path Stack holding the node's ancestors, its parent on top.
+     * @param n    The node to lift.
+     * @note The stack is emptied by this call.
+     */
+    void splayPath(Stack& path, Node* n);
+
+    /**
+     * @brief Splay-mode search: looks up a value and splays the node found,
+     *        or the last node visited on a miss.
+     */
+    bool splaySearch(int value);
+
+    /**
+     * @brief Plain descent from the root, leaving the tree untouched.
+     */
+    bool find(int value) const;
+
+    /**
+     * @brief Consults the membership filter, if any, for one lookup.
+     * @return true if value is certainly absent from the tree.
+     */
+    bool filterRejects(int value) const;
+
+    /**
+     * @brief Records that a lookup the filter let through found nothing.
+     */
+    void filterMissed() const;
+
+    /**
+     * @brief Rebuilds the filter if the current window is complete and its
+     *        false-positive rate is too high; otherwise starts a new window
+     *        once the current one is complete.
+     * @return true if the filter was rebuilt.
+     */
+    bool filterCheckDrift();
+
+    /**
+     * @brief Adds a value to the membership filter, if any.
+     */
+    void filterAdd(int value);
+
+    /**
+     * @brief Adds every value of a subtree to the membership filter, if any.
+     * @note Uses the scratch stack.
+     */
+    void filterAddTree(const Node* tree);
+
+    /**
+     * @brief Rebuilds the filter at the current size once the tree has
+     *        grown to twice the size it was built for.
+     */
+    void filterCheckGrowth();
+
+    /**
+     * @brief Resizes the filter for the current size and refills it from
+     *        the tree's values.
+     */
+    void rebuildFilter();
+
+    /**
+     * @brief Shared interleaved lookup used by searchBatch() and containsMany().
+     * @param results Optional per-value output; may be nullptr.
+     * @return Number of values found.
+     */
+    std::size_t batchLookup(const int* values, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Replaces the tree's contents with the values in [first, last).
+     * @details Sorts a copy of the range first if it is not ascending.
+     */
+    void buildFromRange(const int* first, const int* last);
+
+    /**
+     * @brief Builds the tree from an ascending range that may hold duplicates.
+     */
+    void buildFromSorted(const int* sorted, std::size_t count, std::size_t unique);
+
+    /**
+     * @brief Links count contiguous, constructed, ascending nodes into a
+     *        perfectly balanced tree.
+     * @return The root of the linked tree.
+     */
+    static Node* linkBalanced(Node* nodes, std::size_t count);
+
+    /**
+     * @brief Shared body of linkBalanced() and relinkBalanced().
+     * @param nodeAt Callable returning the i-th node in ascending order.
+     */
+    template <class NodeAt>
+    static Node* linkBalancedBy(NodeAt nodeAt, std::size_t count);
+
+    /**
+     * @brief Relinks the existing nodes into a perfectly balanced tree.
+     * @details Used before join-based operations on BalancePolicy::None
+     *          trees, whose stored heights are not maintained.
+     */
+    void relinkBalanced();
+
+    /**
+     * @brief Ensures the stored heights are accurate, relinking if needed.
+     */
+    void prepareForJoin();
+
+    /**
+     * @brief Builds a balanced copy of other's values from this tree's pool.
+     * @return The root of the copy.
+     */
+    Node* cloneFrom(const BST& other);
+
+    /**
+     * @brief Copies a subtree into a balanced block of another pool.
+     * @param tree  Root of the subtree; its nodes are returned to from.
+     * @param count Number of nodes in tree.
+     * @param from  Pool whose storage holds tree.
+     * @param to    Pool that receives the copies.
+     * @return The root of the copy.
+     * @details Used by split() so that a small side does not keep the
+     *          other side's slabs alive.
+     */
+    static Node* compactSubtree(Node* tree, std::size_t count, NodePool& from, NodePool& to);
+
+    /**
+     * @brief Applies a set operation between this tree and a subtree it owns.
+     * @param other      Root of a balanced subtree whose nodes live in this
+     *                   tree's pool.
+     * @param otherCount Number of nodes in other.
+     */
+    void setOperation(SetOp op, Node* other, std::size_t otherCount);
+
+    /**
+     * @brief Takes ownership of another tree's nodes for a set operation.
+     * @return The root of other's (balanced) tree; other is left empty.
+     */
+    Node* adoptTree(BST& other, std::size_t& count);
+
+    /**
+     * @brief Joins left, mid, and right into one AVL tree.
+     * @details Every value in left must be below mid's and every value in
+     *          right above it. Descends the spine of the taller tree to the
+     *          height of the shorter one, attaches there, and rebalances
+     *          back up, in O(|height difference| + 1).
+     */
+    static Node* joinNodes(Node* left, Node* mid, Node* right);
+
+    /**
+     * @brief Joins two AVL trees whose values are ordered, without a middle node.
+     * @details Detaches the maximum of left and uses it as the middle node.
+     */
+    static Node* joinPair(Node* left, Node* right);
+
+    /**
+     * @brief Splits an AVL tree into the values below and above key.
+     * @return The node holding key, detached, or nullptr if absent.
+     */
+    static Node* splitNodes(Node* t, int key, Node*& less, Node*& greater);
+
+    /**
+     * @brief Recursive, fork-join body of the set operations.
+     * @param forkDepth Remaining recursion levels allowed to start a thread.
+     */
+    static Node* setOperationNodes(SetOp op, Node* a, Node* b, DropList& dropped, int forkDepth);
 
     /**
      * @brief Releases all nodes in the tree.
+     * @details Frees the node pool's slabs in O(number of slabs).
      * @note Called internally by the destructor.
      */
     void destroyTree();
 };
 
+/**
+ * Contiguous int ranges are built directly; any other range is copied into a
+ * temporary array first.
+ */
+template <class InputIt, class>
+BST::BST(InputIt first, InputIt last, BalancePolicy p) : BST(p) {
+    if constexpr (std::is_convertible<InputIt, const int*>::value) {
+        buildFromRange(first, last);
+    }
+    else {
+        std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        int* buffer = new int[count ? count : 1];
+        std::size_t i = 0;
+        for (; first != last; ++first)
+            buffer[i++] = static_cast<int>(*first);
+        buildFromRange(buffer, buffer + count);
+        delete[] buffer;
+    }
+}
+
+/**
+ * Iterative in-order walk: push the left spine, visit the top node, then
+ * continue with its right subtree. The path lives on a local stack, so no
+ * shared scratch space is used.
+ */
+template <class Visitor>
+void BST::forEachInorder(Visitor visit) const {
+    Stack s;
+    Node* current = root;
+
+    while (current || !s.isEmpty()) {
+        while (current) {
+            s.push(current);
+            current = current->getLeft();
+        }
+        current = s.pop();
+        visit(current->getValue());
+        current = current->getRight();
+    }
+}
+
+/**
+ * For each node with a left subtree, the first visit threads its in-order
+ * predecessor back to it and descends left; the second visit (arriving
+ * through that thread) removes the thread, visits the node, and moves right.
+ */
+template <class Visitor>
+void BST::forEachInorderStackless(Visitor visit) {
+    Node* current = root;
+
+    while (current) {
+        Node* left = current->getLeft();
+        if (!left) {
+            visit(current->getValue());
+            current = current->getRight();
+            continue;
+        }
+
+        Node* predecessor = left;
+        while (predecessor->getRight() && predecessor->getRight() != current)
+            predecessor = predecessor->getRight();
+
+        if (!predecessor->getRight()) {
+            predecessor->setRight(current);
+            current = left;
+        }
+        else {
+            predecessor->setRight(nullptr);
+            visit(current->getValue());
+            current = current->getRight();
+        }
+    }
+}
+
+/**
+ * Starts at lower_bound(low) and stops at the first value not below high.
+ */
+template <class Visitor>
+void BST::forEachInRange(int low, int high, Visitor visit) const {
+    const_iterator last = end();
+    for (const_iterator it = lower_bound(low); it != last && *it < high; ++it)
+        visit(*it);
+}
+
+/**
+ * Breadth-first traversal using a local queue.
+ */
+template <class Visitor>
+void BST::forEachLevelOrder(Visitor visit) const {
+    if (!root) return;
+
+    Queue q;
+    q.enqueue(root);
+
+    while (!q.isEmpty()) {
+        Node* current = q.dequeue();
+        visit(current->getValue());
+
+        if (current->getLeft())
+            q.enqueue(current->getLeft());
+        if (current->getRight())
+            q.enqueue(current->getRight());
+    }
+}
+
+/**
+ * Writes each value through the output iterator via forEachInorder().
+ */
+template <class OutputIt>
+OutputIt BST::copyInorder(OutputIt out) const {
+    forEachInorder([&out](int value) { *out++ = value; });
+    return out;
+}
+
 #endif // BST_H
@@ -0,0 +1,27 @@
+/**
+ * @file BSTMap.cpp
+ * @brief Explicit instantiations of the BSTMap class template.
+ *
+ * @details
+ * BSTMap is defined entirely in BSTMap.h and BSTMap.tpp, so any key and
+ * value types can be used by including the header. This file instantiates
+ * every non-template member for the specializations the project relies on,
+ * so the whole template is compiled (and checked) with the library rather
+ * than only the members some caller happens to use:
+ * - BSTMap<int, std::uint64_t>, DurableBST's index of in-flight records.
+ * - BSTMap<std::string, int>, a class-type key with transparent lookup.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include "BSTMap.h"
+#include <cstdint>
+#include <string>
+
+template class MapNode<int, std::uint64_t>;
+template class BSTMap<int, std::uint64_t>;
+
+template class MapNode<std::string, int>;
+template class BSTMap<std::string, int>;
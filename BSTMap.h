@@ -0,0 +1,318 @@
+/**
+ * @file BSTMap.h
+ * @brief Declaration of the MapNode and BSTMap class templates.
+ *
+ * @details
+ * This header declares BSTMap, a generic, self-balancing (AVL) binary search
+ * tree that maps keys of any ordered type to values stored directly inside
+ * the tree nodes. It complements the integer-based BST with an associative
+ * container that supports custom comparators, in-place construction of
+ * values, and heterogeneous lookup through transparent comparators.
+ *
+ * BSTMap is a separate container, not a generalization of BST: it shares
+ * BST's design (iterative AVL updates, raw-pointer nodes) but none of its
+ * code, and lacks BST's node pool, filter, and bulk operations. DurableBST
+ * uses it to index records that are not yet durable.
+ *
+ * Because BSTMap is a class template, its member definitions must be visible
+ * wherever it is instantiated. They are defined in BSTMap.tpp, which is
+ * included at the end of this header; BSTMap.cpp explicitly instantiates
+ * the specializations the project uses.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef BSTMAP_H
+#define BSTMAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+/**
+ * @class MapNode
+ * @brief Represents a node within a BSTMap.
+ *
+ * @details
+ * A MapNode stores a key, its associated value, the height of the subtree
+ * rooted at the node, and raw pointers to its left and right children. The
+ * key is immutable once constructed, since changing it could violate the
+ * tree ordering; the value may be modified freely.
+ *
+ * @tparam Key   The key type.
+ * @tparam Value The mapped value type.
+ */
+template <class Key, class Value>
+class MapNode {
+public:
+    /**
+     * @brief Constructs a node, building the key and value in place.
+     * @param key  Argument used to construct the stored key.
+     * @param args Arguments forwarded to the value's constructor.
+     */
+    template <class K, class... Args>
+    MapNode(K&& key, Args&&... args);
+
+    /**
+     * @brief Returns the stored key.
+     */
+    const Key& getKey() const;
+
+    /**
+     * @brief Returns a reference to the stored value.
+     */
+    Value& getValue();
+
+    /**
+     * @brief Returns a read-only reference to the stored value.
+     */
+    const Value& getValue() const;
+
+    /**
+     * @brief Returns a pointer to the left child node, or nullptr.
+     */
+    MapNode* getLeft() const;
+
+    /**
+     * @brief Sets the pointer to the left child node.
+     * @note Ownership of the node is not transferred.
+     */
+    void setLeft(MapNode* left);
+
+    /**
+     * @brief Returns a pointer to the right child node, or nullptr.
+     */
+    MapNode* getRight() const;
+
+    /**
+     * @brief Sets the pointer to the right child node.
+     * @note Ownership of the node is not transferred.
+     */
+    void setRight(MapNode* right);
+
+    /**
+     * @brief Returns the height of the subtree rooted at this node.
+     */
+    int getHeight() const;
+
+    /**
+     * @brief Sets the height of the subtree rooted at this node.
+     */
+    void setHeight(int height);
+
+private:
+    Key key;
+    Value value;
+    int height;
+    MapNode* left;
+    MapNode* right;
+};
+
+/**
+ * @class BSTMap
+ * @brief Iterative, AVL-balanced binary search tree mapping keys to values.
+ *
+ * @details
+ * BSTMap follows the same design as BST: every operation is iterative, nodes
+ * are managed through raw pointers, and the tree owns all of its nodes. In
+ * addition to a key, each node stores the mapped value itself, so a lookup
+ * returns the record directly instead of requiring a second container.
+ *
+ * The tree is always height-balanced using the AVL rules, so its height stays
+ * O(log n) for any insertion order. Because the height is bounded, the search
+ * path is recorded in a fixed-size array rather than a heap-allocated stack.
+ *
+ * Ordering is defined by Compare, which must provide a strict weak ordering.
+ * The default, std::less<>, is a transparent comparator: lookup functions
+ * accept any type that can be compared with Key, so a
+ * BSTMap<std::string, Record> can be searched with a std::string_view or a
+ * string literal without constructing a temporary std::string. Custom
+ * comparators opt into this behavior by declaring an is_transparent member
+ * type. Without it, lookups take a const Key&.
+ *
+ * The tree maintains standard BST ordering properties:
+ * - Left subtree contains keys ordered before the node's key.
+ * - Right subtree contains keys ordered after the node's key.
+ * - Duplicate keys are ignored; the existing value is kept.
+ *
+ * Pointers returned by find() and emplace() remain valid until the
+ * corresponding key is removed or the map is destroyed; rebalancing never
+ * moves keys or values between nodes.
+ *
+ * @tparam Key     The key type.
+ * @tparam Value   The mapped value type.
+ * @tparam Compare The ordering used for keys (default std::less<>).
+ *
+ * @see BST
+ * @see MapNode
+ */
+template <class Key, class Value, class Compare = std::less<>>
+class BSTMap {
+public:
+    /**
+     * @brief Node type used by this map.
+     */
+    typedef MapNode<Key, Value> NodeType;
+
+    /**
+     * @brief Constructs an empty map.
+     * @param comp The comparator instance used to order keys.
+     */
+    explicit BSTMap(const Compare& comp = Compare());
+
+    /**
+     * @brief Destroys the map and every node it owns.
+     */
+    ~BSTMap();
+
+    BSTMap(const BSTMap&) = delete;
+    BSTMap& operator=(const BSTMap&) = delete;
+
+    /**
+     * @brief Inserts a key with a value constructed in place.
+     * @param key  The key, or any type comparable with Key (when Compare is
+     *             transparent) from which a Key can be constructed.
+     * @param args Arguments forwarded to the value's constructor.
+     * @return A pointer to the value stored for the key and true if a new
+     *         node was created, or a pointer to the existing value and false
+     *         if the key was already present.
+     * @note Nothing is constructed or allocated when the key already exists.
+     */
+    template <class K, class... Args>
+    std::pair<Value*, bool> emplace(K&& key, Args&&... args);
+
+    /**
+     * @brief Inserts a copy of the given key and value.
+     * @return true if the key was inserted; false if it was already present.
+     */
+    bool insert(const Key& key, const Value& value);
+
+    /**
+     * @brief Finds the value stored for a key.
+     * @param key The key to search for.
+     * @return Pointer to the stored value, or nullptr if the key is absent.
+     */
+    Value* find(const Key& key);
+
+    /**
+     * @brief Finds the value stored for a key (read-only).
+     */
+    const Value* find(const Key& key) const;
+
+    /**
+     * @brief Finds the value stored for a key comparable with Key.
+     * @details Only available when Compare is transparent.
+     */
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    Value* find(const K& key);
+
+    /**
+     * @brief Finds the value stored for a key comparable with Key (read-only).
+     * @details Only available when Compare is transparent.
+     */
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const Value* find(const K& key) const;
+
+    /**
+     * @brief Checks whether a key is present.
+     */
+    bool contains(const Key& key) const;
+
+    /**
+     * @brief Checks whether a key comparable with Key is present.
+     * @details Only available when Compare is transparent.
+     */
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    bool contains(const K& key) const;
+
+    /**
+     * @brief Removes a key and its value if present.
+     * @return true if the key was found and removed; otherwise false.
+     */
+    bool remove(const Key& key);
+
+    /**
+     * @brief Removes a key comparable with Key and its value if present.
+     * @details Only available when Compare is transparent.
+     */
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    bool remove(const K& key);
+
+    /**
+     * @brief Visits every entry in ascending key order.
+     * @param visit Callable invoked as visit(const Key&, Value&).
+     */
+    template <class Visitor>
+    void forEach(Visitor visit);
+
+    /**
+     * @brief Visits every entry in ascending key order (read-only).
+     * @param visit Callable invoked as visit(const Key&, const Value&).
+     */
+    template <class Visitor>
+    void forEach(Visitor visit) const;
+
+    /**
+     * @brief Returns the number of entries in the map.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether the map is empty.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Removes every entry from the map.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Upper bound on the height of an AVL tree addressable in memory.
+     * @details An AVL tree of height h holds at least Fib(h + 2) - 1 nodes,
+     * so no tree that fits in a 64-bit address space exceeds this height.
+     */
+    static const int kMaxHeight = 96;
+
+    NodeType* root;
+    std::size_t count;
+    Compare comp;
+
+    /**
+     * @brief Locates the node holding a key, or returns nullptr.
+     */
+    template <class K>
+    NodeType* findNode(const K& key) const;
+
+    /**
+     * @brief Shared implementation of remove() for any comparable key type.
+     */
+    template <class K>
+    bool removeKey(const K& key);
+
+    /**
+     * @brief Shared implementation of the in-order traversal.
+     */
+    template <class Visitor>
+    void forEachNode(Visitor visit) const;
+
+    static int heightOf(const NodeType* n);
+    static void updateHeight(NodeType* n);
+    static NodeType* rotateLeft(NodeType* n);
+    static NodeType* rotateRight(NodeType* n);
+    static NodeType* rebalance(NodeType* n);
+
+    /**
+     * @brief Rebalances a recorded path of depth nodes, deepest last.
+     */
+    void rebalancePath(NodeType** path, int depth);
+};
+
+#include "BSTMap.tpp"
+
+#endif // BSTMAP_H
@@ -0,0 +1,443 @@
+/**
+ * @file BSTMap.tpp
+ * @brief Implementation of the MapNode and BSTMap class templates.
+ *
+ * @details
+ * This file contains the member definitions of MapNode and BSTMap. It is
+ * included by BSTMap.h and should not be included directly.
+ *
+ * As with BST, every algorithm is iterative. Because BSTMap is always AVL
+ * balanced, the search path recorded for rebalancing never exceeds
+ * kMaxHeight entries and is stored in a fixed-size local array.
+ */
+
+#include <new>
+
+// ----------------------------------------------------------------------
+// MapNode
+// ----------------------------------------------------------------------
+
+/**
+ * Constructs the key from its argument and the value from the remaining
+ * arguments; the node starts as a leaf.
+ */
+template <class Key, class Value>
+template <class K, class... Args>
+MapNode<Key, Value>::MapNode(K&& k, Args&&... args)
+    : key(std::forward<K>(k)), value(std::forward<Args>(args)...),
+      height(1), left(nullptr), right(nullptr) {}
+
+template <class Key, class Value>
+const Key& MapNode<Key, Value>::getKey() const {
+    return key;
+}
+
+template <class Key, class Value>
+Value& MapNode<Key, Value>::getValue() {
+    return value;
+}
+
+template <class Key, class Value>
+const Value& MapNode<Key, Value>::getValue() const {
+    return value;
+}
+
+template <class Key, class Value>
+MapNode<Key, Value>* MapNode<Key, Value>::getLeft() const {
+    return left;
+}
+
+template <class Key, class Value>
+void MapNode<Key, Value>::setLeft(MapNode* l) {
+    left = l;
+}
+
+template <class Key, class Value>
+MapNode<Key, Value>* MapNode<Key, Value>::getRight() const {
+    return right;
+}
+
+template <class Key, class Value>
+void MapNode<Key, Value>::setRight(MapNode* r) {
+    right = r;
+}
+
+template <class Key, class Value>
+int MapNode<Key, Value>::getHeight() const {
+    return height;
+}
+
+template <class Key, class Value>
+void MapNode<Key, Value>::setHeight(int h) {
+    height = h;
+}
+
+// ----------------------------------------------------------------------
+// BSTMap
+// ----------------------------------------------------------------------
+
+/**
+ * Initializes an empty map with the given comparator.
+ */
+template <class Key, class Value, class Compare>
+BSTMap<Key, Value, Compare>::BSTMap(const Compare& c)
+    : root(nullptr), count(0), comp(c) {}
+
+/**
+ * Calls clear() to destroy all entries.
+ */
+template <class Key, class Value, class Compare>
+BSTMap<Key, Value, Compare>::~BSTMap() {
+    clear();
+}
+
+/**
+ * Searches for the insertion point using the key as given, so a transparent
+ * comparator never needs to build a Key for a duplicate. Only when the key is
+ * absent is the node (key and value) constructed in place. The recorded path
+ * is then rebalanced.
+ */
+template <class Key, class Value, class Compare>
+template <class K, class... Args>
+std::pair<Value*, bool> BSTMap<Key, Value, Compare>::emplace(K&& key, Args&&... args) {
+    NodeType* path[kMaxHeight];
+    int depth = 0;
+    NodeType* current = root;
+    bool goLeft = false;
+
+    // Traverse the tree to find the insertion point
+    while (current) {
+        if (comp(key, current->getKey()))
+            goLeft = true;
+        else if (comp(current->getKey(), key))
+            goLeft = false;
+        else
+            return std::pair<Value*, bool>(&current->getValue(), false);
+
+        path[depth++] = current;
+        current = goLeft ? current->getLeft() : current->getRight();
+    }
+
+    NodeType* newNode = new NodeType(std::forward<K>(key), std::forward<Args>(args)...);
+    count++;
+
+    // Attach the new node to its parent
+    if (depth == 0)
+        root = newNode;
+    else if (goLeft)
+        path[depth - 1]->setLeft(newNode);
+    else
+        path[depth - 1]->setRight(newNode);
+
+    rebalancePath(path, depth);
+    return std::pair<Value*, bool>(&newNode->getValue(), true);
+}
+
+/**
+ * Copies the key and value into a new node via emplace().
+ */
+template <class Key, class Value, class Compare>
+bool BSTMap<Key, Value, Compare>::insert(const Key& key, const Value& value) {
+    return emplace(key, value).second;
+}
+
+template <class Key, class Value, class Compare>
+Value* BSTMap<Key, Value, Compare>::find(const Key& key) {
+    NodeType* n = findNode(key);
+    return n ? &n->getValue() : nullptr;
+}
+
+template <class Key, class Value, class Compare>
+const Value* BSTMap<Key, Value, Compare>::find(const Key& key) const {
+    NodeType* n = findNode(key);
+    return n ? &n->getValue() : nullptr;
+}
+
+template <class Key, class Value, class Compare>
+template <class K, class C, class>
+Value* BSTMap<Key, Value, Compare>::find(const K& key) {
+    NodeType* n = findNode(key);
+    return n ? &n->getValue() : nullptr;
+}
+
+template <class Key, class Value, class Compare>
+template <class K, class C, class>
+const Value* BSTMap<Key, Value, Compare>::find(const K& key) const {
+    NodeType* n = findNode(key);
+    return n ? &n->getValue() : nullptr;
+}
+
+template <class Key, class Value, class Compare>
+bool BSTMap<Key, Value, Compare>::contains(const Key& key) const {
+    return findNode(key) != nullptr;
+}
+
+template <class Key, class Value, class Compare>
+template <class K, class C, class>
+bool BSTMap<Key, Value, Compare>::contains(const K& key) const {
+    return findNode(key) != nullptr;
+}
+
+template <class Key, class Value, class Compare>
+bool BSTMap<Key, Value, Compare>::remove(const Key& key) {
+    return removeKey(key);
+}
+
+template <class Key, class Value, class Compare>
+template <class K, class C, class>
+bool BSTMap<Key, Value, Compare>::remove(const K& key) {
+    return removeKey(key);
+}
+
+template <class Key, class Value, class Compare>
+template <class Visitor>
+void BSTMap<Key, Value, Compare>::forEach(Visitor visit) {
+    forEachNode([&visit](NodeType* n) { visit(n->getKey(), n->getValue()); });
+}
+
+template <class Key, class Value, class Compare>
+template <class Visitor>
+void BSTMap<Key, Value, Compare>::forEach(Visitor visit) const {
+    forEachNode([&visit](const NodeType* n) { visit(n->getKey(), n->getValue()); });
+}
+
+template <class Key, class Value, class Compare>
+std::size_t BSTMap<Key, Value, Compare>::size() const {
+    return count;
+}
+
+template <class Key, class Value, class Compare>
+bool BSTMap<Key, Value, Compare>::isEmpty() const {
+    return root == nullptr;
+}
+
+/**
+ * Destroys every node in O(n) time using O(1) extra space. While the root
+ * has a left child, a right rotation moves that child up; once the root has
+ * no left child it can be deleted and its right child becomes the new root.
+ */
+template <class Key, class Value, class Compare>
+void BSTMap<Key, Value, Compare>::clear() {
+    while (root) {
+        NodeType* left = root->getLeft();
+
+        if (left) {
+            root->setLeft(left->getRight());
+            left->setRight(root);
+            root = left;
+        }
+        else {
+            NodeType* next = root->getRight();
+            delete root;
+            root = next;
+        }
+    }
+
+    count = 0;
+}
+
+/**
+ * Iteratively descends from the root following the comparator.
+ */
+template <class Key, class Value, class Compare>
+template <class K>
+typename BSTMap<Key, Value, Compare>::NodeType*
+BSTMap<Key, Value, Compare>::findNode(const K& key) const {
+    NodeType* current = root;
+
+    while (current) {
+        if (comp(key, current->getKey()))
+            current = current->getLeft();
+        else if (comp(current->getKey(), key))
+            current = current->getRight();
+        else
+            return current;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Handles the three standard deletion cases. In the two-children case the
+ * inorder successor node is unlinked and spliced into the removed node's
+ * position, rather than copying its key and value, so that pointers to
+ * other values stay valid and Key and Value need not be assignable.
+ */
+template <class Key, class Value, class Compare>
+template <class K>
+bool BSTMap<Key, Value, Compare>::removeKey(const K& key) {
+    NodeType* path[kMaxHeight];
+    int depth = 0;
+    NodeType* current = root;
+
+    // Locate the node to delete
+    while (current) {
+        if (comp(key, current->getKey())) {
+            path[depth++] = current;
+            current = current->getLeft();
+        }
+        else if (comp(current->getKey(), key)) {
+            path[depth++] = current;
+            current = current->getRight();
+        }
+        else
+            break;
+    }
+
+    if (!current)
+        return false; // Key not found
+
+    NodeType* parent = depth ? path[depth - 1] : nullptr;
+    NodeType* replacement;
+
+    if (!current->getLeft() || !current->getRight()) {
+        // Cases 1 and 2: zero or one child takes the node's place
+        replacement = current->getLeft() ? current->getLeft() : current->getRight();
+    }
+    else {
+        // Case 3: splice the inorder successor into the node's position
+        int slot = depth;
+        path[depth++] = current;
+
+        NodeType* succParent = current;
+        NodeType* successor = current->getRight();
+
+        while (successor->getLeft()) {
+            succParent = successor;
+            path[depth++] = successor;
+            successor = successor->getLeft();
+        }
+
+        if (succParent == current)
+            current->setRight(successor->getRight());
+        else
+            succParent->setLeft(successor->getRight());
+
+        successor->setLeft(current->getLeft());
+        successor->setRight(current->getRight());
+        successor->setHeight(current->getHeight());
+
+        // The successor now occupies the removed node's place on the path
+        path[slot] = successor;
+        replacement = successor;
+    }
+
+    if (!parent)
+        root = replacement;
+    else if (parent->getLeft() == current)
+        parent->setLeft(replacement);
+    else
+        parent->setRight(replacement);
+
+    delete current;
+    count--;
+
+    rebalancePath(path, depth);
+    return true;
+}
+
+/**
+ * Iterative in-order traversal. The pending-node stack is bounded by the
+ * AVL height, so it lives in a fixed-size local array.
+ */
+template <class Key, class Value, class Compare>
+template <class Visitor>
+void BSTMap<Key, Value, Compare>::forEachNode(Visitor visit) const {
+    NodeType* stack[kMaxHeight];
+    int top = 0;
+    NodeType* current = root;
+
+    while (current || top > 0) {
+        while (current) {
+            stack[top++] = current;
+            current = current->getLeft();
+        }
+
+        current = stack[--top];
+        visit(current);
+        current = current->getRight();
+    }
+}
+
+template <class Key, class Value, class Compare>
+int BSTMap<Key, Value, Compare>::heightOf(const NodeType* n) {
+    return n ? n->getHeight() : 0;
+}
+
+template <class Key, class Value, class Compare>
+void BSTMap<Key, Value, Compare>::updateHeight(NodeType* n) {
+    int hl = heightOf(n->getLeft());
+    int hr = heightOf(n->getRight());
+    n->setHeight(1 + (hl > hr ? hl : hr));
+}
+
+template <class Key, class Value, class Compare>
+typename BSTMap<Key, Value, Compare>::NodeType*
+BSTMap<Key, Value, Compare>::rotateLeft(NodeType* n) {
+    NodeType* pivot = n->getRight();
+    n->setRight(pivot->getLeft());
+    pivot->setLeft(n);
+    updateHeight(n);
+    updateHeight(pivot);
+    return pivot;
+}
+
+template <class Key, class Value, class Compare>
+typename BSTMap<Key, Value, Compare>::NodeType*
+BSTMap<Key, Value, Compare>::rotateRight(NodeType* n) {
+    NodeType* pivot = n->getLeft();
+    n->setLeft(pivot->getRight());
+    pivot->setRight(n);
+    updateHeight(n);
+    updateHeight(pivot);
+    return pivot;
+}
+
+/**
+ * Same single/double rotation logic as BST::rebalance().
+ */
+template <class Key, class Value, class Compare>
+typename BSTMap<Key, Value, Compare>::NodeType*
+BSTMap<Key, Value, Compare>::rebalance(NodeType* n) {
+    updateHeight(n);
+    int balance = heightOf(n->getLeft()) - heightOf(n->getRight());
+
+    if (balance > 1) {
+        if (heightOf(n->getLeft()->getLeft()) < heightOf(n->getLeft()->getRight()))
+            n->setLeft(rotateLeft(n->getLeft()));
+        return rotateRight(n);
+    }
+
+    if (balance < -1) {
+        if (heightOf(n->getRight()->getRight()) < heightOf(n->getRight()->getLeft()))
+            n->setRight(rotateRight(n->getRight()));
+        return rotateLeft(n);
+    }
+
+    return n;
+}
+
+/**
+ * Walks the path from deepest to shallowest, relinking rotated subtrees and
+ * stopping once a node keeps both its identity and its height.
+ */
+template <class Key, class Value, class Compare>
+void BSTMap<Key, Value, Compare>::rebalancePath(NodeType** path, int depth) {
+    for (int i = depth - 1; i >= 0; i--) {
+        NodeType* n = path[i];
+        int oldHeight = n->getHeight();
+        NodeType* subtree = rebalance(n);
+
+        if (subtree == n && n->getHeight() == oldHeight)
+            break;
+
+        if (subtree != n) {
+            if (i == 0)
+                root = subtree;
+            else if (path[i - 1]->getLeft() == n)
+                path[i - 1]->setLeft(subtree);
+            else
+                path[i - 1]->setRight(subtree);
+        }
+    }
+}
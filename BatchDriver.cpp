@@ -0,0 +1,312 @@
+/**
+ * @file BatchDriver.cpp
+ * @brief Implementation of the BatchDriver class.
+ *
+ * @details
+ * This file contains the text and binary command parsers and the batch
+ * executor. Parsing never allocates; the only buffers are the batch arrays
+ * and, for streams, one input chunk.
+ */
+
+#include "BatchDriver.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+const unsigned char kBinaryMagic[4] = { 'B', 'S', 'T', 'O' };
+const unsigned int kBinaryVersion = 1;
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+BatchDriver::BatchDriver(BST& target, std::FILE* out, bool reportResults, std::FILE* diagnostics)
+    : BatchDriver(&target, nullptr, out, reportResults, diagnostics) {}
+
+BatchDriver::BatchDriver(BPlusTree& target, std::FILE* out, bool reportResults, std::FILE* diagnostics)
+    : BatchDriver(nullptr, &target, out, reportResults, diagnostics) {}
+
+BatchDriver::BatchDriver(BST* targetBST, BPlusTree* targetBPlus, std::FILE* out,
+                         bool reportResults, std::FILE* diagnostics)
+    : bst(targetBST), bplus(targetBPlus), output(out), writeResults(reportResults),
+      errors(diagnostics), lines(0), pending(0) {
+    ops = new unsigned char[kBatchSize];
+    values = new int[kBatchSize];
+    results = new bool[kBatchSize];
+}
+
+BatchDriver::~BatchDriver() {
+    delete[] ops;
+    delete[] values;
+    delete[] results;
+}
+
+bool BatchDriver::runFile(const char* path) {
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+    return runBuffer(file.data(), file.size());
+}
+
+/**
+ * The format is decided from the first chunk. Each pass parses what it
+ * can and moves the unconsumed tail to the front of the buffer. A text
+ * line longer than the whole buffer cannot be a valid command: it is
+ * reported once, and the passes that follow discard input up to and
+ * including its newline before parsing resumes, so no fragment of it is
+ * mistaken for a command.
+ */
+bool BatchDriver::runStream(std::FILE* in) {
+    unsigned char* buffer = new unsigned char[kChunkBytes];
+    std::size_t used = 0;
+    int binary = 0;
+    bool decided = false;
+    bool skippingLine = false;
+    bool ok = true;
+
+    for (;;) {
+        std::size_t read = std::fread(buffer + used, 1, kChunkBytes - used, in);
+        used += read;
+        bool final = read == 0;
+        if (final && std::ferror(in))
+            ok = false;
+
+        std::size_t consumed = 0;
+        if (!decided) {
+            if (used < kBinaryHeaderBytes && !final)
+                continue;
+            binary = detectBinary(buffer, used);
+            decided = true;
+            if (binary < 0) {
+                ok = false;
+                break;
+            }
+            if (binary)
+                consumed = kBinaryHeaderBytes;
+        }
+
+        if (binary) {
+            consumed += parseBinary(buffer + consumed, used - consumed);
+            if (final && consumed < used) {
+                totals.malformed++; // truncated last record
+                consumed = used;
+            }
+        } else {
+            const char* text = reinterpret_cast<const char*>(buffer);
+            if (skippingLine) {
+                const void* newline = std::memchr(text, '\n', used);
+                if (newline) {
+                    consumed = static_cast<std::size_t>(static_cast<const char*>(newline) - text) + 1;
+                    skippingLine = false;
+                    lines++;
+                } else {
+                    consumed = used;
+                }
+            }
+            if (!skippingLine) {
+                consumed += parseText(text + consumed, used - consumed, final);
+                if (consumed == 0 && used == kChunkBytes) {
+                    reportOverlongLine();
+                    skippingLine = true;
+                    consumed = used;
+                }
+            }
+        }
+
+        std::memmove(buffer, buffer + consumed, used - consumed);
+        used -= consumed;
+        if (final)
+            break;
+    }
+
+    executeBatch();
+    output.flush();
+    delete[] buffer;
+    return ok;
+}
+
+void BatchDriver::reportOverlongLine() {
+    totals.malformed++;
+    if (errors) {
+        std::fprintf(errors, "batch: line %llu is longer than %zu bytes; skipped\n",
+                     static_cast<unsigned long long>(lines + 1), kChunkBytes);
+    }
+}
+
+const BatchDriver::Summary& BatchDriver::summary() const {
+    return totals;
+}
+
+bool BatchDriver::runBuffer(const unsigned char* data, std::size_t size) {
+    int binary = detectBinary(data, size);
+    if (binary < 0)
+        return false;
+
+    if (binary) {
+        std::size_t payload = size - kBinaryHeaderBytes;
+        if (parseBinary(data + kBinaryHeaderBytes, payload) < payload)
+            totals.malformed++; // truncated last record
+    } else
+        parseText(reinterpret_cast<const char*>(data), size, true);
+
+    executeBatch();
+    output.flush();
+    return true;
+}
+
+int BatchDriver::detectBinary(const unsigned char* data, std::size_t size) {
+    if (size < 4 || std::memcmp(data, kBinaryMagic, 4) != 0)
+        return 0;
+    if (size < kBinaryHeaderBytes)
+        return -1;
+    unsigned int version = data[4] | (static_cast<unsigned int>(data[5]) << 8);
+    return version == kBinaryVersion ? 1 : -1;
+}
+
+/**
+ * Neither tree's insert() reports anything, so a change in size tells
+ * whether the value was new.
+ */
+bool BatchDriver::insertValue(int value) {
+    if (bst) {
+        std::size_t before = bst->size();
+        bst->insert(value);
+        return bst->size() != before;
+    }
+    std::size_t before = bplus->size();
+    bplus->insert(value);
+    return bplus->size() != before;
+}
+
+bool BatchDriver::removeValue(int value) {
+    return bst ? bst->remove(value) : bplus->remove(value);
+}
+
+void BatchDriver::searchValues(const int* values, std::size_t count, bool* found) {
+    if (bst)
+        bst->searchBatch(values, count, found);
+    else
+        bplus->searchBatch(values, count, found);
+}
+
+void BatchDriver::push(unsigned char op, int value) {
+    ops[pending] = op;
+    values[pending] = value;
+    if (++pending == kBatchSize)
+        executeBatch();
+}
+
+/**
+ * Inserts and removes run one at a time, in input order. A run of
+ * consecutive searches sees no intervening update, so it can be handed to
+ * searchBatch() as a whole.
+ */
+void BatchDriver::executeBatch() {
+    std::size_t i = 0;
+    while (i < pending) {
+        if (ops[i] == OpSearch) {
+            std::size_t run = i + 1;
+            while (run < pending && ops[run] == OpSearch)
+                run++;
+            searchValues(values + i, run - i, results + i);
+            for (std::size_t k = i; k < run; k++)
+                totals.found += results[k];
+            i = run;
+        } else if (ops[i] == OpInsert) {
+            results[i] = insertValue(values[i]);
+            totals.inserted += results[i];
+            i++;
+        } else {
+            results[i] = removeValue(values[i]);
+            totals.removed += results[i];
+            i++;
+        }
+    }
+
+    totals.operations += pending;
+    if (writeResults) {
+        for (std::size_t k = 0; k < pending; k++) {
+            output.append(results[k] ? '1' : '0');
+            output.append('\n');
+        }
+    }
+    pending = 0;
+}
+
+/**
+ * Each line is located with memchr and parsed in place; std::from_chars
+ * reads the value without copying it or consulting the locale.
+ */
+std::size_t BatchDriver::parseText(const char* data, std::size_t size, bool final) {
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (!newline && !final)
+            break;
+        const char* lineEnd = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        lines++;
+
+        const char* c = p;
+        while (c < lineEnd && isBlank(*c))
+            c++;
+        if (c == lineEnd || *c == '#') {
+            p = next;
+            continue;
+        }
+
+        unsigned char op;
+        switch (*c) {
+        case 'I': case 'i': op = OpInsert; break;
+        case 'D': case 'd': op = OpRemove; break;
+        case 'S': case 's': op = OpSearch; break;
+        default: op = 0xFF; break;
+        }
+        c++;
+
+        bool valid = op != 0xFF && c < lineEnd && isBlank(*c);
+        int value = 0;
+        if (valid) {
+            while (c < lineEnd && isBlank(*c))
+                c++;
+            std::from_chars_result parsed = std::from_chars(c, lineEnd, value);
+            c = parsed.ptr;
+            while (c < lineEnd && isBlank(*c))
+                c++;
+            valid = parsed.ec == std::errc() && c == lineEnd;
+        }
+
+        if (valid)
+            push(op, value);
+        else
+            totals.malformed++;
+        p = next;
+    }
+
+    return static_cast<std::size_t>(p - data);
+}
+
+/**
+ * Records with an unknown operation byte are skipped as malformed.
+ */
+std::size_t BatchDriver::parseBinary(const unsigned char* data, std::size_t size) {
+    std::size_t count = size / kRecordBytes;
+    for (std::size_t i = 0; i < count; i++) {
+        const unsigned char* record = data + i * kRecordBytes;
+        std::uint32_t raw = static_cast<std::uint32_t>(record[1])
+            | (static_cast<std::uint32_t>(record[2]) << 8)
+            | (static_cast<std::uint32_t>(record[3]) << 16)
+            | (static_cast<std::uint32_t>(record[4]) << 24);
+        if (record[0] <= OpSearch)
+            push(record[0], static_cast<int>(raw));
+        else
+            totals.malformed++;
+    }
+    return count * kRecordBytes;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file BatchDriver.h
+ * @brief Declaration of the BatchDriver class.
+ *
+ * @details
+ * This header declares BatchDriver, which replays a stream of insert,
+ * delete, and search commands against a BST or a BPlusTree without any
+ * interaction. It is the engine behind the demo program's --batch mode.
+ *
+ * Two input formats are accepted and told apart by their first bytes:
+ *
+ * Text: one command per line, an operation letter followed by a decimal
+ * value, e.g. `I 5`, `D -12`, `S 7` (letters are case-insensitive). Blank
+ * lines and lines starting with `#` are ignored; malformed lines are
+ * counted and skipped without producing a result. When reading a stream,
+ * a line too long to fit the input buffer is also reported, with its line
+ * number, on the diagnostics stream.
+ *
+ * Binary: an 8-byte header (magic "BSTO", a little-endian 16-bit version
+ * equal to 1, and two reserved zero bytes) followed by 5-byte records,
+ * each an operation byte (0 insert, 1 delete, 2 search) and a
+ * little-endian 32-bit value. Records with another operation byte, and a
+ * truncated final record, are counted as malformed and skipped.
+ *
+ * For every command the driver writes one result line, `1` or `0`: whether
+ * the value was inserted, deleted, or found.
+ *
+ * Implementation details are defined in BatchDriver.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef BATCHDRIVER_H
+#define BATCHDRIVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "BPlusTree.h"
+#include "BST.h"
+#include "OutputBuffer.h"
+
+/**
+ * @class BatchDriver
+ * @brief Parses command streams and executes them against a tree in batches.
+ *
+ * @details
+ * Commands are parsed straight out of the input bytes with std::from_chars,
+ * without copying lines or building strings, into fixed-size arrays of
+ * operations and values. When the arrays fill up (or the input ends) the
+ * batch is executed in order; every run of consecutive searches in it goes
+ * through the tree's searchBatch(), which for a BST overlaps the cache
+ * misses of many lookups. Results are formatted into an OutputBuffer.
+ *
+ * Files are memory-mapped and parsed in place. Streams such as standard
+ * input are read in large chunks; a line or record cut off at the end of
+ * a chunk is carried over to the front of the next one. A text line that
+ * fills the whole buffer on its own is skipped up to its newline, and
+ * parsing resumes with the line after it.
+ */
+class BatchDriver {
+public:
+    /**
+     * @struct Summary
+     * @brief Totals over every command executed so far.
+     */
+    struct Summary {
+        std::uint64_t operations = 0;
+        std::uint64_t inserted = 0;
+        std::uint64_t removed = 0;
+        std::uint64_t found = 0;
+        /** Text lines or binary records that could not be parsed. */
+        std::uint64_t malformed = 0;
+    };
+
+    /**
+     * @param tree          Tree the commands are applied to; not owned.
+     * @param out           Destination of the result lines.
+     * @param reportResults If false, no result lines are written; only the
+     *                      summary is kept.
+     * @param diagnostics   Destination of messages about skipped input, or
+     *                      nullptr for none.
+     */
+    BatchDriver(BST& tree, std::FILE* out, bool reportResults = true,
+                std::FILE* diagnostics = stderr);
+
+    /**
+     * @brief Executes commands against a BPlusTree instead of a BST.
+     * @details The parameters are the same as for the BST constructor.
+     */
+    BatchDriver(BPlusTree& tree, std::FILE* out, bool reportResults = true,
+                std::FILE* diagnostics = stderr);
+    ~BatchDriver();
+
+    BatchDriver(const BatchDriver&) = delete;
+    BatchDriver& operator=(const BatchDriver&) = delete;
+
+    /**
+     * @brief Memory-maps a command file and executes it.
+     * @return false if the file cannot be opened or has a bad binary header.
+     */
+    bool runFile(const char* path);
+
+    /**
+     * @brief Reads commands from a stream until end of file and executes them.
+     * @return false on a read error or a bad binary header.
+     */
+    bool runStream(std::FILE* in);
+
+    /**
+     * @brief Returns the totals so far.
+     */
+    const Summary& summary() const;
+
+    /**
+     * @brief Number of commands parsed before a batch is executed.
+     */
+    static const std::size_t kBatchSize = 4096;
+
+private:
+    enum : unsigned char {
+        OpInsert = 0,
+        OpRemove = 1,
+        OpSearch = 2
+    };
+
+    static const std::size_t kBinaryHeaderBytes = 8;
+    static const std::size_t kRecordBytes = 5;
+    static const std::size_t kChunkBytes = 1 << 20;
+
+    /** The target tree; exactly one of the two is set. */
+    BST* bst;
+    BPlusTree* bplus;
+    OutputBuffer output;
+    bool writeResults;
+    std::FILE* errors;
+    Summary totals;
+    /** Text lines consumed so far, so the next line is number lines + 1. */
+    std::uint64_t lines;
+
+    unsigned char* ops;
+    int* values;
+    bool* results;
+    std::size_t pending;
+
+    /**
+     * @brief Shared body of the public constructors.
+     */
+    BatchDriver(BST* bst, BPlusTree* bplus, std::FILE* out, bool reportResults,
+                std::FILE* diagnostics);
+
+    /**
+     * @brief Inserts a value into the target tree.
+     * @return true if the value was new.
+     */
+    bool insertValue(int value);
+
+    /**
+     * @brief Removes a value from the target tree.
+     * @return true if the value was present.
+     */
+    bool removeValue(int value);
+
+    /**
+     * @brief Looks up a run of values in the target tree.
+     */
+    void searchValues(const int* values, std::size_t count, bool* found);
+
+    /**
+     * @brief Queues one command, executing the batch once it is full.
+     */
+    void push(unsigned char op, int value);
+
+    /**
+     * @brief Executes and reports every queued command, in order.
+     */
+    void executeBatch();
+
+    /**
+     * @brief Parses complete text lines.
+     * @param final True if no more input follows, so a last line without
+     *              a newline is complete.
+     * @return Number of bytes consumed; an unfinished last line is left.
+     */
+    std::size_t parseText(const char* data, std::size_t size, bool final);
+
+    /**
+     * @brief Counts and reports the text line that cannot fit in a chunk.
+     */
+    void reportOverlongLine();
+
+    /**
+     * @brief Parses complete binary records.
+     * @return Number of bytes consumed; a partial last record is left.
+     */
+    std::size_t parseBinary(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief Runs a whole input held in memory.
+     */
+    bool runBuffer(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief Returns 1 if data starts with a valid binary header, 0 if it
+     *        is text, and -1 if it has the magic but an unknown version.
+     */
+    static int detectBinary(const unsigned char* data, std::size_t size);
+};
+
+#endif // BATCHDRIVER_H
@@ -0,0 +1,105 @@
+/**
+ * @file BloomFilter.cpp
+ * @brief Implementation of the BloomFilter class.
+ *
+ * @details
+ * This file contains the block allocation, hashing, and bit selection of
+ * the cache-line-blocked Bloom filter.
+ */
+
+#include "BloomFilter.h"
+#include <cstring>
+#include <new>
+
+namespace {
+
+/**
+ * Odd multipliers that spread the low 32 hash bits into one bit position
+ * per word (the constants of the Parquet split block Bloom filter).
+ */
+const std::uint32_t kSalts[8] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+};
+
+/** Smallest block array; keeps tiny trees from thrashing one block. */
+const std::size_t kMinBlocks = 4;
+
+} // namespace
+
+BloomFilter::BloomFilter() : blocks(nullptr), mask(0), count(0) {}
+
+BloomFilter::~BloomFilter() {
+    release();
+}
+
+/**
+ * Each block holds 512 bits; the number needed is rounded up to a power of
+ * two so a block index is a mask rather than a division.
+ */
+void BloomFilter::reset(std::size_t expectedKeys, unsigned int bitsPerKey) {
+    std::size_t wanted = (expectedKeys * bitsPerKey + 511) / 512;
+    std::size_t blocksNeeded = kMinBlocks;
+    while (blocksNeeded < wanted)
+        blocksNeeded <<= 1;
+
+    if (blocksNeeded != count) {
+        release();
+        blocks = static_cast<Block*>(::operator new[](blocksNeeded * sizeof(Block), std::align_val_t(64)));
+        count = blocksNeeded;
+        mask = blocksNeeded - 1;
+    }
+    std::memset(blocks, 0, count * sizeof(Block));
+}
+
+void BloomFilter::release() {
+    if (blocks)
+        ::operator delete[](blocks, std::align_val_t(64));
+    blocks = nullptr;
+    mask = 0;
+    count = 0;
+}
+
+void BloomFilter::add(int key) {
+    if (!blocks) return;
+
+    std::uint64_t h = hash(key);
+    Block& block = blocks[(h >> 32) & mask];
+    std::uint32_t low = static_cast<std::uint32_t>(h);
+    for (int i = 0; i < 8; i++)
+        block.words[i] |= std::uint64_t(1) << ((low * kSalts[i]) >> 26);
+}
+
+/**
+ * The eight tests are combined without early exit, which compiles to
+ * straight-line code over the one cache line.
+ */
+bool BloomFilter::mayContain(int key) const {
+    if (!blocks) return true;
+
+    std::uint64_t h = hash(key);
+    const Block& block = blocks[(h >> 32) & mask];
+    std::uint32_t low = static_cast<std::uint32_t>(h);
+    std::uint64_t missing = 0;
+    for (int i = 0; i < 8; i++)
+        missing |= ~block.words[i] & (std::uint64_t(1) << ((low * kSalts[i]) >> 26));
+    return missing == 0;
+}
+
+std::size_t BloomFilter::memoryBytes() const {
+    return count * sizeof(Block);
+}
+
+/**
+ * The finalizer of MurmurHash3 (fmix64): every input bit affects every
+ * output bit, so nearby keys land in unrelated blocks.
+ */
+std::uint64_t BloomFilter::hash(int key) {
+    std::uint64_t h = static_cast<std::uint32_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
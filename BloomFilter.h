@@ -0,0 +1,115 @@
+/**
+ * @file BloomFilter.h
+ * @brief Declaration of the BloomFilter class.
+ *
+ * @details
+ * This header declares BloomFilter, a cache-line-blocked Bloom filter over
+ * int keys. The BST uses it to answer most lookups for absent keys without
+ * descending the tree.
+ *
+ * Implementation details are defined in BloomFilter.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class BloomFilter
+ * @brief Approximate set membership with one cache miss per query.
+ *
+ * @details
+ * The filter is an array of 64-byte blocks, each aligned to a cache line
+ * and viewed as eight 64-bit words. A key is hashed once: the high half of
+ * the hash selects a block, and the low half, multiplied by eight odd
+ * constants, selects one bit in each of the block's words. add() sets the
+ * eight bits and mayContain() tests them, so both touch exactly one cache
+ * line (a "split block" Bloom filter).
+ *
+ * mayContain() never returns false for a key that was added; it returns
+ * true for an absent key with a small probability that grows with the
+ * number of keys per bit: about 0.1% at 16 bits per key and 3% at 8.
+ *
+ * Bits cannot be cleared, because another key may share them. A set whose
+ * keys are removed is therefore handled by rebuilding the filter from the
+ * remaining keys; see reset().
+ */
+
+class BloomFilter {
+public:
+    /**
+     * @brief Constructs an empty filter with no storage.
+     * @details mayContain() returns true for every key until reset() is
+     *          called, so an unsized filter never hides a key.
+     */
+    BloomFilter();
+
+    /**
+     * @brief Frees the block array.
+     */
+    ~BloomFilter();
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    /**
+     * @brief Discards every key and resizes the filter.
+     * @param expectedKeys Number of keys the filter is sized for.
+     * @param bitsPerKey   Minimum bits of storage per expected key; the
+     *                     block count is rounded up to a power of two, so
+     *                     the filter may get up to twice as many.
+     */
+    void reset(std::size_t expectedKeys, unsigned int bitsPerKey);
+
+    /**
+     * @brief Releases the block array, returning to the unsized state.
+     */
+    void release();
+
+    /**
+     * @brief Adds a key.
+     * @note Does nothing on an unsized filter.
+     */
+    void add(int key);
+
+    /**
+     * @brief Tests a key.
+     * @return false if the key was definitely never added; true if it may
+     *         have been.
+     */
+    bool mayContain(int key) const;
+
+    /**
+     * @brief Returns the bytes held by the block array.
+     */
+    std::size_t memoryBytes() const;
+
+private:
+    /**
+     * @struct Block
+     * @brief One cache line of filter bits.
+     */
+    struct alignas(64) Block {
+        std::uint64_t words[8];
+    };
+
+    Block* blocks;
+    /** Number of blocks minus one; the count is a power of two. */
+    std::size_t mask;
+    std::size_t count;
+
+    /**
+     * @brief Mixes a key into 64 well-distributed bits.
+     */
+    static std::uint64_t hash(int key);
+};
+
+#endif // BLOOMFILTER_H
@@ -0,0 +1,373 @@
+/**
+ * @file CompactBST.cpp
+ * @brief Implementation of the CompactBST class.
+ *
+ * @details
+ * This file contains the array management, the balance-factor AVL insert
+ * and remove, and the linear-time balanced build used by CompactBST.
+ */
+
+#include "CompactBST.h"
+#include "BST.h"
+#include <cstring>
+
+namespace {
+
+/** Slots allocated by the first insertion into an empty tree. */
+const std::size_t kInitialSlots = 64;
+
+} // namespace
+
+CompactBST::CompactBST()
+    : nodes(nullptr), capacity(0), used(1), freeList(CompactNode::kNull),
+      root(CompactNode::kNull), count(0) {}
+
+/**
+ * The source's values are written into consecutive slots in ascending
+ * order and then linked by linkBalanced(). A source too large for 31-bit
+ * indices leaves the tree empty.
+ */
+CompactBST::CompactBST(const BST& source) : CompactBST() {
+    std::size_t n = source.size();
+    if (n == 0 || !reserve(n))
+        return;
+
+    CompactNode* slot = nodes + 1;
+    source.forEachInorder([&slot](int value) { *slot++ = CompactNode(value); });
+
+    int treeHeight;
+    used = static_cast<Index>(n + 1);
+    root = linkBalanced(1, static_cast<Index>(n), treeHeight);
+    count = n;
+}
+
+CompactBST::~CompactBST() {
+    delete[] nodes;
+}
+
+/**
+ * Descends from the root recording each visited node and the side taken,
+ * attaches a new leaf, and walks the path back up. A node whose balance
+ * becomes 0 absorbed the growth, so the walk stops there; a node at +/-1
+ * grew taller and passes the growth on to its parent; a node at +/-2 is
+ * rotated, which restores the subtree's previous height and also ends the
+ * walk.
+ */
+bool CompactBST::insert(int value) {
+    Index path[kMaxHeight];
+    bool wentRight[kMaxHeight];
+    int depth = 0;
+
+    Index n = root;
+    while (n != CompactNode::kNull) {
+        const CompactNode& current = nodes[n];
+        if (value == current.getValue())
+            return false;
+
+        bool right = value > current.getValue();
+        path[depth] = n;
+        wentRight[depth] = right;
+        depth++;
+        n = right ? current.getRight() : current.getLeft();
+    }
+
+    // May move the array; only indices are held across this call.
+    Index fresh = allocate(value);
+    if (fresh == CompactNode::kNull)
+        return false;
+    count++;
+
+    if (depth == 0) {
+        root = fresh;
+        return true;
+    }
+    relink(path[depth - 1], wentRight[depth - 1], fresh);
+
+    while (depth > 0) {
+        depth--;
+        Index x = path[depth];
+        int balance = nodes[x].getBalance() + (wentRight[depth] ? 1 : -1);
+
+        if (balance == 0) {
+            nodes[x].setBalance(0);
+            break;
+        }
+        if (balance == 1 || balance == -1) {
+            nodes[x].setBalance(balance);
+            continue;
+        }
+
+        bool shorter;
+        Index top = rebalance(x, balance, shorter);
+        relink(depth > 0 ? path[depth - 1] : CompactNode::kNull,
+               depth > 0 && wentRight[depth - 1], top);
+        break;
+    }
+
+    return true;
+}
+
+bool CompactBST::search(int value) const {
+    Index n = root;
+    while (n != CompactNode::kNull) {
+        const CompactNode& current = nodes[n];
+        if (value == current.getValue())
+            return true;
+        n = value > current.getValue() ? current.getRight() : current.getLeft();
+    }
+    return false;
+}
+
+/**
+ * A node with two children takes the value of its in-order successor,
+ * which is then unlinked instead; the unlinked node always has at most one
+ * child, which takes its place. The path is then walked back up: a node
+ * whose balance becomes +/-1 kept its height, so the walk stops; a node at
+ * 0 lost a level and passes the loss on; a node at +/-2 is rotated, and
+ * the walk continues only if the rotation lowered the subtree.
+ */
+bool CompactBST::remove(int value) {
+    Index path[kMaxHeight];
+    bool wentRight[kMaxHeight];
+    int depth = 0;
+
+    Index n = root;
+    while (n != CompactNode::kNull && nodes[n].getValue() != value) {
+        bool right = value > nodes[n].getValue();
+        path[depth] = n;
+        wentRight[depth] = right;
+        depth++;
+        n = right ? nodes[n].getRight() : nodes[n].getLeft();
+    }
+    if (n == CompactNode::kNull)
+        return false;
+
+    if (nodes[n].getLeft() != CompactNode::kNull && nodes[n].getRight() != CompactNode::kNull) {
+        Index target = n;
+        path[depth] = n;
+        wentRight[depth] = true;
+        depth++;
+        n = nodes[n].getRight();
+        while (nodes[n].getLeft() != CompactNode::kNull) {
+            path[depth] = n;
+            wentRight[depth] = false;
+            depth++;
+            n = nodes[n].getLeft();
+        }
+        nodes[target].setValue(nodes[n].getValue());
+    }
+
+    Index child = nodes[n].getLeft() != CompactNode::kNull ? nodes[n].getLeft() : nodes[n].getRight();
+    relink(depth > 0 ? path[depth - 1] : CompactNode::kNull,
+           depth > 0 && wentRight[depth - 1], child);
+    release(n);
+    count--;
+
+    while (depth > 0) {
+        depth--;
+        Index x = path[depth];
+        int balance = nodes[x].getBalance() + (wentRight[depth] ? -1 : 1);
+
+        if (balance == 1 || balance == -1) {
+            nodes[x].setBalance(balance);
+            break;
+        }
+        if (balance == 0) {
+            nodes[x].setBalance(0);
+            continue;
+        }
+
+        bool shorter;
+        Index top = rebalance(x, balance, shorter);
+        relink(depth > 0 ? path[depth - 1] : CompactNode::kNull,
+               depth > 0 && wentRight[depth - 1], top);
+        if (!shorter)
+            break;
+    }
+
+    return true;
+}
+
+std::size_t CompactBST::size() const {
+    return count;
+}
+
+/**
+ * The taller child is the one the balance factor points at; with equal
+ * subtrees either side will do.
+ */
+int CompactBST::height() const {
+    int levels = 0;
+    Index n = root;
+    while (n != CompactNode::kNull) {
+        levels++;
+        n = nodes[n].getBalance() > 0 ? nodes[n].getRight() : nodes[n].getLeft();
+    }
+    return levels;
+}
+
+bool CompactBST::reserve(std::size_t values) {
+    if (values > CompactNode::kMaxIndex)
+        return false;
+    if (values + 1 > capacity)
+        grow(values + 1);
+    return true;
+}
+
+std::size_t CompactBST::memoryBytes() const {
+    return capacity * sizeof(CompactNode);
+}
+
+CompactBST::Index CompactBST::getRoot() const {
+    return root;
+}
+
+const CompactNode& CompactBST::node(Index index) const {
+    return nodes[index];
+}
+
+/**
+ * Reuses a released slot when one is available; otherwise takes the next
+ * never-used slot, doubling the array when it is full.
+ */
+CompactBST::Index CompactBST::allocate(int value) {
+    Index index = freeList;
+    if (index != CompactNode::kNull) {
+        freeList = nodes[index].getLeft();
+    }
+    else {
+        if (used > CompactNode::kMaxIndex)
+            return CompactNode::kNull;
+        if (used >= capacity) {
+            std::size_t slots = capacity ? capacity * 2 : kInitialSlots;
+            if (slots > std::size_t(CompactNode::kMaxIndex) + 1)
+                slots = std::size_t(CompactNode::kMaxIndex) + 1;
+            grow(slots);
+        }
+        index = used++;
+    }
+
+    nodes[index] = CompactNode(value);
+    return index;
+}
+
+void CompactBST::release(Index index) {
+    nodes[index] = CompactNode(0);
+    nodes[index].setLeft(freeList);
+    freeList = index;
+}
+
+/**
+ * Only the slots handed out so far are copied; the rest of the new array
+ * is left uninitialized.
+ */
+void CompactBST::grow(std::size_t slots) {
+    CompactNode* larger = new CompactNode[slots];
+    if (nodes)
+        std::memcpy(larger, nodes, used * sizeof(CompactNode));
+    delete[] nodes;
+    nodes = larger;
+    capacity = slots;
+}
+
+void CompactBST::relink(Index parent, bool rightSide, Index child) {
+    if (parent == CompactNode::kNull)
+        root = child;
+    else if (rightSide)
+        nodes[parent].setRight(child);
+    else
+        nodes[parent].setLeft(child);
+}
+
+/**
+ * For a right-heavy x with right child y:
+ * - If y is not left-heavy, a single left rotation lifts y. The subtree
+ *   loses a level unless y was balanced, which only happens on removal.
+ * - If y is left-heavy, y's left child z is lifted over both (a
+ *   right-left double rotation), and the subtree always loses a level.
+ * The left-heavy case is the mirror image. The new balance factors follow
+ * from the old ones directly, so no heights are needed.
+ */
+CompactBST::Index CompactBST::rebalance(Index x, int balance, bool& shorter) {
+    CompactNode& top = nodes[x];
+
+    if (balance > 0) {
+        Index y = top.getRight();
+        CompactNode& right = nodes[y];
+        int yBalance = right.getBalance();
+
+        if (yBalance >= 0) {
+            top.setRight(right.getLeft());
+            right.setLeft(x);
+            top.setBalance(1 - yBalance);
+            right.setBalance(yBalance - 1);
+            shorter = yBalance != 0;
+            return y;
+        }
+
+        Index z = right.getLeft();
+        CompactNode& middle = nodes[z];
+        int zBalance = middle.getBalance();
+        top.setRight(middle.getLeft());
+        right.setLeft(middle.getRight());
+        middle.setLeft(x);
+        middle.setRight(y);
+        top.setBalance(zBalance > 0 ? -1 : 0);
+        right.setBalance(zBalance < 0 ? 1 : 0);
+        middle.setBalance(0);
+        shorter = true;
+        return z;
+    }
+
+    Index y = top.getLeft();
+    CompactNode& left = nodes[y];
+    int yBalance = left.getBalance();
+
+    if (yBalance <= 0) {
+        top.setLeft(left.getRight());
+        left.setRight(x);
+        top.setBalance(-1 - yBalance);
+        left.setBalance(yBalance + 1);
+        shorter = yBalance != 0;
+        return y;
+    }
+
+    Index z = left.getRight();
+    CompactNode& middle = nodes[z];
+    int zBalance = middle.getBalance();
+    top.setLeft(middle.getRight());
+    left.setRight(middle.getLeft());
+    middle.setRight(x);
+    middle.setLeft(y);
+    top.setBalance(zBalance < 0 ? 1 : 0);
+    left.setBalance(zBalance > 0 ? -1 : 0);
+    middle.setBalance(0);
+    shorter = true;
+    return z;
+}
+
+/**
+ * The middle slot becomes the root and each half is linked recursively.
+ * The left half is never smaller than the right, so every balance factor
+ * is 0 or -1. Recursion depth is the height of the result.
+ */
+CompactBST::Index CompactBST::linkBalanced(Index first, Index n, int& treeHeight) {
+    if (n == 0) {
+        treeHeight = 0;
+        return CompactNode::kNull;
+    }
+
+    Index half = n / 2;
+    Index middle = first + half;
+    int leftHeight;
+    int rightHeight;
+    Index left = linkBalanced(first, half, leftHeight);
+    Index right = linkBalanced(middle + 1, n - half - 1, rightHeight);
+
+    CompactNode& m = nodes[middle];
+    m.setLeft(left);
+    m.setRight(right);
+    m.setBalance(rightHeight - leftHeight);
+    treeHeight = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    return middle;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file CompactBST.h
+ * @brief Declaration of the CompactBST class.
+ *
+ * @details
+ * This header declares CompactBST, a memory-dense AVL tree of integers. Its
+ * nodes are 12-byte CompactNode records stored in one contiguous array and
+ * linked by 32-bit indices, against the 24-byte, pointer-linked Node of the
+ * BST (32 bytes with BST_ORDER_STATISTICS), so the same memory (and each
+ * cache level) holds two to nearly three times as many keys.
+ *
+ * Implementation details are defined in CompactBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef COMPACTBST_H
+#define COMPACTBST_H
+
+#include <cstddef>
+#include "CompactNode.h"
+
+class BST;
+
+/**
+ * @class CompactBST
+ * @brief AVL-balanced set of ints stored as an array of 12-byte nodes.
+ *
+ * @details
+ * All nodes live in a single array owned by the tree. Children are named
+ * by their position in the array, so a link costs 4 bytes instead of 8, and
+ * the AVL balance factor travels in the spare top bits of the two links
+ * (see CompactNode) instead of in a height field. Slot 0 of the array is
+ * never used, which lets index 0 stand for "no child".
+ *
+ * When the array is full it is reallocated at twice the size. Indices stay
+ * valid across the move, which is what makes the representation possible;
+ * reserve() avoids the moves when the final size is known. Removed nodes
+ * are threaded onto a free list through their left index and reused by
+ * later insertions.
+ *
+ * Balancing follows the classic balance-factor formulation of AVL trees:
+ * insert and remove record their root-to-leaf path in a fixed-size array,
+ * then walk back up it adjusting balance factors, rotating where a factor
+ * would reach +/-2, and stopping as soon as a subtree's height is known to
+ * be unchanged.
+ *
+ * A tree holds at most CompactNode::kMaxIndex (2^31 - 1) values. The nodes
+ * are reachable through getRoot() and node(), which offer the same
+ * accessor-style navigation as BST's Node with indices in place of
+ * pointers.
+ *
+ * Memory Management:
+ * The node array is the tree's only allocation and is released by the
+ * destructor in one step. Any insert() may move the array, so references
+ * returned by node() are invalidated by insertions.
+ *
+ * @see CompactNode
+ * @see BST
+ */
+
+class CompactBST {
+public:
+    typedef CompactNode::Index Index;
+
+    /**
+     * @brief Constructs an empty tree.
+     */
+    CompactBST();
+
+    /**
+     * @brief Builds a perfectly balanced compact copy of a BST.
+     * @param source Tree whose values are copied; it is not modified.
+     * @details Runs in linear time: the values arrive in ascending order,
+     *          so the nodes are linked directly without any rotations.
+     */
+    explicit CompactBST(const BST& source);
+
+    /**
+     * @brief Releases the node array.
+     */
+    ~CompactBST();
+
+    CompactBST(const CompactBST&) = delete;
+    CompactBST& operator=(const CompactBST&) = delete;
+
+    /**
+     * @brief Inserts a value into the tree.
+     * @param value The value to insert.
+     * @return true if the value was added; false if it was already present
+     *         or the tree already holds CompactNode::kMaxIndex values.
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Searches for a value.
+     * @return true if found, false otherwise.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Removes a value from the tree if it exists.
+     * @return true if the value was found and removed; otherwise false.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Returns the number of values in the tree.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Returns the number of levels in the tree (0 if empty).
+     * @details Follows the taller child at every level, in O(height).
+     */
+    int height() const;
+
+    /**
+     * @brief Makes room for at least count values without further reallocation.
+     * @return false if count exceeds CompactNode::kMaxIndex.
+     */
+    bool reserve(std::size_t count);
+
+    /**
+     * @brief Returns the bytes held by the node array, including free slots.
+     */
+    std::size_t memoryBytes() const;
+
+    /**
+     * @brief Returns the index of the root node, or CompactNode::kNull if empty.
+     */
+    Index getRoot() const;
+
+    /**
+     * @brief Returns the node stored at an index.
+     * @param index A non-null index obtained from getRoot() or a node's
+     *              getLeft() / getRight().
+     */
+    const CompactNode& node(Index index) const;
+
+    /**
+     * @brief Calls a visitor with every value in ascending order.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @details Uses a fixed-size inline stack of kMaxHeight indices, which
+     *          an AVL tree of at most 2^31 nodes can never exceed. The
+     *          visitor must not insert or remove values.
+     */
+    template <class Visitor>
+    void forEachInorder(Visitor visit) const;
+
+    /**
+     * @brief Upper bound on the height of any CompactBST.
+     * @details An AVL tree of fewer than 2^31 nodes is at most 44 levels high.
+     */
+    static const int kMaxHeight = 64;
+
+private:
+    CompactNode* nodes;  ///< Node array; nodes[0] is unused.
+    std::size_t capacity;  ///< Slots in the node array, including slot 0.
+    Index used;          ///< Slots ever handed out, including slot 0.
+    Index freeList;      ///< First released slot, linked through left indices.
+    Index root;
+    std::size_t count;
+
+    /**
+     * @brief Takes a slot for a new leaf, growing the array if needed.
+     * @return The slot's index, or kNull if the tree is full.
+     */
+    Index allocate(int value);
+
+    /**
+     * @brief Returns a slot to the free list.
+     */
+    void release(Index index);
+
+    /**
+     * @brief Reallocates the node array to hold at least slots entries.
+     */
+    void grow(std::size_t slots);
+
+    /**
+     * @brief Points the parent's child link on one side at child, or makes
+     *        child the root if parent is kNull.
+     */
+    void relink(Index parent, bool rightSide, Index child);
+
+    /**
+     * @brief Restores balance at a node whose balance factor reached +/-2.
+     * @param x       The unbalanced node.
+     * @param balance Its balance factor, 2 or -2.
+     * @param shorter Set to true if the rotated subtree ends up one level
+     *                lower than x's subtree was before the rotation.
+     * @return The index of the subtree's new root.
+     */
+    Index rebalance(Index x, int balance, bool& shorter);
+
+    /**
+     * @brief Links the consecutive slots [first, first + n) holding
+     *        ascending values into a perfectly balanced subtree.
+     * @param height Receives the subtree's height.
+     * @return The index of the subtree's root.
+     */
+    Index linkBalanced(Index first, Index n, int& height);
+};
+
+/**
+ * Iterative in-order walk over an explicit stack of indices.
+ */
+template <class Visitor>
+void CompactBST::forEachInorder(Visitor visit) const {
+    Index stack[kMaxHeight];
+    int depth = 0;
+    Index current = root;
+
+    while (current != CompactNode::kNull || depth > 0) {
+        while (current != CompactNode::kNull) {
+            stack[depth++] = current;
+            current = nodes[current].getLeft();
+        }
+
+        const CompactNode& n = nodes[stack[--depth]];
+        visit(n.getValue());
+        current = n.getRight();
+    }
+}
+
+#endif // COMPACTBST_H
@@ -0,0 +1,177 @@
+/**
+ * @file CompactNode.h
+ * @brief Declaration of the CompactNode class.
+ *
+ * @details
+ * This header declares CompactNode, the 12-byte node used by CompactBST.
+ * Instead of two 64-bit child pointers it stores two 32-bit indices into
+ * the tree's node array, and it keeps the AVL balance factor in the spare
+ * top bit of each index instead of in a separate height field.
+ *
+ * The accessors are defined inline below the class: they are a handful of
+ * mask operations on the hottest path of every CompactBST operation.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef COMPACTNODE_H
+#define COMPACTNODE_H
+
+#include <cstdint>
+
+/**
+ * @class CompactNode
+ * @brief Binary search tree node addressed by 32-bit index.
+ *
+ * @details
+ * A CompactNode holds an integer value and the indices of its left and
+ * right children within the array that owns it. Index 0 is reserved as the
+ * null index, so an absent child is stored as 0.
+ *
+ * Indices use only the low 31 bits of each child field. The top bit of the
+ * left field is set when the left subtree is one level taller than the
+ * right, and the top bit of the right field when the right subtree is
+ * taller; neither is set when the subtrees have equal height. Together the
+ * two bits encode the AVL balance factor (height(right) - height(left)) of
+ * -1, 0, or +1, so the node needs no height field. The setters for the
+ * children preserve these bits, and the balance setter preserves the
+ * indices.
+ *
+ * The class mirrors the accessor-style interface of Node (getValue(),
+ * getLeft(), getRight(), and their setters), with child indices in place
+ * of child pointers.
+ *
+ * @see CompactBST
+ * @see Node
+ */
+
+class CompactNode {
+public:
+    /** Position of a node within its tree's node array. */
+    typedef std::uint32_t Index;
+
+    /** The index that stands for "no node". */
+    static const Index kNull = 0;
+
+    /** Largest index a child field can hold. */
+    static const Index kMaxIndex = 0x7FFFFFFFu;
+
+    /**
+     * @brief Constructs an uninitialized node.
+     * @details Lets arrays of nodes be allocated without touching memory.
+     */
+    CompactNode() = default;
+
+    /**
+     * @brief Constructs a balanced leaf holding the specified value.
+     * @param value The integer value stored in the node.
+     */
+    explicit CompactNode(int value);
+
+    /**
+     * @brief Returns the stored integer value.
+     */
+    int getValue() const;
+
+    /**
+     * @brief Sets the stored integer value.
+     * @param value The new integer value to store.
+     */
+    void setValue(int value);
+
+    /**
+     * @brief Returns the index of the left child, or kNull if none exists.
+     */
+    Index getLeft() const;
+
+    /**
+     * @brief Sets the index of the left child.
+     * @param left Index of at most kMaxIndex, or kNull.
+     */
+    void setLeft(Index left);
+
+    /**
+     * @brief Returns the index of the right child, or kNull if none exists.
+     */
+    Index getRight() const;
+
+    /**
+     * @brief Sets the index of the right child.
+     * @param right Index of at most kMaxIndex, or kNull.
+     */
+    void setRight(Index right);
+
+    /**
+     * @brief Returns the balance factor: height(right) - height(left).
+     * @return -1, 0, or +1.
+     */
+    int getBalance() const;
+
+    /**
+     * @brief Sets the balance factor.
+     * @param balance -1, 0, or +1.
+     */
+    void setBalance(int balance);
+
+private:
+    static const std::uint32_t kTallerBit = 0x80000000u;
+
+    int value;
+    std::uint32_t left;
+    std::uint32_t right;
+};
+
+static_assert(sizeof(CompactNode) == 12, "CompactNode must stay 12 bytes");
+
+/**
+ * A new node is a leaf, so both subtrees are empty and equally tall.
+ */
+inline CompactNode::CompactNode(int v) : value(v), left(kNull), right(kNull) {}
+
+inline int CompactNode::getValue() const {
+    return value;
+}
+
+inline void CompactNode::setValue(int v) {
+    value = v;
+}
+
+inline CompactNode::Index CompactNode::getLeft() const {
+    return left & kMaxIndex;
+}
+
+/**
+ * Replaces the index bits and keeps the left-taller bit.
+ */
+inline void CompactNode::setLeft(Index l) {
+    left = (left & kTallerBit) | l;
+}
+
+inline CompactNode::Index CompactNode::getRight() const {
+    return right & kMaxIndex;
+}
+
+/**
+ * Replaces the index bits and keeps the right-taller bit.
+ */
+inline void CompactNode::setRight(Index r) {
+    right = (right & kTallerBit) | r;
+}
+
+/**
+ * At most one of the two taller bits is ever set.
+ */
+inline int CompactNode::getBalance() const {
+    return static_cast<int>(right >> 31) - static_cast<int>(left >> 31);
+}
+
+inline void CompactNode::setBalance(int balance) {
+    left = (left & kMaxIndex) | (balance < 0 ? kTallerBit : 0u);
+    right = (right & kMaxIndex) | (balance > 0 ? kTallerBit : 0u);
+}
+
+#endif // COMPACTNODE_H
@@ -0,0 +1,354 @@
+/**
+ * @file ConcurrentBST.cpp
+ * @brief Implementation of the ConcurrentBST class.
+ *
+ * @details
+ * This file contains the optimistic lock coupling protocol. Every public
+ * operation runs inside an epoch critical region and repeats a single
+ * attempt until it completes. An attempt walks down from the sentinel,
+ * validating each node's version after reading its fields and before
+ * trusting the child pointer it read. Any failed validation or lock upgrade
+ * abandons the attempt; no attempt ever waits for a lock.
+ *
+ * The version word is laid out as counter << 2 | kLocked | kObsolete.
+ * Adding kLocked to a locked version clears the lock bit and carries into
+ * the counter, so unlock() is a single atomic add.
+ */
+
+#include "ConcurrentBST.h"
+#include <thread>
+
+namespace {
+
+/**
+ * Number of failed attempts after which an operation yields its time slice.
+ */
+const unsigned int kSpinsBeforeYield = 8;
+
+/**
+ * Called after each failed attempt; yields periodically so that a
+ * preempted lock holder can make progress.
+ */
+inline void backoff(unsigned int& attempts) {
+    if (++attempts % kSpinsBeforeYield == 0)
+        std::this_thread::yield();
+}
+
+} // namespace
+
+/**
+ * The sentinel's value is never compared; the root hangs off its left link.
+ */
+ConcurrentBST::ConcurrentBST() : head(0), nodeCount(0) {}
+
+/**
+ * Frees every node by rotating left children up until each node has no
+ * left child, which visits the tree in O(n) time and O(1) space.
+ */
+ConcurrentBST::~ConcurrentBST() {
+    CNode* current = head.left.load(std::memory_order_relaxed);
+
+    while (current) {
+        CNode* left = current->left.load(std::memory_order_relaxed);
+        if (left) {
+            current->left.store(left->right.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            left->right.store(current, std::memory_order_relaxed);
+            current = left;
+        }
+        else {
+            CNode* right = current->right.load(std::memory_order_relaxed);
+            delete current;
+            current = right;
+        }
+    }
+}
+
+/**
+ * Repeats tryInsert() until it succeeds or finds the value. The new node is
+ * allocated outside any lock and freed if it was never linked.
+ */
+bool ConcurrentBST::insert(int value) {
+    EpochReclaimer::Guard guard(reclaimer);
+    CNode* leaf = nullptr;
+    unsigned int attempts = 0;
+
+    int result;
+    while ((result = tryInsert(value, leaf)) < 0)
+        backoff(attempts);
+
+    if (result == 0)
+        delete leaf;
+    return result == 1;
+}
+
+/**
+ * Repeats trySearch() until an attempt validates.
+ */
+bool ConcurrentBST::search(int value) const {
+    EpochReclaimer::Guard guard(reclaimer);
+    unsigned int attempts = 0;
+
+    int result;
+    while ((result = trySearch(value)) < 0)
+        backoff(attempts);
+
+    return result == 1;
+}
+
+/**
+ * Repeats tryRemove() until it removes the value or finds it absent.
+ */
+bool ConcurrentBST::remove(int value) {
+    EpochReclaimer::Guard guard(reclaimer);
+    unsigned int attempts = 0;
+
+    int result;
+    while ((result = tryRemove(value)) < 0)
+        backoff(attempts);
+
+    return result == 1;
+}
+
+std::size_t ConcurrentBST::size() const {
+    return nodeCount.load(std::memory_order_relaxed);
+}
+
+bool ConcurrentBST::readLock(const CNode* node, std::uint64_t& version) {
+    version = node->version.load(std::memory_order_acquire);
+    return (version & (kLocked | kObsolete)) == 0;
+}
+
+/**
+ * The acquire fence keeps the field reads made since readLock() from being
+ * reordered after the version re-check.
+ */
+bool ConcurrentBST::validate(const CNode* node, std::uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->version.load(std::memory_order_relaxed) == version;
+}
+
+bool ConcurrentBST::upgrade(CNode* node, std::uint64_t version) {
+    return node->version.compare_exchange_strong(version, version + kLocked);
+}
+
+void ConcurrentBST::unlock(CNode* node) {
+    node->version.fetch_add(kLocked, std::memory_order_release);
+}
+
+void ConcurrentBST::unlockObsolete(CNode* node) {
+    node->version.fetch_add(kLocked | kObsolete, std::memory_order_release);
+}
+
+/**
+ * The caller holds parent's lock, so its value cannot change underneath.
+ */
+std::atomic<ConcurrentBST::CNode*>& ConcurrentBST::childFor(CNode* parent, int value) {
+    if (parent == &head || value < parent->value.load(std::memory_order_relaxed))
+        return parent->left;
+    return parent->right;
+}
+
+/**
+ * Walks down keeping the last validated parent and its version. On reaching
+ * an empty link, locking the parent from that version proves the link is
+ * still empty, so the new leaf can be stored into it.
+ */
+int ConcurrentBST::tryInsert(int value, CNode*& leaf) {
+    CNode* parent = &head;
+    std::uint64_t parentVersion;
+    if (!readLock(parent, parentVersion))
+        return -1;
+
+    CNode* current = head.left.load(std::memory_order_acquire);
+
+    while (current) {
+        std::uint64_t version;
+        if (!readLock(current, version) || !validate(parent, parentVersion))
+            return -1;
+
+        int key = current->value.load(std::memory_order_relaxed);
+        if (value == key)
+            return validate(current, version) ? 0 : -1;
+
+        CNode* next = (value < key ? current->left : current->right).load(std::memory_order_acquire);
+        if (!validate(current, version))
+            return -1;
+
+        parent = current;
+        parentVersion = version;
+        current = next;
+    }
+
+    if (!leaf)
+        leaf = new CNode(value);
+
+    if (!upgrade(parent, parentVersion))
+        return -1;
+
+    childFor(parent, value).store(leaf, std::memory_order_release);
+    unlock(parent);
+    nodeCount.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+/**
+ * Pure reads: a node's value and child link are trusted only after its
+ * version is confirmed unchanged. A node unlinked while the search was on
+ * its way down is obsolete, so the search restarts instead of wandering
+ * through a detached subtree.
+ */
+int ConcurrentBST::trySearch(int value) const {
+    std::uint64_t headVersion;
+    if (!readLock(&head, headVersion))
+        return -1;
+
+    const CNode* current = head.left.load(std::memory_order_acquire);
+    if (!validate(&head, headVersion))
+        return -1;
+
+    while (current) {
+        std::uint64_t version;
+        if (!readLock(current, version))
+            return -1;
+
+        int key = current->value.load(std::memory_order_relaxed);
+        if (value == key)
+            return validate(current, version) ? 1 : -1;
+
+        const CNode* next = (value < key ? current->left : current->right).load(std::memory_order_acquire);
+        if (!validate(current, version))
+            return -1;
+
+        current = next;
+    }
+
+    return 0;
+}
+
+/**
+ * Finds the node holding value together with its parent, both with
+ * validated versions. A node with at most one child is unlinked by locking
+ * the parent and the node and pointing the parent at the remaining child.
+ * A node with two children stays in place and takes over its successor's
+ * value; see removeWithSuccessor().
+ */
+int ConcurrentBST::tryRemove(int value) {
+    CNode* parent = &head;
+    std::uint64_t parentVersion;
+    if (!readLock(parent, parentVersion))
+        return -1;
+
+    CNode* current = head.left.load(std::memory_order_acquire);
+    std::uint64_t version = 0;
+
+    for (;;) {
+        if (!current)
+            return validate(parent, parentVersion) ? 0 : -1;
+
+        if (!readLock(current, version) || !validate(parent, parentVersion))
+            return -1;
+
+        int key = current->value.load(std::memory_order_relaxed);
+        if (value == key)
+            break;
+
+        CNode* next = (value < key ? current->left : current->right).load(std::memory_order_acquire);
+        if (!validate(current, version))
+            return -1;
+
+        parent = current;
+        parentVersion = version;
+        current = next;
+    }
+
+    CNode* left = current->left.load(std::memory_order_acquire);
+    CNode* right = current->right.load(std::memory_order_acquire);
+
+    if (left && right) {
+        if (!upgrade(current, version))
+            return -1;
+        if (!removeWithSuccessor(current)) {
+            unlock(current);
+            return -1;
+        }
+        return 1;
+    }
+
+    if (!upgrade(parent, parentVersion))
+        return -1;
+    if (!upgrade(current, version)) {
+        unlock(parent);
+        return -1;
+    }
+
+    childFor(parent, value).store(left ? left : right, std::memory_order_release);
+    unlock(parent);
+    unlockObsolete(current);
+
+    reclaimer.retire(current);
+    nodeCount.fetch_sub(1, std::memory_order_relaxed);
+    return 1;
+}
+
+/**
+ * The two-children case. With node locked its right link is stable, so the
+ * walk to the leftmost node of the right subtree starts from a fixed point.
+ * Locking the successor from its validated version proves it still has no
+ * left child, and locking the successor's parent proves the successor is
+ * still linked beneath it. The successor's value is then copied into node
+ * and the successor unlinked. Readers inside node see its version change;
+ * readers that had already moved past it towards the successor find the
+ * successor obsolete. Either way they restart and see the new value in node.
+ */
+bool ConcurrentBST::removeWithSuccessor(CNode* node) {
+    CNode* successorParent = node;
+    std::uint64_t successorParentVersion = 0;
+    CNode* successor = node->right.load(std::memory_order_acquire);
+    std::uint64_t version;
+    if (!readLock(successor, version))
+        return false;
+
+    for (;;) {
+        CNode* next = successor->left.load(std::memory_order_acquire);
+        if (!validate(successor, version))
+            return false;
+        if (!next)
+            break;
+
+        std::uint64_t nextVersion;
+        if (!readLock(next, nextVersion))
+            return false;
+
+        successorParent = successor;
+        successorParentVersion = version;
+        successor = next;
+        version = nextVersion;
+    }
+
+    bool separateParent = successorParent != node;
+    if (separateParent && !upgrade(successorParent, successorParentVersion))
+        return false;
+    if (!upgrade(successor, version)) {
+        if (separateParent)
+            unlock(successorParent);
+        return false;
+    }
+
+    CNode* successorRight = successor->right.load(std::memory_order_relaxed);
+    node->value.store(successor->value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    if (separateParent) {
+        successorParent->left.store(successorRight, std::memory_order_release);
+        unlock(successorParent);
+    }
+    else {
+        node->right.store(successorRight, std::memory_order_release);
+    }
+
+    unlockObsolete(successor);
+    unlock(node);
+
+    reclaimer.retire(successor);
+    nodeCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
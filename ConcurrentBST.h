@@ -0,0 +1,196 @@
+/**
+ * @file ConcurrentBST.h
+ * @brief Declaration of the ConcurrentBST class.
+ *
+ * @details
+ * This header declares ConcurrentBST, a thread-safe binary search tree of
+ * integers that many threads may search, insert into, and remove from at the
+ * same time without a global lock. Synchronization uses optimistic lock
+ * coupling: every node carries a version counter that doubles as a write
+ * lock. Readers never write shared memory; they read a node's version,
+ * read its fields, and then check that the version has not changed.
+ * Writers lock only the nodes they modify.
+ *
+ * Implementation details are defined in ConcurrentBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef CONCURRENTBST_H
+#define CONCURRENTBST_H
+
+#include "EpochReclaimer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ConcurrentBST
+ * @brief Unbalanced BST that is safe for concurrent readers and writers.
+ *
+ * @details
+ * Each node's version word holds a lock bit and an obsolete bit below a
+ * change counter. A writer acquires a node's lock by compare-and-swap from
+ * the exact version it read while traversing, so the lock succeeds only if
+ * the node is unchanged since it was examined; otherwise the operation
+ * restarts from the root. Releasing the lock increments the counter, which
+ * invalidates every optimistic reader that saw the old version. A node
+ * unlinked from the tree is marked obsolete so that readers already holding
+ * a pointer to it restart instead of following stale links.
+ *
+ * The locks taken by each operation:
+ * - search() takes none.
+ * - insert() locks the parent of the new leaf.
+ * - remove() of a node with at most one child locks the node and its parent.
+ * - remove() of a node with two children locks the node, whose value is
+ *   overwritten by its in-order successor's, the successor, and the
+ *   successor's parent, from which the successor is unlinked. Readers that
+ *   were between these nodes observe a version change and retry.
+ *
+ * Because a lock is only ever taken by compare-and-swap, no thread ever
+ * waits while holding a lock and the scheme cannot deadlock. Removed nodes
+ * are handed to an EpochReclaimer and freed once no reader can reach them.
+ *
+ * The tree does not rebalance: rotations would move many nodes under
+ * concurrent readers. Insertion order should therefore be reasonably random.
+ * The traversal operations of BST are not provided, since a consistent
+ * snapshot cannot be taken without stopping writers.
+ */
+
+class ConcurrentBST {
+public:
+    /**
+     * @brief Constructs an empty tree.
+     */
+    ConcurrentBST();
+
+    /**
+     * @brief Frees every node.
+     * @note No other thread may be using the tree.
+     */
+    ~ConcurrentBST();
+
+    ConcurrentBST(const ConcurrentBST&) = delete;
+    ConcurrentBST& operator=(const ConcurrentBST&) = delete;
+
+    /**
+     * @brief Inserts a value into the tree.
+     * @param value The integer value to insert.
+     * @return true if inserted, false if the value was already present.
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Searches for a value in the tree without taking any lock.
+     * @param value The value to search for.
+     * @return true if found, false otherwise.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Removes a value from the tree.
+     * @param value The value to remove.
+     * @return true if the value was found and removed, false otherwise.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Returns the number of values in the tree.
+     * @note Exact when no writer is active; otherwise a recent count.
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @struct CNode
+     * @brief A tree node with a version lock.
+     *
+     * @details
+     * The value is atomic because remove() may overwrite it while readers
+     * are comparing against it; such readers always fail validation.
+     */
+    struct CNode {
+        std::atomic<std::uint64_t> version;
+        std::atomic<int> value;
+        std::atomic<CNode*> left;
+        std::atomic<CNode*> right;
+
+        explicit CNode(int v) : version(0), value(v), left(nullptr), right(nullptr) {}
+    };
+
+    /** Version bit set while a writer holds the node. */
+    static const std::uint64_t kLocked = 2;
+    /** Version bit set once the node has been unlinked. */
+    static const std::uint64_t kObsolete = 1;
+
+    /**
+     * @brief Sentinel above the root; the real root is its left child.
+     * @details The sentinel makes an empty tree and removing the root
+     * ordinary cases, since every real node then has a parent to lock.
+     */
+    CNode head;
+    std::atomic<std::size_t> nodeCount;
+    mutable EpochReclaimer reclaimer;
+
+    /**
+     * @brief Reads a node's version for optimistic access.
+     * @return false if the node is locked or obsolete and the caller must restart.
+     */
+    static bool readLock(const CNode* node, std::uint64_t& version);
+
+    /**
+     * @brief Checks that a node is unchanged since readLock().
+     */
+    static bool validate(const CNode* node, std::uint64_t version);
+
+    /**
+     * @brief Locks a node if it still has the given version.
+     */
+    static bool upgrade(CNode* node, std::uint64_t version);
+
+    /**
+     * @brief Releases a node's lock and publishes its changes.
+     */
+    static void unlock(CNode* node);
+
+    /**
+     * @brief Releases a node's lock and marks it unlinked.
+     */
+    static void unlockObsolete(CNode* node);
+
+    /**
+     * @brief Returns the child slot of parent that leads towards value.
+     */
+    std::atomic<CNode*>& childFor(CNode* parent, int value);
+
+    /**
+     * @brief Single optimistic attempt at insert().
+     * @param leaf Node to link in; allocated on first use and kept across attempts.
+     * @return 1 if inserted, 0 if present, -1 if the attempt must restart.
+     */
+    int tryInsert(int value, CNode*& leaf);
+
+    /**
+     * @brief Single optimistic attempt at search().
+     * @return 1 if found, 0 if absent, -1 if the attempt must restart.
+     */
+    int trySearch(int value) const;
+
+    /**
+     * @brief Single optimistic attempt at remove().
+     * @return 1 if removed, 0 if absent, -1 if the attempt must restart.
+     */
+    int tryRemove(int value);
+
+    /**
+     * @brief Unlinks a locked node with two children by moving its successor up.
+     * @return false if the successor changed and the caller must restart.
+     */
+    bool removeWithSuccessor(CNode* node);
+};
+
+#endif // CONCURRENTBST_H
@@ -0,0 +1,719 @@
+/**
+ * @file DurableBST.cpp
+ * @brief Implementation of the DurableBST class.
+ *
+ * @details
+ * This file contains the mutation path, the group-commit log thread, the
+ * checkpoint protocol, and recovery. Lock order is checkpointMutex, then
+ * flushMutex, then stateMutex; stateMutex is never held across disk I/O
+ * other than creating a log file. Outside recovery the tree is written
+ * only by publishDurable(), once the records it applies are on disk.
+ */
+
+#include "DurableBST.h"
+#include "KeyFormat.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const unsigned char kFrameMagic[4] = { 'B', 'S', 'T', 'W' };
+const std::size_t kFrameHeaderBytes = 16;
+const std::size_t kRecordBytes = 5;
+
+void storeLE32(unsigned char* out, std::uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+void storeLE64(unsigned char* out, std::uint64_t value) {
+    for (int i = 0; i < 8; i++)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+std::uint32_t loadLE32(const unsigned char* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+std::uint64_t loadLE64(const unsigned char* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+/**
+ * Retries short writes and interrupted calls until every byte is written.
+ */
+bool writeAll(int fd, const unsigned char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * Flushes a file's data to stable storage. fdatasync() skips metadata that
+ * is not needed to read the data back, such as the modification time.
+ */
+bool syncData(int fd) {
+#if defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+/**
+ * Parses a file name of the form "<prefix>.<digits>".
+ */
+bool parseGeneration(const char* name, const char* prefix, std::uint64_t& generation) {
+    std::size_t prefixLength = std::strlen(prefix);
+    if (std::strncmp(name, prefix, prefixLength) != 0 || name[prefixLength] != '.')
+        return false;
+
+    const char* digits = name + prefixLength + 1;
+    if (*digits == '\0')
+        return false;
+
+    std::uint64_t value = 0;
+    for (const char* p = digits; *p; p++) {
+        if (*p < '0' || *p > '9')
+            return false;
+        value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+    }
+    generation = value;
+    return true;
+}
+
+} // namespace
+
+DurableBST::LogBuffer::~LogBuffer() {
+    delete[] bytes;
+}
+
+/**
+ * Capacity doubles, so appending n records costs O(n) copying in total.
+ */
+void DurableBST::LogBuffer::reserve(std::size_t extra) {
+    if (used + extra <= capacity)
+        return;
+
+    std::size_t grown = capacity ? capacity * 2 : 4096;
+    while (grown < used + extra)
+        grown *= 2;
+
+    unsigned char* larger = new unsigned char[grown];
+    if (used > 0)
+        std::memcpy(larger, bytes, used);
+    delete[] bytes;
+    bytes = larger;
+    capacity = grown;
+}
+
+void DurableBST::LogBuffer::swap(LogBuffer& other) {
+    std::swap(bytes, other.bytes);
+    std::swap(used, other.used);
+    std::swap(capacity, other.capacity);
+}
+
+DurableBST::DurableBST(BalancePolicy policy)
+    : tree(new BST(policy)), policy(policy), pendingRecords(0),
+      appendedSequence(0), durableSequence(0), generation(0), oldestGeneration(0),
+      logFd(-1), logBytes(0), isOpen(false), stopping(false), hasFailed(false),
+      checkpointRequested(false) {}
+
+DurableBST::~DurableBST() {
+    close();
+    delete tree;
+}
+
+/**
+ * Recovery runs before the background threads start, so it needs no locks.
+ */
+bool DurableBST::open(const char* path, const DurabilityOptions& durability) {
+    close();
+
+    if (::mkdir(path, 0755) != 0 && errno != EEXIST)
+        return false;
+
+    directory = path;
+    options = durability;
+    delete tree;
+    tree = new BST(policy);
+    pending.used = 0;
+    pendingRecords = 0;
+    inflight.clear();
+    appendedSequence = 0;
+    durableSequence = 0;
+    logBytes = 0;
+    hasFailed = false;
+    stopping = false;
+    checkpointRequested = false;
+
+    if (!recover()) {
+        if (logFd >= 0)
+            ::close(logFd);
+        logFd = -1;
+        return false;
+    }
+
+    isOpen = true;
+    logThread = std::thread(&DurableBST::logLoop, this);
+    checkpointThread = std::thread(&DurableBST::checkpointLoop, this);
+    return true;
+}
+
+/**
+ * New mutations are refused first; the log thread then drains whatever is
+ * still pending before it exits.
+ */
+void DurableBST::close() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!isOpen)
+            return;
+        isOpen = false;
+        stopping = true;
+    }
+    logWake.notify_all();
+    checkpointWake.notify_all();
+
+    logThread.join();
+    checkpointThread.join();
+
+    ::close(logFd);
+    logFd = -1;
+}
+
+bool DurableBST::insert(int value) {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (!isOpen || hasFailed || !applyLocked(LogOp::Insert, value))
+        return false;
+    return !options.waitForCommit || waitDurable(lock, appendedSequence);
+}
+
+bool DurableBST::remove(int value) {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (!isOpen || hasFailed || !applyLocked(LogOp::Remove, value))
+        return false;
+    return !options.waitForCommit || waitDurable(lock, appendedSequence);
+}
+
+std::size_t DurableBST::insertBatch(const int* values, std::size_t count) {
+    return applyBatch(LogOp::Insert, values, count);
+}
+
+std::size_t DurableBST::removeBatch(const int* values, std::size_t count) {
+    return applyBatch(LogOp::Remove, values, count);
+}
+
+bool DurableBST::search(int value) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return tree->search(value);
+}
+
+std::size_t DurableBST::size() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return tree->size();
+}
+
+bool DurableBST::sync() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (hasFailed)
+        return false;
+    return waitDurable(lock, appendedSequence);
+}
+
+bool DurableBST::failed() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return hasFailed;
+}
+
+/**
+ * A value with a queued record is in the set exactly when its latest
+ * record is an insertion; any other value is as the durable tree has it.
+ * Only a mutation that flips that answer is queued, so every record stays
+ * one effective update. The log thread is woken only when a group starts;
+ * later records join the group without a notification.
+ */
+bool DurableBST::applyLocked(LogOp op, int value) {
+    const std::uint64_t* latest = inflight.find(value);
+    bool present = latest ? (*latest & 1) == static_cast<std::uint64_t>(LogOp::Insert)
+                          : tree->search(value);
+    if (present == (op == LogOp::Insert))
+        return false;
+
+    pending.reserve(kRecordBytes);
+    unsigned char* record = pending.bytes + pending.used;
+    record[0] = static_cast<unsigned char>(op);
+    storeLE32(record + 1, static_cast<std::uint32_t>(value));
+    pending.used += kRecordBytes;
+
+    appendedSequence++;
+    std::uint64_t tag = (appendedSequence << 1) | static_cast<std::uint64_t>(op);
+    std::pair<std::uint64_t*, bool> slot = inflight.emplace(value, tag);
+    if (!slot.second)
+        *slot.first = tag;
+
+    if (pendingRecords++ == 0)
+        logWake.notify_one();
+    return true;
+}
+
+bool DurableBST::waitDurable(std::unique_lock<std::mutex>& lock, std::uint64_t sequence) {
+    committed.wait(lock, [this, sequence] {
+        return durableSequence >= sequence || hasFailed;
+    });
+    return durableSequence >= sequence;
+}
+
+/**
+ * The whole batch is applied under one lock acquisition, so its records
+ * land in the same group commit unless the group fills up meanwhile.
+ */
+std::size_t DurableBST::applyBatch(LogOp op, const int* values, std::size_t count) {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (!isOpen || hasFailed)
+        return 0;
+
+    pending.reserve(count * kRecordBytes);
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (applyLocked(op, values[i]))
+            changed++;
+    }
+
+    if (changed > 0 && options.waitForCommit && !waitDurable(lock, appendedSequence))
+        return 0;
+    return changed;
+}
+
+/**
+ * The header and the records go out in two write() calls followed by one
+ * fdatasync(); a crash between them leaves a torn frame that recovery
+ * discards because its records are missing or fail the checksum.
+ */
+bool DurableBST::writeFrame(int fd, const LogBuffer& records, std::uint64_t recordCount) {
+    KeyChecksum checksum;
+    checksum.update(records.bytes, records.used);
+
+    unsigned char header[kFrameHeaderBytes];
+    std::memcpy(header, kFrameMagic, 4);
+    storeLE32(header + 4, static_cast<std::uint32_t>(recordCount));
+    storeLE64(header + 8, checksum.value());
+
+    return writeAll(fd, header, kFrameHeaderBytes) &&
+           writeAll(fd, records.bytes, records.used) &&
+           syncData(fd);
+}
+
+/**
+ * Swapping buffers under stateMutex is the only moment writers wait on the
+ * log thread; the write and fdatasync happen with the lock released, while
+ * new records fill the other buffer and form the next group.
+ */
+bool DurableBST::flushPending() {
+    std::lock_guard<std::mutex> flush(flushMutex);
+
+    std::uint64_t recordCount;
+    std::uint64_t sequence;
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (pendingRecords == 0)
+            return !hasFailed;
+        flushing.swap(pending);
+        recordCount = pendingRecords;
+        sequence = appendedSequence;
+        fd = logFd;
+        pendingRecords = 0;
+    }
+
+    std::uint64_t frameBytes = kFrameHeaderBytes + flushing.used;
+    bool ok = writeFrame(fd, flushing, recordCount);
+
+    if (!ok) {
+        flushing.used = 0;
+        std::lock_guard<std::mutex> lock(stateMutex);
+        failLocked();
+        return false;
+    }
+
+    publishDurable(sequence, frameBytes, flushing);
+    flushing.used = 0;
+    return true;
+}
+
+/**
+ * The group's records carry the consecutive sequence numbers ending at
+ * sequence. Each is applied to the tree in log order; a value's inflight
+ * entry is dropped once its latest record has been applied, and kept if a
+ * later record for it is still queued.
+ */
+void DurableBST::publishDurable(std::uint64_t sequence, std::uint64_t frameBytes,
+                                const LogBuffer& records) {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        std::uint64_t recordSequence = sequence - records.used / kRecordBytes;
+        for (std::size_t offset = 0; offset < records.used; offset += kRecordBytes) {
+            const unsigned char* record = records.bytes + offset;
+            int value = static_cast<int>(loadLE32(record + 1));
+            if (record[0] == static_cast<unsigned char>(LogOp::Insert))
+                tree->insert(value);
+            else
+                tree->remove(value);
+
+            recordSequence++;
+            const std::uint64_t* latest = inflight.find(value);
+            if (latest && (*latest >> 1) == recordSequence)
+                inflight.remove(value);
+        }
+
+        durableSequence = sequence;
+        logBytes += frameBytes;
+        if (options.checkpointBytes > 0 && logBytes >= options.checkpointBytes && !checkpointRequested) {
+            checkpointRequested = true;
+            checkpointWake.notify_one();
+        }
+    }
+    committed.notify_all();
+}
+
+/**
+ * Exits only once stopping is set and nothing is pending, so close()
+ * never loses a queued mutation.
+ */
+void DurableBST::logLoop() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    for (;;) {
+        logWake.wait(lock, [this] { return stopping || pendingRecords > 0; });
+        if (pendingRecords == 0)
+            return;
+
+        if (options.groupCommitMicros > 0 && !stopping) {
+            logWake.wait_for(lock, std::chrono::microseconds(options.groupCommitMicros),
+                             [this] { return stopping; });
+        }
+
+        lock.unlock();
+        flushPending();
+        lock.lock();
+    }
+}
+
+void DurableBST::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    for (;;) {
+        checkpointWake.wait(lock, [this] { return stopping || checkpointRequested; });
+        if (stopping)
+            return;
+        checkpointRequested = false;
+
+        lock.unlock();
+        checkpoint();
+        lock.lock();
+    }
+}
+
+/**
+ * The generation switch happens under stateMutex, so the records pending
+ * at that moment are the last of the old log; they are flushed there and
+ * applied, after which the tree holds exactly the records in logs before
+ * the new generation. Only publishDurable() writes the tree, and only
+ * under flushMutex, so holding flushMutex alone keeps the tree still while
+ * its values are copied: lookups and new mutations carry on, and just the
+ * next group commit waits for the copy. A failure after the switch but
+ * before the rename leaves the old checkpoint and both logs in place,
+ * which recovery replays correctly, so only log failures are fatal.
+ */
+bool DurableBST::checkpoint() {
+    std::lock_guard<std::mutex> serial(checkpointMutex);
+
+    std::uint64_t next;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (logFd < 0 || hasFailed)
+            return false;
+        next = generation + 1;
+    }
+
+    int nextFd = openLog(next);
+    if (nextFd < 0)
+        return false;
+
+    std::unique_lock<std::mutex> flush(flushMutex);
+    std::uint64_t recordCount;
+    std::uint64_t sequence;
+    int oldFd;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        flushing.swap(pending);
+        recordCount = pendingRecords;
+        sequence = appendedSequence;
+        pendingRecords = 0;
+
+        oldFd = logFd;
+        logFd = nextFd;
+        generation = next;
+        logBytes = 0;
+    }
+
+    bool ok = recordCount == 0 || writeFrame(oldFd, flushing, recordCount);
+    ok = (::close(oldFd) == 0) && ok;
+    ok = ok && syncDirectory();
+    if (!ok) {
+        flushing.used = 0;
+        std::lock_guard<std::mutex> lock(stateMutex);
+        failLocked();
+        return false;
+    }
+    if (recordCount > 0)
+        publishDurable(sequence, 0, flushing);
+    flushing.used = 0;
+
+    std::size_t count = tree->size();
+    int* values = new int[count ? count : 1];
+    tree->copyInorder(values);
+    flush.unlock();
+
+    bool written = writeCheckpoint(next, values, count);
+    delete[] values;
+    if (!written)
+        return false;
+
+    for (std::uint64_t g = oldestGeneration; g < next; g++) {
+        ::unlink(filePath("checkpoint", g).c_str());
+        ::unlink(filePath("wal", g).c_str());
+    }
+    oldestGeneration = next;
+    return true;
+}
+
+bool DurableBST::writeCheckpoint(std::uint64_t checkpointGeneration, const int* values,
+                                 std::size_t count) const {
+    std::string finalPath = filePath("checkpoint", checkpointGeneration);
+    std::string tempPath = filePath("checkpoint", checkpointGeneration, ".tmp");
+
+    std::FILE* out = std::fopen(tempPath.c_str(), "wb");
+    if (!out)
+        return false;
+
+    bool ok;
+    {
+        KeyWriter writer(out, KeyEncoding::DeltaVarint);
+        for (std::size_t i = 0; i < count; i++)
+            writer.append(values[i]);
+        ok = writer.finish();
+    }
+    ok = ok && std::fflush(out) == 0 && ::fsync(fileno(out)) == 0;
+    ok = (std::fclose(out) == 0) && ok;
+
+    if (!ok || std::rename(tempPath.c_str(), finalPath.c_str()) != 0) {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    return syncDirectory();
+}
+
+/**
+ * Files are classified by name. The newest checkpoint defines the starting
+ * state; logs of its generation and later are replayed in order. Every log
+ * but the last was closed cleanly before a checkpoint began, so damage
+ * there means lost data and fails recovery, whereas a damaged tail on the
+ * last log is an interrupted group commit and is cut off.
+ */
+bool DurableBST::recover() {
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir)
+        return false;
+
+    bool haveCheckpoint = false;
+    std::uint64_t checkpointGeneration = 0;
+    std::uint64_t oldestCheckpoint = 0;
+    std::uint64_t* logs = nullptr;
+    std::size_t logCount = 0;
+    std::size_t logCapacity = 0;
+
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::uint64_t g;
+        if (parseGeneration(entry->d_name, "checkpoint", g)) {
+            if (!haveCheckpoint || g > checkpointGeneration)
+                checkpointGeneration = g;
+            if (!haveCheckpoint || g < oldestCheckpoint)
+                oldestCheckpoint = g;
+            haveCheckpoint = true;
+        } else if (parseGeneration(entry->d_name, "wal", g)) {
+            if (logCount == logCapacity) {
+                logCapacity = logCapacity ? logCapacity * 2 : 8;
+                std::uint64_t* grown = new std::uint64_t[logCapacity];
+                for (std::size_t i = 0; i < logCount; i++)
+                    grown[i] = logs[i];
+                delete[] logs;
+                logs = grown;
+            }
+            logs[logCount++] = g;
+        } else if (std::strncmp(entry->d_name, "checkpoint.", 11) == 0) {
+            // An interrupted checkpoint's temporary file.
+            ::unlink((directory + "/" + entry->d_name).c_str());
+        }
+    }
+    ::closedir(dir);
+
+    // Insertion sort: there are only a handful of logs.
+    for (std::size_t i = 1; i < logCount; i++) {
+        std::uint64_t g = logs[i];
+        std::size_t j = i;
+        for (; j > 0 && logs[j - 1] > g; j--)
+            logs[j] = logs[j - 1];
+        logs[j] = g;
+    }
+
+    bool ok = true;
+    if (haveCheckpoint) {
+        ok = tree->load(filePath("checkpoint", checkpointGeneration).c_str());
+        // Superseded checkpoints left behind by a crash during cleanup.
+        for (std::uint64_t g = oldestCheckpoint; ok && g < checkpointGeneration; g++)
+            ::unlink(filePath("checkpoint", g).c_str());
+    }
+
+    std::uint64_t first = haveCheckpoint ? checkpointGeneration : (logCount ? logs[0] : 0);
+    std::uint64_t last = first;
+    std::uint64_t validBytes = 0;
+    std::uint64_t fileBytes = 0;
+
+    for (std::size_t i = 0; ok && i < logCount; i++) {
+        std::string path = filePath("wal", logs[i]);
+        if (logs[i] < first) {
+            ::unlink(path.c_str());
+            continue;
+        }
+
+        // Damage in a log that is not the newest.
+        if (validBytes != fileBytes) {
+            ok = false;
+            break;
+        }
+
+        ok = replayLog(path.c_str(), validBytes, fileBytes);
+        last = logs[i];
+    }
+    delete[] logs;
+
+    if (!ok)
+        return false;
+
+    if (validBytes != fileBytes &&
+        ::truncate(filePath("wal", last).c_str(), static_cast<off_t>(validBytes)) != 0)
+        return false;
+
+    generation = last;
+    oldestGeneration = first;
+    logBytes = validBytes;
+    logFd = openLog(generation);
+    if (logFd < 0)
+        return false;
+    return syncData(logFd) && syncDirectory();
+}
+
+/**
+ * A frame is applied only once it is complete and its checksum matches,
+ * so a group is replayed entirely or not at all.
+ */
+bool DurableBST::replayLog(const char* path, std::uint64_t& validBytes, std::uint64_t& fileBytes) {
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+
+    const unsigned char* data = file.data();
+    std::size_t size = file.size();
+    fileBytes = size;
+    std::size_t offset = 0;
+
+    while (size - offset >= kFrameHeaderBytes) {
+        const unsigned char* header = data + offset;
+        if (std::memcmp(header, kFrameMagic, 4) != 0)
+            break;
+
+        std::uint64_t recordCount = loadLE32(header + 4);
+        std::uint64_t recordBytes = recordCount * kRecordBytes;
+        if (recordBytes > size - offset - kFrameHeaderBytes)
+            break;
+
+        const unsigned char* records = header + kFrameHeaderBytes;
+        KeyChecksum checksum;
+        checksum.update(records, static_cast<std::size_t>(recordBytes));
+        if (checksum.value() != loadLE64(header + 8))
+            break;
+
+        bool known = true;
+        for (std::uint64_t i = 0; known && i < recordCount; i++)
+            known = records[i * kRecordBytes] <= static_cast<unsigned char>(LogOp::Remove);
+        if (!known)
+            break;
+
+        for (std::uint64_t i = 0; i < recordCount; i++) {
+            const unsigned char* record = records + i * kRecordBytes;
+            int value = static_cast<int>(loadLE32(record + 1));
+            if (record[0] == static_cast<unsigned char>(LogOp::Insert))
+                tree->insert(value);
+            else
+                tree->remove(value);
+        }
+        offset += kFrameHeaderBytes + static_cast<std::size_t>(recordBytes);
+    }
+
+    validBytes = offset;
+    return true;
+}
+
+int DurableBST::openLog(std::uint64_t logGeneration) const {
+    return ::open(filePath("wal", logGeneration).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+}
+
+std::string DurableBST::filePath(const char* name, std::uint64_t fileGeneration,
+                                 const char* suffix) const {
+    char tail[64];
+    std::snprintf(tail, sizeof(tail), "/%s.%llu%s", name,
+                  static_cast<unsigned long long>(fileGeneration), suffix);
+    return directory + tail;
+}
+
+bool DurableBST::syncDirectory() const {
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+/**
+ * Queued records can no longer reach the disk, so they are dropped; the
+ * tree never saw them, and their callers' waits now fail.
+ */
+void DurableBST::failLocked() {
+    hasFailed = true;
+    pending.used = 0;
+    pendingRecords = 0;
+    inflight.clear();
+    committed.notify_all();
+}
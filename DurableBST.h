@@ -0,0 +1,373 @@
+/**
+ * @file DurableBST.h
+ * @brief Declaration of the DurableBST class.
+ *
+ * @details
+ * This header declares DurableBST, a BST whose mutations survive crashes.
+ * Every insert and remove that changes the tree is appended to a write-ahead
+ * log that a background thread flushes to disk with group commit, so one
+ * fsync makes a whole batch of mutations durable. A second background
+ * thread periodically writes a checkpoint of the whole tree and discards the
+ * log it covers, which keeps recovery time bounded.
+ *
+ * Implementation details are defined in DurableBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef DURABLEBST_H
+#define DURABLEBST_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "BST.h"
+#include "BSTMap.h"
+
+/**
+ * @struct DurabilityOptions
+ * @brief Tuning knobs for DurableBST.
+ */
+struct DurabilityOptions {
+    /**
+     * If true, insert() and remove() return only once their log record is
+     * on disk. If false they return as soon as the record is queued, and
+     * sync() waits for everything queued so far; a crash can then lose the
+     * mutations of the last group commit or two, but never reorders them.
+     * Either way a mutation becomes visible to search() only once its
+     * record is durable.
+     */
+    bool waitForCommit = true;
+
+    /**
+     * How long the log thread lingers after the first record of a group
+     * arrives, letting more records join it. 0 flushes as soon as the
+     * previous fsync finishes, which already batches everything that
+     * arrived while it ran.
+     */
+    unsigned int groupCommitMicros = 0;
+
+    /**
+     * Log size that triggers a background checkpoint. Replay cost is
+     * proportional to the log, so this bounds recovery time. 0 disables
+     * automatic checkpoints.
+     */
+    std::uint64_t checkpointBytes = 16u << 20;
+};
+
+/**
+ * @class DurableBST
+ * @brief Crash-safe set of ints backed by a BST, a write-ahead log, and checkpoints.
+ *
+ * @details
+ * All state lives in one directory, in files tagged with a generation
+ * number g:
+ * - `checkpoint.g` is a key file (see KeyFormat.h) holding the whole tree
+ *   as of the start of generation g.
+ * - `wal.g` is the log of mutations made during generation g.
+ *
+ * The log is a sequence of frames. Each frame is one group commit: a
+ * 16-byte header (magic "BSTW", record count, checksum of the records)
+ * followed by 5-byte records (an opcode byte and a little-endian key).
+ * Only mutations that changed the tree are logged, so every replayed
+ * record is exactly one effective tree update.
+ *
+ * The in-memory tree only ever holds durable state. A mutation is first
+ * checked against the tree and the records already queued ahead of it,
+ * then appended to an in-memory log buffer under one lock, so the log
+ * order is the order the mutations were decided in. The log thread swaps
+ * the buffer out, writes it as one frame with a single write(), calls
+ * fdatasync(), and only then applies the frame's records to the tree and
+ * wakes every caller whose record that frame contained. If the write
+ * fails, the queued records are discarded with the tree untouched, and
+ * their callers see false.
+ *
+ * A checkpoint switches appends to `wal.(g+1)` under the lock, makes
+ * `wal.g` durable, and applies it, after which the tree holds exactly the
+ * state the new generation starts from. The values are copied while the
+ * log is held back but without the lock, so lookups and new mutations
+ * carry on; the checkpoint then writes `checkpoint.(g+1).tmp`, fsyncs it,
+ * renames it into place, and deletes the files of generation g. A crash
+ * at any point leaves either the old checkpoint with both logs or the new
+ * checkpoint with the new log, and both replay to the same tree.
+ *
+ * open() performs recovery: it loads the newest checkpoint, replays every
+ * later log in generation order, stops at the first torn or corrupt frame,
+ * and truncates the last log there before appending to it.
+ *
+ * Lookups take the same lock as mutations; this class is about durability,
+ * not read scalability.
+ *
+ * @note Requires a POSIX system for fdatasync() and directory syncing.
+ */
+class DurableBST {
+public:
+    /**
+     * @brief Constructs a closed container.
+     * @param policy Balancing policy of the in-memory tree.
+     */
+    explicit DurableBST(BalancePolicy policy = BalancePolicy::AVL);
+
+    /**
+     * @brief Flushes the log and stops the background threads; see close().
+     */
+    ~DurableBST();
+
+    DurableBST(const DurableBST&) = delete;
+    DurableBST& operator=(const DurableBST&) = delete;
+
+    /**
+     * @brief Opens (creating if necessary) a directory and recovers its contents.
+     * @param directory Directory holding the checkpoint and log files; it
+     *                  must exist or be creatable.
+     * @param options   Commit and checkpoint tuning.
+     * @return false if the directory cannot be used, the newest checkpoint
+     *         cannot be loaded, or a log cannot be read or repaired.
+     */
+    bool open(const char* directory, const DurabilityOptions& options = DurabilityOptions());
+
+    /**
+     * @brief Makes every queued mutation durable and stops the background threads.
+     * @details The files are left as they are; the next open() replays the
+     *          log. Does nothing if the container is not open.
+     */
+    void close();
+
+    /**
+     * @brief Inserts a value and logs the insertion.
+     * @return true if the value was new, false if it was already present or
+     *         the container is closed or has failed.
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Removes a value and logs the removal.
+     * @return true if the value was present and removed, false otherwise or
+     *         if the container is closed or has failed.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Inserts many values as part of one commit.
+     * @return The number of values that were new.
+     * @details Waits once, for the last record, when waitForCommit is set.
+     */
+    std::size_t insertBatch(const int* values, std::size_t count);
+
+    /**
+     * @brief Removes many values as part of one commit.
+     * @return The number of values that were present and removed.
+     */
+    std::size_t removeBatch(const int* values, std::size_t count);
+
+    /**
+     * @brief Searches the in-memory tree.
+     * @return true if the value is present as of the last durable commit;
+     *         a mutation still waiting for its commit is not reflected.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Returns the number of values as of the last durable commit.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Waits until every mutation made so far is on disk.
+     * @return false if the log could not be written.
+     */
+    bool sync();
+
+    /**
+     * @brief Writes a checkpoint now and discards the log it covers.
+     * @return false if the checkpoint or the new log could not be written.
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Returns true once a log or checkpoint write has failed.
+     * @details A failed container rejects further mutations, because they
+     *          could no longer be made durable.
+     */
+    bool failed() const;
+
+    /**
+     * @brief Calls a visitor with every value in ascending order.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @details Visits the durable state; mutations are blocked for the
+     *          duration of the walk.
+     */
+    template <class Visitor>
+    void forEachInorder(Visitor visit) const;
+
+private:
+    /**
+     * @struct LogBuffer
+     * @brief Growable byte array that log records are encoded into.
+     */
+    struct LogBuffer {
+        unsigned char* bytes = nullptr;
+        std::size_t used = 0;
+        std::size_t capacity = 0;
+
+        ~LogBuffer();
+        void reserve(std::size_t extra);
+        void swap(LogBuffer& other);
+    };
+
+    enum class LogOp : unsigned char {
+        Insert = 0,
+        Remove = 1
+    };
+
+    BST* tree;
+    BalancePolicy policy;
+    DurabilityOptions options;
+    std::string directory;
+
+    /**
+     * Guards the pending log buffer and the fields below it. The tree is
+     * written only while both this and flushMutex are held, so holding
+     * either one is enough to read it.
+     */
+    mutable std::mutex stateMutex;
+    /** Held by whoever is writing to the log file, so its descriptor stays valid. */
+    std::mutex flushMutex;
+    /** Serializes checkpoints, so only one of them advances the generation. */
+    std::mutex checkpointMutex;
+    std::condition_variable logWake;
+    std::condition_variable committed;
+    std::condition_variable checkpointWake;
+
+    LogBuffer pending;
+    /** The group being written; guarded by flushMutex. */
+    LogBuffer flushing;
+    std::uint64_t pendingRecords;
+    /** Sequence number of the last record appended, and of the last one on disk. */
+    std::uint64_t appendedSequence;
+    std::uint64_t durableSequence;
+    std::uint64_t generation;
+    /** Oldest generation that may still have files on disk. */
+    std::uint64_t oldestGeneration;
+    int logFd;
+    std::uint64_t logBytes;
+    bool isOpen;
+    bool stopping;
+    bool hasFailed;
+    bool checkpointRequested;
+
+    /**
+     * Values with a queued but not yet durable record, each mapped to
+     * (sequence << 1) | op of its latest record; guarded by stateMutex.
+     * Together with the tree it gives the state the next mutation is
+     * decided against.
+     */
+    BSTMap<int, std::uint64_t> inflight;
+
+    std::thread logThread;
+    std::thread checkpointThread;
+
+    /**
+     * @brief Queues the record of one mutation, if it changes the set.
+     * @note The caller must hold stateMutex.
+     * @return true if the mutation is effective against the durable tree
+     *         and the records queued before it.
+     */
+    bool applyLocked(LogOp op, int value);
+
+    /**
+     * @brief Blocks until the record with the given sequence number is durable.
+     * @return false if the log failed first.
+     */
+    bool waitDurable(std::unique_lock<std::mutex>& lock, std::uint64_t sequence);
+
+    /**
+     * @brief Shared body of insertBatch() and removeBatch().
+     */
+    std::size_t applyBatch(LogOp op, const int* values, std::size_t count);
+
+    /**
+     * @brief Writes one buffer as a frame to the log and makes it durable.
+     * @note The caller must hold flushMutex.
+     */
+    static bool writeFrame(int fd, const LogBuffer& records, std::uint64_t recordCount);
+
+    /**
+     * @brief Applies a durable group to the tree, marks every record up to
+     *        sequence durable, and wakes the waiters.
+     * @param sequence   Sequence number of the group's last record.
+     * @param frameBytes Bytes the frame added to the current log.
+     * @param records    The group's records.
+     * @note The caller must hold flushMutex.
+     */
+    void publishDurable(std::uint64_t sequence, std::uint64_t frameBytes,
+                        const LogBuffer& records);
+
+    /**
+     * @brief Writes checkpoint.(checkpointGeneration) from sorted values.
+     * @details The file is written under a temporary name, synced, and
+     *          renamed into place, so it is either complete or absent.
+     */
+    bool writeCheckpoint(std::uint64_t checkpointGeneration, const int* values,
+                         std::size_t count) const;
+
+    /**
+     * @brief Swaps out the pending records, writes them, and publishes their durability.
+     * @return false if the write failed.
+     */
+    bool flushPending();
+
+    void logLoop();
+    void checkpointLoop();
+
+    /**
+     * @brief Loads the newest checkpoint and replays the logs after it.
+     */
+    bool recover();
+
+    /**
+     * @brief Applies every intact frame of one log file to the tree.
+     * @param validBytes Receives the length of the intact prefix.
+     * @param fileBytes  Receives the length of the file.
+     * @return false if the file cannot be read.
+     */
+    bool replayLog(const char* path, std::uint64_t& validBytes, std::uint64_t& fileBytes);
+
+    /**
+     * @brief Opens a generation's log for appending, creating it if needed.
+     */
+    int openLog(std::uint64_t logGeneration) const;
+
+    /**
+     * @brief Builds "<directory>/<name>.<generation>[suffix]".
+     */
+    std::string filePath(const char* name, std::uint64_t fileGeneration,
+                         const char* suffix = "") const;
+
+    /**
+     * @brief Makes the directory's entries (new, renamed, deleted files) durable.
+     */
+    bool syncDirectory() const;
+
+    /**
+     * @brief Records a failure, discards every queued record, and wakes
+     *        every waiter.
+     * @note The caller must hold stateMutex.
+     */
+    void failLocked();
+};
+
+template <class Visitor>
+void DurableBST::forEachInorder(Visitor visit) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    tree->forEachInorder(visit);
+}
+
+#endif // DURABLEBST_H
@@ -0,0 +1,252 @@
+/**
+ * @file EpochReclaimer.cpp
+ * @brief Implementation of the EpochReclaimer class.
+ *
+ * @details
+ * This file contains the epoch-based reclamation logic and the process-wide
+ * assignment of thread slots. Announcements and the global epoch use
+ * sequentially consistent atomics, which keeps the reasoning simple: a
+ * thread's announcement is visible to every thread that later tries to
+ * advance the epoch.
+ */
+
+#include "EpochReclaimer.h"
+#include <mutex>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> slotTaken[EpochReclaimer::kMaxThreads];
+
+/**
+ * Overflow slot numbers (kMaxThreads and up). They are handed out only once
+ * every inline slot is taken, so a plain mutex is enough.
+ */
+std::mutex overflowMutex;
+std::vector<int> overflowFree;
+int overflowNext = EpochReclaimer::kMaxThreads;
+
+/**
+ * Owns the calling thread's slot number and gives it back on thread exit.
+ */
+struct ThreadSlot {
+    int index = -1;
+
+    ~ThreadSlot() {
+        if (index >= EpochReclaimer::kMaxThreads) {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            overflowFree.push_back(index);
+        }
+        else if (index >= 0) {
+            slotTaken[index].store(false);
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+/**
+ * Returns the calling thread's slot number, claiming one on first use. A
+ * free inline slot is preferred; when all are taken the thread gets a
+ * recycled or fresh overflow number rather than waiting.
+ */
+int currentSlot() {
+    if (threadSlot.index >= 0)
+        return threadSlot.index;
+
+    for (int i = 0; i < EpochReclaimer::kMaxThreads; i++) {
+        bool expected = false;
+        if (!slotTaken[i].load(std::memory_order_relaxed)
+            && slotTaken[i].compare_exchange_strong(expected, true)) {
+            threadSlot.index = i;
+            return i;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    if (overflowFree.empty()) {
+        threadSlot.index = overflowNext++;
+    }
+    else {
+        threadSlot.index = overflowFree.back();
+        overflowFree.pop_back();
+    }
+    return threadSlot.index;
+}
+
+} // namespace
+
+/**
+ * Starts at epoch 0 with every slot idle and no overflow blocks.
+ */
+EpochReclaimer::EpochReclaimer() : globalEpoch(0), pendingCount(0), overflow(nullptr) {}
+
+/**
+ * Deletes everything still pending, then the overflow blocks; no thread may
+ * be inside a region.
+ */
+EpochReclaimer::~EpochReclaimer() {
+    for (int i = 0; i < kMaxThreads; i++)
+        drain(slots[i]);
+
+    SlotBlock* block = overflow.load();
+    while (block) {
+        for (int i = 0; i < kMaxThreads; i++)
+            drain(block->slots[i]);
+        SlotBlock* next = block->next.load();
+        delete block;
+        block = next;
+    }
+}
+
+/**
+ * Announces the current global epoch. The announcement is re-checked
+ * against the global epoch so that an epoch change racing with the store
+ * cannot leave the thread announcing an epoch that has already been
+ * passed by two.
+ */
+void EpochReclaimer::enter() {
+    Slot& slot = slotFor(currentSlot());
+
+    if (slot.depth++ > 0)
+        return;
+
+    std::uint64_t epoch = globalEpoch.load();
+    for (;;) {
+        slot.announced.store(epoch);
+        std::uint64_t now = globalEpoch.load();
+        if (now == epoch)
+            break;
+        epoch = now;
+    }
+}
+
+/**
+ * Marks the thread idle once its outermost region ends.
+ */
+void EpochReclaimer::exit() {
+    Slot& slot = slotFor(currentSlot());
+
+    if (--slot.depth == 0)
+        slot.announced.store(kIdle);
+}
+
+/**
+ * Appends the object to the calling thread's retire list, tagged with the
+ * current epoch, and periodically tries to advance the epoch and free what
+ * has become safe.
+ */
+void EpochReclaimer::retire(void* object, void (*deleter)(void*)) {
+    Slot& slot = slotFor(currentSlot());
+
+    if (slot.count == slot.capacity) {
+        std::size_t grown = slot.capacity ? slot.capacity * 2 : 64;
+        Retired* items = new Retired[grown];
+        for (std::size_t i = 0; i < slot.count; i++)
+            items[i] = slot.items[i];
+        delete[] slot.items;
+        slot.items = items;
+        slot.capacity = grown;
+    }
+
+    slot.items[slot.count++] = Retired{ object, deleter, globalEpoch.load() };
+    pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (++slot.sinceScan >= kScanInterval) {
+        slot.sinceScan = 0;
+        tryAdvance();
+        reclaim(slot);
+    }
+}
+
+std::size_t EpochReclaimer::pending() const {
+    return pendingCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * The epoch moves forward only if no thread is still announcing an older
+ * one, in the inline slots or in any overflow block. A block appended after
+ * the scan passed its link belongs to a thread whose announcement follows
+ * the append, so it re-reads the global epoch in enter() and catches up.
+ */
+void EpochReclaimer::tryAdvance() {
+    std::uint64_t epoch = globalEpoch.load();
+
+    if (!caughtUp(slots, epoch))
+        return;
+    for (SlotBlock* block = overflow.load(); block; block = block->next.load()) {
+        if (!caughtUp(block->slots, epoch))
+            return;
+    }
+
+    globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+/**
+ * Inline slots are indexed directly. Overflow number n lives in block
+ * n / kMaxThreads - 1; missing blocks along the chain are allocated and
+ * published with a CAS, and a thread that loses the race frees its copy.
+ */
+EpochReclaimer::Slot& EpochReclaimer::slotFor(int index) {
+    if (index < kMaxThreads)
+        return slots[index];
+
+    int block = index / kMaxThreads - 1;
+    std::atomic<SlotBlock*>* link = &overflow;
+    for (;;) {
+        SlotBlock* current = link->load();
+        if (!current) {
+            SlotBlock* fresh = new SlotBlock();
+            if (link->compare_exchange_strong(current, fresh))
+                current = fresh;
+            else
+                delete fresh;
+        }
+        if (block-- == 0)
+            return current->slots[index % kMaxThreads];
+        link = &current->next;
+    }
+}
+
+/**
+ * A slot is caught up if it is idle or announces the current epoch.
+ */
+bool EpochReclaimer::caughtUp(const Slot* array, std::uint64_t epoch) {
+    for (int i = 0; i < kMaxThreads; i++) {
+        std::uint64_t announced = array[i].announced.load();
+        if (announced != kIdle && announced != epoch)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Used only by the destructor, so the pending count is left alone.
+ */
+void EpochReclaimer::drain(Slot& slot) {
+    for (std::size_t i = 0; i < slot.count; i++)
+        slot.items[i].deleter(slot.items[i].object);
+    delete[] slot.items;
+    slot.items = nullptr;
+    slot.count = 0;
+}
+
+/**
+ * Deletes objects retired at least two epochs ago and compacts the rest.
+ */
+void EpochReclaimer::reclaim(Slot& slot) {
+    std::uint64_t epoch = globalEpoch.load();
+    std::size_t kept = 0;
+
+    for (std::size_t i = 0; i < slot.count; i++) {
+        if (slot.items[i].epoch + 2 <= epoch) {
+            slot.items[i].deleter(slot.items[i].object);
+            pendingCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else {
+            slot.items[kept++] = slot.items[i];
+        }
+    }
+
+    slot.count = kept;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file EpochReclaimer.h
+ * @brief Declaration of the EpochReclaimer class.
+ *
+ * @details
+ * This header declares EpochReclaimer, an epoch-based safe memory
+ * reclamation scheme for the concurrent tree variants. Nodes removed from a
+ * concurrent tree may still be read by threads that found them before they
+ * were unlinked, so they cannot be deleted immediately the way BST::remove()
+ * releases a node. Instead they are retired to the reclaimer, which deletes
+ * them once every thread that could still hold a reference has moved on.
+ *
+ * Implementation details are defined in EpochReclaimer.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class EpochReclaimer
+ * @brief Epoch-based deferred deletion for lock-free and optimistic readers.
+ *
+ * @details
+ * A global epoch counter advances over time. Every operation on a
+ * concurrent structure runs inside a critical region (see Guard), on entry
+ * announcing the epoch it observed. A retired object is tagged with the
+ * epoch at which it was retired. The global epoch may only advance when
+ * every thread inside a critical region has announced the current epoch,
+ * so once the global epoch is two ahead of an object's tag, no thread can
+ * still be inside a region that began before the object was unlinked, and
+ * the object is deleted.
+ *
+ * Each thread is assigned a process-wide slot number the first time it
+ * enters any reclaimer; the number is returned when the thread exits. The
+ * first kMaxThreads slots live inline in every reclaimer. Threads beyond
+ * that are given numbers past kMaxThreads, whose slots are allocated on
+ * first use in blocks of kMaxThreads chained off the reclaimer and kept
+ * until it is destroyed, so any number of threads can run at once.
+ * Per-slot state is padded to a cache line, and each slot's retire list is
+ * touched only by its owning thread, so entering, leaving, and retiring
+ * never contend on a shared lock.
+ *
+ * Critical regions may be nested. Objects still pending when the reclaimer
+ * is destroyed are deleted by the destructor, which must only run once no
+ * thread is using the structure.
+ */
+
+class EpochReclaimer {
+public:
+    /**
+     * @brief Number of thread slots held inline and per overflow block.
+     * @details A thread that arrives while every inline slot is taken is
+     * given an overflow slot instead of waiting for another thread to exit.
+     */
+    static const int kMaxThreads = 128;
+
+    /**
+     * @class Guard
+     * @brief RAII critical region: enters on construction, exits on destruction.
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochReclaimer& reclaimer) : owner(reclaimer) { owner.enter(); }
+        ~Guard() { owner.exit(); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochReclaimer& owner;
+    };
+
+    /**
+     * @brief Constructs a reclaimer at epoch 0 with no pending objects.
+     */
+    EpochReclaimer();
+
+    /**
+     * @brief Deletes every object that is still pending.
+     */
+    ~EpochReclaimer();
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    /**
+     * @brief Begins a critical region for the calling thread.
+     */
+    void enter();
+
+    /**
+     * @brief Ends the calling thread's innermost critical region.
+     */
+    void exit();
+
+    /**
+     * @brief Schedules an object for deletion once no reader can hold it.
+     * @param object  The unlinked object.
+     * @param deleter Function that destroys the object.
+     * @note Must be called inside a critical region.
+     */
+    void retire(void* object, void (*deleter)(void*));
+
+    /**
+     * @brief Schedules an object allocated with new for deletion.
+     */
+    template <class T>
+    void retire(T* object) {
+        retire(object, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /**
+     * @brief Returns the number of retired objects not yet deleted.
+     * @note Intended for diagnostics; the value may be stale.
+     */
+    std::size_t pending() const;
+
+private:
+    /**
+     * @brief Announcement value of a thread outside any critical region.
+     */
+    static const std::uint64_t kIdle = ~static_cast<std::uint64_t>(0);
+
+    /**
+     * @brief Number of retirements between attempts to reclaim memory.
+     */
+    static const std::size_t kScanInterval = 64;
+
+    /**
+     * @brief A retired object awaiting deletion.
+     */
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        std::uint64_t epoch;
+    };
+
+    /**
+     * @brief Per-thread-slot state, padded to its own cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> announced;
+        int depth;
+        Retired* items;
+        std::size_t count;
+        std::size_t capacity;
+        std::size_t sinceScan;
+
+        Slot() : announced(kIdle), depth(0), items(nullptr), count(0),
+                 capacity(0), sinceScan(0) {}
+    };
+
+    /**
+     * @brief kMaxThreads overflow slots; blocks are only ever appended.
+     */
+    struct SlotBlock {
+        Slot slots[kMaxThreads];
+        std::atomic<SlotBlock*> next{ nullptr };
+    };
+
+    std::atomic<std::uint64_t> globalEpoch;
+    std::atomic<std::size_t> pendingCount;
+    Slot slots[kMaxThreads];
+    std::atomic<SlotBlock*> overflow;
+
+    /**
+     * @brief Returns the slot for a thread slot number, allocating its
+     * overflow block if no thread has used it in this reclaimer yet.
+     */
+    Slot& slotFor(int index);
+
+    /**
+     * @brief Returns true if no slot in the array announces an older epoch.
+     */
+    static bool caughtUp(const Slot* array, std::uint64_t epoch);
+
+    /**
+     * @brief Deletes every object in the slot's retire list and the list.
+     */
+    static void drain(Slot& slot);
+
+    /**
+     * @brief Advances the global epoch if every active thread has caught up.
+     */
+    void tryAdvance();
+
+    /**
+     * @brief Deletes the slot's retired objects that are now safe to free.
+     */
+    void reclaim(Slot& slot);
+};
+
+#endif // EPOCHRECLAIMER_H
@@ -0,0 +1,336 @@
+/**
+ * @file FrozenBST.cpp
+ * @brief Implementation of the FrozenBST class.
+ *
+ * @details
+ * This file contains the implementation of the Eytzinger-layout snapshot.
+ * All navigation is index arithmetic on the implicit complete tree: the
+ * children of index k are 2k and 2k + 1 and its parent is k / 2.
+ *
+ * A branchless descent ends at an index past the end of the array whose
+ * binary representation records the path taken: each 1 bit is a step to the
+ * right (value was greater) and each 0 bit a step to the left. Stripping the
+ * trailing 1 bits and the 0 bit above them recovers the last node at which
+ * the search went left, which is exactly the lower bound.
+ */
+
+#include "FrozenBST.h"
+#include "Prefetch.h"
+#include <climits>
+#include <cstdint>
+#include <new>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Counts the consecutive 1 bits at the low end of k.
+ */
+inline int trailingOnes(std::size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+    int n = 0;
+    while (k & 1) {
+        k >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Number of levels in a complete tree of count nodes.
+ */
+inline int levelsFor(std::size_t count) {
+    int levels = 0;
+    for (std::size_t m = count; m; m >>= 1)
+        levels++;
+    return levels;
+}
+
+} // namespace
+
+/**
+ * Returns the value stored at the iterator's Eytzinger index.
+ */
+int FrozenBST::const_iterator::operator*() const {
+    return owner->keys[index];
+}
+
+/**
+ * Moves to the in-order successor.
+ */
+FrozenBST::const_iterator& FrozenBST::const_iterator::operator++() {
+    index = owner->nextIndex(index);
+    return *this;
+}
+
+FrozenBST::const_iterator FrozenBST::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+/**
+ * Moves to the in-order predecessor; from end() moves to the last value.
+ */
+FrozenBST::const_iterator& FrozenBST::const_iterator::operator--() {
+    index = index ? owner->prevIndex(index) : owner->lastIndex();
+    return *this;
+}
+
+FrozenBST::const_iterator FrozenBST::const_iterator::operator--(int) {
+    const_iterator previous = *this;
+    --*this;
+    return previous;
+}
+
+/**
+ * Creates a snapshot holding no values.
+ */
+FrozenBST::FrozenBST() : keys(nullptr), count(0) {}
+
+/**
+ * Allocates the array and writes the ascending values into it by visiting
+ * Eytzinger indices in in-order sequence, which takes O(n) time in total.
+ */
+FrozenBST::FrozenBST(const int* sorted, std::size_t n) : keys(nullptr), count(0) {
+    allocate(n);
+
+    std::size_t k = firstIndex();
+    for (std::size_t i = 0; i < n; i++) {
+        keys[k] = sorted[i];
+        k = nextIndex(k);
+    }
+}
+
+/**
+ * Releases the array.
+ */
+FrozenBST::~FrozenBST() {
+    release();
+}
+
+/**
+ * Takes over the other snapshot's array, leaving it empty.
+ */
+FrozenBST::FrozenBST(FrozenBST&& other) noexcept : keys(other.keys), count(other.count) {
+    other.keys = nullptr;
+    other.count = 0;
+}
+
+/**
+ * Releases this snapshot's array, then takes over the other's.
+ */
+FrozenBST& FrozenBST::operator=(FrozenBST&& other) noexcept {
+    if (this != &other) {
+        release();
+        keys = other.keys;
+        count = other.count;
+        other.keys = nullptr;
+        other.count = 0;
+    }
+    return *this;
+}
+
+/**
+ * A value is present when its lower bound holds exactly that value.
+ */
+bool FrozenBST::search(int value) const {
+    std::size_t k = descend(value, false);
+    return k != 0 && keys[k] == value;
+}
+
+/**
+ * Processes eight queries per group. Every group runs for the full number
+ * of tree levels; a lane whose index has already passed the end of the
+ * array simply keeps it, which reproduces the scalar loop exactly. With
+ * AVX2 each level is one masked gather, one compare, and one blend;
+ * otherwise the same steps are written as scalar code over the group, which
+ * still lets the processor overlap the eight independent loads.
+ */
+void FrozenBST::searchBatch(const int* values, std::size_t n, bool* results) const {
+    const int levels = levelsFor(count);
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    if (count < (static_cast<std::size_t>(1) << 30)) {
+        const __m256i last = _mm256_set1_epi32(static_cast<int>(count) + 1);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i zero = _mm256_setzero_si256();
+        alignas(32) int lanes[8];
+
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i k = one;
+
+            for (int level = 0; level < levels; level++) {
+                __m256i active = _mm256_cmpgt_epi32(last, k);
+                __m256i v = _mm256_mask_i32gather_epi32(zero, keys, k, active, 4);
+                __m256i less = _mm256_cmpgt_epi32(x, v);
+                __m256i next = _mm256_sub_epi32(_mm256_add_epi32(k, k), less);
+                k = _mm256_blendv_epi8(k, next, active);
+            }
+
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), k);
+            for (int j = 0; j < 8; j++) {
+                std::size_t idx = static_cast<std::size_t>(lanes[j]);
+                idx >>= trailingOnes(idx) + 1;
+                results[i + j] = idx != 0 && keys[idx] == values[i + j];
+            }
+        }
+    }
+#endif
+
+    const int kGroup = 8;
+    std::size_t k[kGroup];
+
+    for (; i < n; i += kGroup) {
+        int width = (n - i < static_cast<std::size_t>(kGroup))
+            ? static_cast<int>(n - i) : kGroup;
+
+        for (int j = 0; j < width; j++)
+            k[j] = 1;
+
+        for (int level = 0; level < levels; level++) {
+            for (int j = 0; j < width; j++) {
+                bool active = k[j] <= count;
+                std::size_t safe = active ? k[j] : 0;
+                std::size_t next = 2 * k[j] + (keys[safe] < values[i + j]);
+                k[j] = active ? next : k[j];
+            }
+        }
+
+        for (int j = 0; j < width; j++) {
+            std::size_t idx = k[j] >> (trailingOnes(k[j]) + 1);
+            results[i + j] = idx != 0 && keys[idx] == values[i + j];
+        }
+    }
+}
+
+FrozenBST::const_iterator FrozenBST::lower_bound(int value) const {
+    return const_iterator(this, descend(value, false));
+}
+
+FrozenBST::const_iterator FrozenBST::upper_bound(int value) const {
+    return const_iterator(this, descend(value, true));
+}
+
+FrozenBST::const_iterator FrozenBST::begin() const {
+    return const_iterator(this, firstIndex());
+}
+
+FrozenBST::const_iterator FrozenBST::end() const {
+    return const_iterator(this, 0);
+}
+
+std::size_t FrozenBST::size() const {
+    return count;
+}
+
+bool FrozenBST::isEmpty() const {
+    return count == 0;
+}
+
+/**
+ * Allocates count + 1 slots aligned to a 64-byte cache line, so that the
+ * sixteen elements at indices 16k..16k+15 always share one line. Slot 0 is
+ * zeroed because the scalar batch path reads it for inactive lanes.
+ */
+void FrozenBST::allocate(std::size_t n) {
+    release();
+    keys = static_cast<int*>(::operator new[]((n + 1) * sizeof(int), std::align_val_t(64)));
+    keys[0] = 0;
+    count = n;
+}
+
+void FrozenBST::release() {
+    if (keys)
+        ::operator delete[](keys, std::align_val_t(64));
+    keys = nullptr;
+    count = 0;
+}
+
+/**
+ * The smallest value is reached by following left children from the root.
+ */
+std::size_t FrozenBST::firstIndex() const {
+    if (count == 0) return 0;
+    std::size_t k = 1;
+    while (2 * k <= count)
+        k = 2 * k;
+    return k;
+}
+
+/**
+ * The largest value is reached by following right children from the root.
+ */
+std::size_t FrozenBST::lastIndex() const {
+    if (count == 0) return 0;
+    std::size_t k = 1;
+    while (2 * k + 1 <= count)
+        k = 2 * k + 1;
+    return k;
+}
+
+/**
+ * Leftmost node of the right subtree if there is one; otherwise climb past
+ * every ancestor reached from a right child (odd index) and step to the
+ * parent once more.
+ */
+std::size_t FrozenBST::nextIndex(std::size_t k) const {
+    if (2 * k + 1 <= count) {
+        k = 2 * k + 1;
+        while (2 * k <= count)
+            k = 2 * k;
+        return k;
+    }
+
+    k >>= trailingOnes(k) + 1;
+    return k;
+}
+
+/**
+ * Rightmost node of the left subtree if there is one; otherwise climb past
+ * every ancestor reached from a left child (even index) and step to the
+ * parent once more.
+ */
+std::size_t FrozenBST::prevIndex(std::size_t k) const {
+    if (2 * k <= count) {
+        k = 2 * k;
+        while (2 * k + 1 <= count)
+            k = 2 * k + 1;
+        return k;
+    }
+
+    while (k && !(k & 1))
+        k >>= 1;
+    return k >> 1;
+}
+
+/**
+ * Branchless Eytzinger descent. Every step moves to 2k or 2k + 1 based on
+ * one comparison, and prefetches the cache line holding the sixteen
+ * descendants four levels further down. The strict form (used by
+ * upper_bound) treats equal values as smaller.
+ */
+std::size_t FrozenBST::descend(int value, bool strict) const {
+    if (strict) {
+        // First value greater than INT_MAX does not exist
+        if (value == INT_MAX) return 0;
+        value++;
+    }
+
+    std::size_t k = 1;
+    while (k <= count) {
+        prefetchRead(reinterpret_cast<const void*>(
+            reinterpret_cast<std::uintptr_t>(keys) + 16 * sizeof(int) * k));
+        k = 2 * k + (keys[k] < value);
+    }
+
+    return k >> (trailingOnes(k) + 1);
+}
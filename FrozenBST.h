@@ -0,0 +1,242 @@
+/**
+ * @file FrozenBST.h
+ * @brief Declaration of the FrozenBST class.
+ *
+ * @details
+ * This header declares FrozenBST, an immutable, read-optimized snapshot of a
+ * BST. The snapshot stores the tree's values in a single contiguous array in
+ * Eytzinger (breadth-first) order, the same order in which levelOrder()
+ * visits a complete tree, and supports branchless search, lower_bound, and
+ * in-order iteration.
+ *
+ * Snapshots are normally created with BST::freeze(). Implementation details
+ * are defined in FrozenBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef FROZENBST_H
+#define FROZENBST_H
+
+#include <cstddef>
+#include <iterator>
+
+class BST;
+
+/**
+ * @class FrozenBST
+ * @brief Immutable snapshot of a BST stored in Eytzinger layout.
+ *
+ * @details
+ * In Eytzinger layout the root is stored at index 1 and the children of the
+ * element at index k are stored at indices 2k and 2k + 1; index 0 is unused.
+ * The implicit tree is complete, so a snapshot of n values needs exactly
+ * n + 1 array slots and no child pointers. The top levels of the tree share a
+ * handful of cache lines, and the 16 descendants four levels below any
+ * element occupy a single 64-byte cache line, which lets a search prefetch
+ * well ahead of where it currently is.
+ *
+ * Searches are branchless: each step computes the next index arithmetically
+ * from a single comparison, so the processor never mispredicts the
+ * direction. When compiled with AVX2 support, searchBatch() advances eight
+ * queries at once with vector compares and gathers; otherwise it advances a
+ * group of queries in lockstep with scalar code.
+ *
+ * The snapshot does not change when the tree it was taken from is modified
+ * afterwards. Because it is immutable, any number of threads may query the
+ * same snapshot concurrently.
+ *
+ * Semantics match the live BST: search() reports membership, lower_bound()
+ * finds the first value not less than a key, and iteration visits values in
+ * ascending order.
+ *
+ * @see BST::freeze()
+ */
+
+class FrozenBST {
+public:
+    /**
+     * @class const_iterator
+     * @brief Bidirectional iterator visiting snapshot values in ascending order.
+     *
+     * @details
+     * The iterator stores an Eytzinger index. Advancing moves to the in-order
+     * successor within the implicit tree using only index arithmetic, so
+     * iteration performs no allocation. The end position is index 0.
+     */
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef int reference;
+
+        /**
+         * @brief Constructs an end iterator.
+         */
+        const_iterator() : owner(nullptr), index(0) {}
+
+        /**
+         * @brief Returns the value at the current position.
+         */
+        int operator*() const;
+
+        /**
+         * @brief Advances to the next larger value.
+         */
+        const_iterator& operator++();
+
+        /**
+         * @brief Advances to the next larger value (postfix).
+         */
+        const_iterator operator++(int);
+
+        /**
+         * @brief Moves back to the next smaller value.
+         * @note Decrementing end() yields the largest value.
+         */
+        const_iterator& operator--();
+
+        /**
+         * @brief Moves back to the next smaller value (postfix).
+         */
+        const_iterator operator--(int);
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        friend class FrozenBST;
+
+        const_iterator(const FrozenBST* owner, std::size_t index)
+            : owner(owner), index(index) {}
+
+        const FrozenBST* owner;
+        std::size_t index;
+    };
+
+    /**
+     * @brief Constructs an empty snapshot.
+     */
+    FrozenBST();
+
+    /**
+     * @brief Builds a snapshot from values already in strictly ascending order.
+     * @param sorted Array of count ascending, distinct values.
+     * @param count  Number of values.
+     */
+    FrozenBST(const int* sorted, std::size_t count);
+
+    /**
+     * @brief Frees the snapshot's array.
+     */
+    ~FrozenBST();
+
+    FrozenBST(const FrozenBST&) = delete;
+    FrozenBST& operator=(const FrozenBST&) = delete;
+
+    /**
+     * @brief Transfers ownership of another snapshot's array.
+     */
+    FrozenBST(FrozenBST&& other) noexcept;
+
+    /**
+     * @brief Transfers ownership of another snapshot's array.
+     */
+    FrozenBST& operator=(FrozenBST&& other) noexcept;
+
+    /**
+     * @brief Searches for a value.
+     * @return true if the value exists in the snapshot; otherwise false.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Searches for many values, using AVX2 when available.
+     * @param values  Array of count values to look up.
+     * @param count   Number of values.
+     * @param results Output array; results[i] is true if values[i] exists.
+     */
+    void searchBatch(const int* values, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Returns an iterator to the first value not less than value.
+     * @return The matching position, or end() if every value is smaller.
+     */
+    const_iterator lower_bound(int value) const;
+
+    /**
+     * @brief Returns an iterator to the first value greater than value.
+     * @return The matching position, or end() if no value is greater.
+     */
+    const_iterator upper_bound(int value) const;
+
+    /**
+     * @brief Returns an iterator to the smallest value.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Returns the past-the-end iterator.
+     */
+    const_iterator end() const;
+
+    /**
+     * @brief Returns the number of values in the snapshot.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether the snapshot is empty.
+     */
+    bool isEmpty() const;
+
+private:
+    friend class BST;
+
+    int* keys;          ///< Eytzinger array; keys[0] is unused.
+    std::size_t count;  ///< Number of stored values.
+
+    /**
+     * @brief Allocates an uninitialized, cache-line-aligned array for count values.
+     */
+    void allocate(std::size_t count);
+
+    /**
+     * @brief Releases the array.
+     */
+    void release();
+
+    /**
+     * @brief Returns the Eytzinger index holding the smallest value.
+     */
+    std::size_t firstIndex() const;
+
+    /**
+     * @brief Returns the Eytzinger index holding the largest value.
+     */
+    std::size_t lastIndex() const;
+
+    /**
+     * @brief Returns the in-order successor index, or 0 if there is none.
+     */
+    std::size_t nextIndex(std::size_t k) const;
+
+    /**
+     * @brief Returns the in-order predecessor index, or 0 if there is none.
+     */
+    std::size_t prevIndex(std::size_t k) const;
+
+    /**
+     * @brief Branchless descent returning the index of the first value not
+     *        less than (or, if strict, greater than) value, or 0.
+     */
+    std::size_t descend(int value, bool strict) const;
+};
+
+#endif // FROZENBST_H
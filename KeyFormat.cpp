@@ -0,0 +1,192 @@
+/**
+ * @file KeyFormat.cpp
+ * @brief Implementation of the key file header, checksum, and writer.
+ *
+ * @details
+ * Multi-byte fields are assembled byte by byte so that files are identical
+ * on little- and big-endian hosts; compilers turn the little-endian loops
+ * into single loads and stores on x86 and ARM.
+ */
+
+#include "KeyFormat.h"
+#include <cstring>
+
+namespace {
+
+const unsigned char kMagic[4] = { 'B', 'S', 'T', 'K' };
+
+void storeLE(unsigned char* out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+std::uint64_t loadLE(const unsigned char* in, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// KeyFileHeader
+// ---------------------------------------------------------------------------
+
+void KeyFileHeader::write(unsigned char* out) const {
+    std::memcpy(out, kMagic, 4);
+    storeLE(out + 4, kVersion, 2);
+    storeLE(out + 6, static_cast<std::uint16_t>(encoding), 2);
+    storeLE(out + 8, count, 8);
+    storeLE(out + 16, payloadBytes, 8);
+    storeLE(out + 24, checksum, 8);
+}
+
+bool KeyFileHeader::read(const unsigned char* data, std::size_t size) {
+    if (size < kSize || std::memcmp(data, kMagic, 4) != 0)
+        return false;
+    if (loadLE(data + 4, 2) != kVersion)
+        return false;
+
+    std::uint64_t rawEncoding = loadLE(data + 6, 2);
+    if (rawEncoding != static_cast<std::uint16_t>(KeyEncoding::Raw)
+        && rawEncoding != static_cast<std::uint16_t>(KeyEncoding::DeltaVarint))
+        return false;
+
+    encoding = static_cast<KeyEncoding>(rawEncoding);
+    count = loadLE(data + 8, 8);
+    payloadBytes = loadLE(data + 16, 8);
+    checksum = loadLE(data + 24, 8);
+
+    // Every key takes at least one payload byte, which bounds the count
+    // before anything is allocated for it.
+    return payloadBytes <= size - kSize && count <= payloadBytes;
+}
+
+// ---------------------------------------------------------------------------
+// KeyChecksum
+// ---------------------------------------------------------------------------
+
+KeyChecksum::KeyChecksum() : state(0x243F6A8885A308D3ULL), pending(0), pendingBytes(0), length(0) {}
+
+std::uint64_t KeyChecksum::mix(std::uint64_t s, std::uint64_t word) {
+    s ^= word;
+    s = (s << 31) | (s >> 33);
+    return s * 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * Completes any partial word left by the previous call, then consumes
+ * whole words directly and keeps the remainder for the next call.
+ */
+void KeyChecksum::update(const unsigned char* data, std::size_t size) {
+    length += size;
+
+    while (pendingBytes > 0 && size > 0) {
+        pending |= static_cast<std::uint64_t>(*data++) << (8 * pendingBytes);
+        size--;
+        if (++pendingBytes == 8) {
+            state = mix(state, pending);
+            pending = 0;
+            pendingBytes = 0;
+        }
+    }
+
+    for (; size >= 8; data += 8, size -= 8)
+        state = mix(state, loadLE(data, 8));
+
+    for (; size > 0; size--)
+        pending |= static_cast<std::uint64_t>(*data++) << (8 * pendingBytes++);
+}
+
+/**
+ * Pads the final partial word with zeros and finishes with an avalanche
+ * step so that the length and last word affect every output bit.
+ */
+std::uint64_t KeyChecksum::value() const {
+    std::uint64_t s = state;
+    if (pendingBytes > 0)
+        s = mix(s, pending);
+
+    s ^= length;
+    s ^= s >> 33;
+    s *= 0xFF51AFD7ED558CCDULL;
+    s ^= s >> 33;
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// KeyWriter
+// ---------------------------------------------------------------------------
+
+/**
+ * Reserves the header's space with a placeholder so that the payload can
+ * be streamed before its size and checksum are known.
+ */
+KeyWriter::KeyWriter(std::FILE* stream, KeyEncoding e)
+    : out(stream), encoding(e), chunk(new unsigned char[kChunkBytes]), used(0),
+      count(0), payloadBytes(0), previous(0), ok(true) {
+    unsigned char placeholder[KeyFileHeader::kSize] = {};
+    ok = std::fwrite(placeholder, 1, sizeof(placeholder), out) == sizeof(placeholder);
+}
+
+KeyWriter::~KeyWriter() {
+    delete[] chunk;
+}
+
+/**
+ * A key needs at most five bytes, so one check per key keeps the chunk
+ * from overflowing.
+ */
+void KeyWriter::append(int key) {
+    if (kChunkBytes - used < 5)
+        flushChunk();
+
+    unsigned char* p = chunk + used;
+
+    if (encoding == KeyEncoding::Raw) {
+        storeLE(p, static_cast<std::uint32_t>(key), 4);
+        p += 4;
+    }
+    else {
+        std::uint32_t value = count == 0
+            ? zigzagEncode(key)
+            : static_cast<std::uint32_t>(key) - previous - 1;
+        while (value >= 0x80) {
+            *p++ = static_cast<unsigned char>(value | 0x80);
+            value >>= 7;
+        }
+        *p++ = static_cast<unsigned char>(value);
+    }
+
+    used = static_cast<std::size_t>(p - chunk);
+    previous = static_cast<std::uint32_t>(key);
+    count++;
+}
+
+bool KeyWriter::finish() {
+    flushChunk();
+
+    KeyFileHeader header;
+    header.encoding = encoding;
+    header.count = count;
+    header.payloadBytes = payloadBytes;
+    header.checksum = checksum.value();
+
+    unsigned char bytes[KeyFileHeader::kSize];
+    header.write(bytes);
+
+    ok = ok && std::fflush(out) == 0 && std::fseek(out, 0, SEEK_SET) == 0
+        && std::fwrite(bytes, 1, sizeof(bytes), out) == sizeof(bytes)
+        && std::fflush(out) == 0;
+    return ok;
+}
+
+void KeyWriter::flushChunk() {
+    if (used == 0) return;
+
+    checksum.update(chunk, used);
+    ok = ok && std::fwrite(chunk, 1, used, out) == used;
+    payloadBytes += used;
+    used = 0;
+}
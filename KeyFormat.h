@@ -0,0 +1,255 @@
+/**
+ * @file KeyFormat.h
+ * @brief Declaration of the binary key file format used by BST::save() and BST::load().
+ *
+ * @details
+ * This header declares the on-disk layout of a saved tree and the helpers
+ * that encode and decode it. A key file holds a tree's values in ascending
+ * order behind a fixed 32-byte header:
+ *
+ * | Offset | Size | Field                                           |
+ * |--------|------|-------------------------------------------------|
+ * | 0      | 4    | Magic bytes "BSTK"                              |
+ * | 4      | 2    | Format version (currently 1)                    |
+ * | 6      | 2    | Payload encoding (see KeyEncoding)              |
+ * | 8      | 8    | Number of keys                                  |
+ * | 16     | 8    | Payload size in bytes                           |
+ * | 24     | 8    | Checksum of the payload (see KeyChecksum)       |
+ *
+ * All integers are little-endian. Implementation details are defined in
+ * KeyFormat.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef KEYFORMAT_H
+#define KEYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @enum KeyEncoding
+ * @brief How the ascending keys are stored in the payload.
+ *
+ * - Raw stores each key as a 4-byte little-endian integer.
+ * - DeltaVarint stores the first key zigzag-encoded and every later key as
+ *   the gap to its predecessor minus one, each as an LEB128 varint (7 bits
+ *   per byte, high bit set on all but the last byte). Dense key sets need
+ *   one byte per key, and because gaps are at least one, any decoded
+ *   sequence is strictly ascending by construction.
+ */
+enum class KeyEncoding : std::uint16_t {
+    Raw = 0,
+    DeltaVarint = 1
+};
+
+/**
+ * @struct KeyFileHeader
+ * @brief The decoded fixed-size header of a key file.
+ */
+struct KeyFileHeader {
+    static const std::size_t kSize = 32;
+    static const std::uint16_t kVersion = 1;
+
+    KeyEncoding encoding;
+    std::uint64_t count;
+    std::uint64_t payloadBytes;
+    std::uint64_t checksum;
+
+    /**
+     * @brief Serializes the header into kSize bytes.
+     */
+    void write(unsigned char* out) const;
+
+    /**
+     * @brief Parses and validates a header.
+     * @param data Start of the file.
+     * @param size Size of the file in bytes.
+     * @return false if the magic, version, or encoding is unknown, the
+     *         stated payload does not fit in the file, or it is too small to
+     *         hold the stated number of keys.
+     */
+    bool read(const unsigned char* data, std::size_t size);
+};
+
+/**
+ * @class KeyChecksum
+ * @brief Streaming 64-bit checksum of a byte sequence.
+ *
+ * @details
+ * Bytes are consumed as little-endian 64-bit words, each mixed into the
+ * state with an xor, a rotation, and a multiplication by an odd constant,
+ * so every bit of the input affects the result and reordered words produce
+ * a different value. The total length is folded in at the end. The result
+ * depends only on the byte sequence, not on how it was split across
+ * update() calls. It detects corruption, not tampering.
+ */
+class KeyChecksum {
+public:
+    KeyChecksum();
+
+    /**
+     * @brief Feeds the next bytes of the sequence.
+     */
+    void update(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief Returns the checksum of every byte fed so far.
+     */
+    std::uint64_t value() const;
+
+private:
+    std::uint64_t state;
+    std::uint64_t pending;
+    unsigned int pendingBytes;
+    std::uint64_t length;
+
+    static std::uint64_t mix(std::uint64_t state, std::uint64_t word);
+};
+
+/**
+ * @class KeyWriter
+ * @brief Encodes an ascending stream of keys into a key file.
+ *
+ * @details
+ * The header is written as a placeholder first; keys are encoded into a
+ * 64 KiB chunk that is checksummed and written whenever it fills, and
+ * finish() rewrites the header with the final count, size, and checksum.
+ * The caller must supply strictly ascending keys.
+ */
+class KeyWriter {
+public:
+    /**
+     * @param out      Destination stream, opened in binary mode and positioned
+     *                 at the start of the file; not owned.
+     * @param encoding Payload encoding to use.
+     */
+    KeyWriter(std::FILE* out, KeyEncoding encoding);
+    ~KeyWriter();
+
+    KeyWriter(const KeyWriter&) = delete;
+    KeyWriter& operator=(const KeyWriter&) = delete;
+
+    /**
+     * @brief Appends the next key.
+     */
+    void append(int key);
+
+    /**
+     * @brief Flushes the payload and writes the final header.
+     * @return false if any write to the stream failed.
+     */
+    bool finish();
+
+private:
+    static const std::size_t kChunkBytes = 1 << 16;
+
+    std::FILE* out;
+    KeyEncoding encoding;
+    unsigned char* chunk;
+    std::size_t used;
+    std::uint64_t count;
+    std::uint64_t payloadBytes;
+    std::uint32_t previous;
+    KeyChecksum checksum;
+    bool ok;
+
+    void flushChunk();
+};
+
+/**
+ * @brief Maps a signed integer to an unsigned one so that small magnitudes
+ *        of either sign become small numbers (0, -1, 1, -2 -> 0, 1, 2, 3).
+ */
+inline std::uint32_t zigzagEncode(int value) {
+    return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Inverse of zigzagEncode().
+ */
+inline int zigzagDecode(std::uint32_t encoded) {
+    return static_cast<int>((encoded >> 1) ^ (0u - (encoded & 1u)));
+}
+
+/**
+ * @brief Decodes one LEB128 varint of at most 32 bits.
+ * @param p   Cursor, advanced past the varint.
+ * @param end End of the readable data.
+ * @param out Receives the decoded value.
+ * @return false if the data ends early or the varint is longer than five bytes.
+ */
+inline bool decodeVarint(const unsigned char*& p, const unsigned char* end, std::uint32_t& out) {
+    if (p < end && *p < 0x80) {
+        out = *p++;
+        return true;
+    }
+
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end)
+            return false;
+        unsigned char byte = *p++;
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            out = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Decodes a key file's payload, passing each key to a sink in order.
+ * @param header  Validated header of the file.
+ * @param payload First payload byte.
+ * @param sink    Callable invoked as sink(std::size_t index, int key).
+ * @return false if the payload is malformed (truncated, overlong, or a key
+ *         beyond the int range).
+ * @details Delta-varint keys are ascending by construction, so no
+ *          comparisons between keys are made.
+ */
+template <class Sink>
+bool decodeKeys(const KeyFileHeader& header, const unsigned char* payload, Sink sink) {
+    const unsigned char* p = payload;
+    const unsigned char* end = payload + header.payloadBytes;
+
+    if (header.encoding == KeyEncoding::Raw) {
+        if (header.payloadBytes != header.count * 4)
+            return false;
+        for (std::size_t i = 0; i < header.count; i++, p += 4) {
+            std::uint32_t bits = static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+                | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+            sink(i, static_cast<int>(bits));
+        }
+        return true;
+    }
+
+    std::uint32_t encoded;
+    if (header.count == 0)
+        return p == end;
+    if (!decodeVarint(p, end, encoded))
+        return false;
+
+    std::int64_t key = zigzagDecode(encoded);
+    sink(0, static_cast<int>(key));
+
+    for (std::size_t i = 1; i < header.count; i++) {
+        if (!decodeVarint(p, end, encoded))
+            return false;
+        key += static_cast<std::int64_t>(encoded) + 1;
+        if (key > 0x7FFFFFFF)
+            return false;
+        sink(i, static_cast<int>(key));
+    }
+
+    return p == end;
+}
+
+#endif // KEYFORMAT_H
@@ -0,0 +1,275 @@
+/**
+ * @file LockFreeBST.cpp
+ * @brief Implementation of the LockFreeBST class.
+ *
+ * @details
+ * This file contains the Natarajan-Mittal algorithm. Routing follows the
+ * usual external-tree rule: go left when the key is smaller than the node's
+ * key, right otherwise, so a leaf equal to a routing key lies to its right.
+ *
+ * The initial tree holds three sentinels, inf0 < inf1 < inf2, all larger
+ * than INT_MAX:
+ *
+ *            R(inf2)
+ *           /      \
+ *       S(inf1)   inf2
+ *       /     \
+ *    inf0    inf1
+ *
+ * Every real value is inserted to the left of inf0's position, so R is
+ * always a valid ancestor and S a valid successor for seek().
+ *
+ * Every public operation runs inside an epoch critical region, which keeps
+ * every node that seek() may pass through alive until the operation ends.
+ */
+
+#include "LockFreeBST.h"
+#include <climits>
+
+namespace {
+
+const std::int64_t kInf0 = static_cast<std::int64_t>(INT_MAX) + 1;
+const std::int64_t kInf1 = static_cast<std::int64_t>(INT_MAX) + 2;
+const std::int64_t kInf2 = static_cast<std::int64_t>(INT_MAX) + 3;
+
+} // namespace
+
+/**
+ * Builds the sentinel skeleton shown above.
+ */
+LockFreeBST::LockFreeBST() : nodeCount(0) {
+    LFNode* s = new LFNode(kInf1, new LFNode(kInf0, nullptr, nullptr), new LFNode(kInf1, nullptr, nullptr));
+    root = new LFNode(kInf2, s, new LFNode(kInf2, nullptr, nullptr));
+}
+
+/**
+ * Frees every node, sentinels included, by rotating left children up until
+ * each node has no left child, which takes O(n) time and O(1) space.
+ */
+LockFreeBST::~LockFreeBST() {
+    LFNode* current = root;
+
+    while (current) {
+        LFNode* left = address(current->left.load(std::memory_order_relaxed));
+        if (left) {
+            current->left.store(left->right.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            left->right.store(reinterpret_cast<std::uintptr_t>(current), std::memory_order_relaxed);
+            current = left;
+        }
+        else {
+            LFNode* right = address(current->right.load(std::memory_order_relaxed));
+            delete current;
+            current = right;
+        }
+    }
+}
+
+/**
+ * Replaces the leaf reached by seek() with a new internal node over the old
+ * leaf and a new one. If the parent's edge is no longer a clean link to
+ * that leaf, a removal is in progress there; help it and retry. The two new
+ * nodes are allocated once and reused across retries.
+ */
+bool LockFreeBST::insert(int value) {
+    EpochReclaimer::Guard guard(reclaimer);
+    const std::int64_t key = value;
+    LFNode* newLeaf = nullptr;
+    LFNode* newInternal = nullptr;
+    SeekRecord record;
+
+    for (;;) {
+        seek(key, record);
+        LFNode* leaf = record.leaf;
+        if (leaf->key == key) {
+            delete newLeaf;
+            delete newInternal;
+            return false;
+        }
+
+        if (!newLeaf) {
+            newLeaf = new LFNode(key, nullptr, nullptr);
+            newInternal = new LFNode(0, nullptr, nullptr);
+        }
+
+        std::uintptr_t leafEdge = reinterpret_cast<std::uintptr_t>(leaf);
+        std::uintptr_t newEdge = reinterpret_cast<std::uintptr_t>(newLeaf);
+        if (key < leaf->key) {
+            newInternal->key = leaf->key;
+            newInternal->left.store(newEdge, std::memory_order_relaxed);
+            newInternal->right.store(leafEdge, std::memory_order_relaxed);
+        }
+        else {
+            newInternal->key = key;
+            newInternal->left.store(leafEdge, std::memory_order_relaxed);
+            newInternal->right.store(newEdge, std::memory_order_relaxed);
+        }
+
+        std::atomic<std::uintptr_t>& edge = edgeToward(record.parent, key);
+        std::uintptr_t expected = leafEdge;
+        if (edge.compare_exchange_strong(expected, reinterpret_cast<std::uintptr_t>(newInternal))) {
+            nodeCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (address(expected) == leaf && (expected & (kFlag | kTag)))
+            cleanup(key, record);
+    }
+}
+
+/**
+ * A search is a single seek(); marks are ignored, so a leaf whose removal
+ * has been flagged but not yet spliced out is already treated as absent.
+ */
+bool LockFreeBST::search(int value) const {
+    EpochReclaimer::Guard guard(reclaimer);
+    SeekRecord record;
+    seek(value, record);
+
+    std::uintptr_t edge = edgeToward(record.parent, value).load(std::memory_order_acquire);
+    return record.leaf->key == value && !(address(edge) == record.leaf && (edge & kFlag));
+}
+
+/**
+ * Runs in two modes. In injection mode the operation tries to flag the edge
+ * to the leaf holding value; success is the linearization point. It then
+ * switches to cleanup mode and keeps trying to splice the leaf out until
+ * either its own cleanup() succeeds or a fresh seek() no longer reaches the
+ * leaf, meaning another thread completed the splice on its behalf.
+ */
+bool LockFreeBST::remove(int value) {
+    EpochReclaimer::Guard guard(reclaimer);
+    const std::int64_t key = value;
+    LFNode* target = nullptr;
+    SeekRecord record;
+
+    for (;;) {
+        seek(key, record);
+
+        if (!target) {
+            LFNode* leaf = record.leaf;
+            if (leaf->key != key)
+                return false;
+
+            std::atomic<std::uintptr_t>& edge = edgeToward(record.parent, key);
+            std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(leaf);
+            if (edge.compare_exchange_strong(expected, expected | kFlag)) {
+                nodeCount.fetch_sub(1, std::memory_order_relaxed);
+                target = leaf;
+                if (cleanup(key, record))
+                    return true;
+            }
+            else if (address(expected) == leaf && (expected & (kFlag | kTag))) {
+                cleanup(key, record);
+            }
+        }
+        else {
+            if (record.leaf != target || cleanup(key, record))
+                return true;
+        }
+    }
+}
+
+std::size_t LockFreeBST::size() const {
+    return nodeCount.load(std::memory_order_relaxed);
+}
+
+LockFreeBST::LFNode* LockFreeBST::address(std::uintptr_t edge) {
+    return reinterpret_cast<LFNode*>(edge & ~(kFlag | kTag));
+}
+
+std::atomic<std::uintptr_t>& LockFreeBST::edgeToward(LFNode* node, std::int64_t key) {
+    return key < node->key ? node->left : node->right;
+}
+
+/**
+ * Walks down to a leaf, remembering the last two nodes and, as ancestor and
+ * successor, the endpoints of the last untagged edge on the path.
+ */
+void LockFreeBST::seek(std::int64_t key, SeekRecord& record) const {
+    LFNode* s = address(root->left.load(std::memory_order_acquire));
+
+    record.ancestor = root;
+    record.successor = s;
+    record.parent = s;
+
+    std::uintptr_t parentEdge = s->left.load(std::memory_order_acquire);
+    record.leaf = address(parentEdge);
+
+    std::uintptr_t currentEdge = record.leaf->left.load(std::memory_order_acquire);
+    LFNode* current = address(currentEdge);
+
+    while (current) {
+        if (!(parentEdge & kTag)) {
+            record.ancestor = record.parent;
+            record.successor = record.leaf;
+        }
+        record.parent = record.leaf;
+        record.leaf = current;
+
+        parentEdge = currentEdge;
+        currentEdge = edgeToward(current, key).load(std::memory_order_acquire);
+        current = address(currentEdge);
+    }
+}
+
+/**
+ * Finishes the removal of whichever child of record.parent is flagged.
+ * Usually that is the leaf on key's path; when helping another thread it
+ * may be its sibling, in which case the roles swap. The surviving edge is
+ * tagged so that it can no longer change, and the edge from ancestor to
+ * successor is swung to the survivor, preserving the survivor's flag in
+ * case it is itself being removed. The splice disconnects everything from
+ * successor down to parent, along with the flagged leaves hanging off it.
+ */
+bool LockFreeBST::cleanup(std::int64_t key, const SeekRecord& record) {
+    LFNode* parent = record.parent;
+
+    std::atomic<std::uintptr_t>* childEdge;
+    std::atomic<std::uintptr_t>* siblingEdge;
+    if (key < parent->key) {
+        childEdge = &parent->left;
+        siblingEdge = &parent->right;
+    }
+    else {
+        childEdge = &parent->right;
+        siblingEdge = &parent->left;
+    }
+
+    if (!(childEdge->load(std::memory_order_acquire) & kFlag))
+        siblingEdge = childEdge;
+
+    std::uintptr_t sibling = siblingEdge->fetch_or(kTag) & ~kTag;
+
+    std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(record.successor);
+    if (!edgeToward(record.ancestor, key).compare_exchange_strong(expected, sibling))
+        return false;
+
+    retireChain(key, record.successor, parent, address(sibling));
+    return true;
+}
+
+/**
+ * Every edge from successor down to parent along key's path was tagged,
+ * and the other child of each of those nodes is a flagged leaf. At parent
+ * the child that is not the survivor is the flagged leaf. Tagged and
+ * flagged edges never change again, so the walk is safe, and only the
+ * thread whose splice succeeded reaches here, so nothing is retired twice.
+ */
+void LockFreeBST::retireChain(std::int64_t key, LFNode* successor, LFNode* parent, LFNode* survivor) {
+    LFNode* current = successor;
+
+    while (current != parent) {
+        std::atomic<std::uintptr_t>& path = edgeToward(current, key);
+        std::atomic<std::uintptr_t>& other = &path == &current->left ? current->right : current->left;
+
+        reclaimer.retire(address(other.load(std::memory_order_relaxed)));
+        LFNode* next = address(path.load(std::memory_order_relaxed));
+        reclaimer.retire(current);
+        current = next;
+    }
+
+    LFNode* left = address(parent->left.load(std::memory_order_relaxed));
+    LFNode* right = address(parent->right.load(std::memory_order_relaxed));
+    reclaimer.retire(left == survivor ? right : left);
+    reclaimer.retire(parent);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file LockFreeBST.h
+ * @brief Declaration of the LockFreeBST class.
+ *
+ * @details
+ * This header declares LockFreeBST, a non-blocking binary search tree of
+ * integers after Natarajan and Mittal ("Fast Concurrent Lock-Free Binary
+ * Search Trees", PPoPP 2014). No operation ever takes a lock: a thread that
+ * is preempted in the middle of a removal leaves enough information in the
+ * tree for any other thread to finish the removal for it, so one stalled
+ * thread can never stall the rest.
+ *
+ * Implementation details are defined in LockFreeBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef LOCKFREEBST_H
+#define LOCKFREEBST_H
+
+#include "EpochReclaimer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LockFreeBST
+ * @brief Lock-free external BST with CAS-based edge marking.
+ *
+ * @details
+ * The tree is external (leaf-oriented): values live only in leaves, and
+ * internal nodes hold routing keys with exactly two children. Insertion
+ * replaces a leaf with a new internal node whose children are the old leaf
+ * and the new one, using a single compare-and-swap on the parent's edge.
+ *
+ * Removal marks edges rather than nodes. The low bits of each child pointer
+ * carry two marks:
+ * - A flag on the edge to a leaf means the leaf is being removed.
+ * - A tag on an edge means the edge is frozen: its parent is about to be
+ *   spliced out together with a flagged sibling.
+ * A removal flags the edge to its leaf (the linearization point), tags the
+ * sibling edge, and then swings the edge above the parent to the sibling.
+ * Any thread that runs into a flagged or tagged edge helps finish that
+ * removal before retrying its own operation.
+ *
+ * Three sentinel keys larger than every int keep the tree from ever being
+ * empty, so the root and its left child always exist and every real leaf
+ * has a parent and a grandparent.
+ *
+ * Nodes spliced out by a removal are retired to an EpochReclaimer by the
+ * thread whose compare-and-swap removed them, and freed once no concurrent
+ * operation can still be reading them.
+ *
+ * The tree does not rebalance, and, like ConcurrentBST, provides no
+ * traversals.
+ */
+
+class LockFreeBST {
+public:
+    /**
+     * @brief Constructs an empty tree (the sentinel nodes only).
+     */
+    LockFreeBST();
+
+    /**
+     * @brief Frees every node.
+     * @note No other thread may be using the tree.
+     */
+    ~LockFreeBST();
+
+    LockFreeBST(const LockFreeBST&) = delete;
+    LockFreeBST& operator=(const LockFreeBST&) = delete;
+
+    /**
+     * @brief Inserts a value into the tree.
+     * @param value The integer value to insert.
+     * @return true if inserted, false if the value was already present.
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Searches for a value in the tree.
+     * @param value The value to search for.
+     * @return true if found, false otherwise.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Removes a value from the tree.
+     * @param value The value to remove.
+     * @return true if the value was found and removed, false otherwise.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Returns the number of values in the tree.
+     * @note Exact when no writer is active; otherwise a recent count.
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @struct LFNode
+     * @brief An internal (routing) node or a leaf.
+     *
+     * @details
+     * Keys are 64-bit so that the three sentinel keys fit above INT_MAX.
+     * Child edges are stored as integers holding a node address with the
+     * flag and tag marks in its low bits; a leaf has two null edges.
+     */
+    struct LFNode {
+        std::int64_t key;
+        std::atomic<std::uintptr_t> left;
+        std::atomic<std::uintptr_t> right;
+
+        LFNode(std::int64_t k, LFNode* l, LFNode* r)
+            : key(k), left(reinterpret_cast<std::uintptr_t>(l)), right(reinterpret_cast<std::uintptr_t>(r)) {}
+    };
+
+    /**
+     * @struct SeekRecord
+     * @brief The nodes around the leaf reached by seek().
+     *
+     * @details
+     * leaf and parent are the last two nodes on the access path. ancestor
+     * is the deepest node whose edge to successor is untagged; every edge
+     * between successor and parent is tagged, so when parent is spliced out
+     * the whole tagged run goes with it.
+     */
+    struct SeekRecord {
+        LFNode* ancestor;
+        LFNode* successor;
+        LFNode* parent;
+        LFNode* leaf;
+    };
+
+    /** Edge mark: the leaf below is being removed. */
+    static const std::uintptr_t kFlag = 1;
+    /** Edge mark: the edge is frozen and its parent will be spliced out. */
+    static const std::uintptr_t kTag = 2;
+
+    LFNode* root;
+    std::atomic<std::size_t> nodeCount;
+    mutable EpochReclaimer reclaimer;
+
+    /**
+     * @brief Strips the marks from an edge.
+     */
+    static LFNode* address(std::uintptr_t edge);
+
+    /**
+     * @brief Returns the child edge of node that the search for key follows.
+     */
+    static std::atomic<std::uintptr_t>& edgeToward(LFNode* node, std::int64_t key);
+
+    /**
+     * @brief Walks from the root to the leaf where key is or would be.
+     */
+    void seek(std::int64_t key, SeekRecord& record) const;
+
+    /**
+     * @brief Completes a pending removal below record.parent.
+     * @return true if this call performed the splice.
+     */
+    bool cleanup(std::int64_t key, const SeekRecord& record);
+
+    /**
+     * @brief Retires the nodes that a successful splice disconnected.
+     */
+    void retireChain(std::int64_t key, LFNode* successor, LFNode* parent, LFNode* survivor);
+};
+
+#endif // LOCKFREEBST_H
@@ -0,0 +1,124 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of the MappedFile class.
+ *
+ * @details
+ * POSIX builds use open(), fstat(), and mmap(); other platforms fall back
+ * to reading the whole file with the C stream functions.
+ */
+
+#include "MappedFile.h"
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPEDFILE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MAPPEDFILE_POSIX 0
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#if MAPPEDFILE_POSIX
+
+/**
+ * The descriptor can be closed as soon as the mapping exists.
+ */
+bool MappedFile::open(const char* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+
+    ::madvise(view, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const unsigned char*>(view);
+    mapped = true;
+    return true;
+}
+
+#else
+
+bool MappedFile::open(const char* path) {
+    close();
+
+    std::FILE* in = std::fopen(path, "rb");
+    if (!in)
+        return false;
+
+    std::fseek(in, 0, SEEK_END);
+    long end = std::ftell(in);
+    std::fseek(in, 0, SEEK_SET);
+    if (end < 0) {
+        std::fclose(in);
+        return false;
+    }
+
+    length = static_cast<std::size_t>(end);
+    if (length > 0) {
+        unsigned char* buffer = new unsigned char[length];
+        if (std::fread(buffer, 1, length, in) != length) {
+            delete[] buffer;
+            length = 0;
+            std::fclose(in);
+            return false;
+        }
+        bytes = buffer;
+    }
+
+    std::fclose(in);
+    return true;
+}
+
+#endif
+
+void MappedFile::close() {
+    if (bytes) {
+#if MAPPEDFILE_POSIX
+        if (mapped)
+            ::munmap(const_cast<unsigned char*>(bytes), length);
+        else
+            delete[] bytes;
+#else
+        delete[] bytes;
+#endif
+    }
+
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+const unsigned char* MappedFile::data() const {
+    return bytes;
+}
+
+std::size_t MappedFile::size() const {
+    return length;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file MappedFile.h
+ * @brief Declaration of the MappedFile class.
+ *
+ * @details
+ * This header declares MappedFile, a read-only view of a whole file's
+ * contents. On POSIX systems the file is memory-mapped, so its pages are
+ * read on demand straight from the page cache; elsewhere it is read into a
+ * heap buffer. Either way the caller sees one contiguous byte range.
+ *
+ * Implementation details are defined in MappedFile.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ * @class MappedFile
+ * @brief Read-only, contiguous view of a file.
+ *
+ * @details
+ * The mapping is advised for sequential access, which lets the kernel read
+ * ahead aggressively while the contents are streamed. The view stays valid
+ * until close() or destruction. Empty files open successfully with a null
+ * data pointer and size 0.
+ */
+class MappedFile {
+public:
+    MappedFile();
+
+    /**
+     * @brief Unmaps (or frees) the contents.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Opens a file and makes its contents available.
+     * @param path Path of the file.
+     * @return false if the file cannot be opened or read.
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief Releases the contents.
+     */
+    void close();
+
+    /**
+     * @brief Returns the first byte of the file.
+     */
+    const unsigned char* data() const;
+
+    /**
+     * @brief Returns the file size in bytes.
+     */
+    std::size_t size() const;
+
+private:
+    const unsigned char* bytes;
+    std::size_t length;
+    /** True if bytes is a memory mapping rather than a heap buffer. */
+    bool mapped;
+};
+
+#endif // MAPPEDFILE_H
@@ -14,10 +14,14 @@
 #include "Node.h"
 
 /**
- * Constructs a node initialized with the specified value and
- * null child pointers.
+ * Constructs a node initialized with the specified value,
+ * null child pointers, and a leaf height (and size) of 1.
  */
-Node::Node(int v) : value(v), left(nullptr), right(nullptr) {}
+Node::Node(int v) : value(v), height(1), left(nullptr), right(nullptr)
+#if BST_ORDER_STATISTICS
+	, size(1)
+#endif
+{}
 
 /**
  * Retrieves the node's stored integer value.
@@ -59,3 +63,33 @@ Node* Node::getRight() const {
 void Node::setRight(Node* r) {
 	right = r;
 }
+
+/**
+ * Retrieves the height of the subtree rooted at this node.
+ */
+int Node::getHeight() const {
+	return height;
+}
+
+/**
+ * Assigns the height of the subtree rooted at this node.
+ */
+void Node::setHeight(int h) {
+	height = h;
+}
+
+#if BST_ORDER_STATISTICS
+/**
+ * Retrieves the number of nodes in the subtree rooted at this node.
+ */
+unsigned int Node::getSize() const {
+	return size;
+}
+
+/**
+ * Assigns the number of nodes in the subtree rooted at this node.
+ */
+void Node::setSize(unsigned int s) {
+	size = s;
+}
+#endif
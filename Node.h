@@ -5,7 +5,8 @@
  * @details
  * This header declares the Node class used to represent individual nodes
  * within a binary search tree (BST). The Node class encapsulates a single
- * integer data value along with pointers to its left and right child nodes.
+ * integer data value along with pointers to its left and right child nodes
+ * and the height metadata used by the self-balancing (AVL) mode.
  *
  * Implementation details are defined in Node.cpp.
  *
@@ -19,6 +20,37 @@
 #ifndef NODE_H
 #define NODE_H
 
+/**
+ * @def BST_ORDER_STATISTICS
+ * @brief Enables subtree-size augmentation of Node and the BST rank,
+ *        select, and countRange queries.
+ *
+ * @details
+ * Defaults to 0, which keeps a Node at 24 bytes on 64-bit targets and
+ * leaves insert and remove free of size maintenance. Define it as 1 before
+ * including any BST header (or on the compiler command line) to add the
+ * size field, which grows every node to 32 bytes.
+ */
+#ifndef BST_ORDER_STATISTICS
+#define BST_ORDER_STATISTICS 0
+#endif
+
+/**
+ * @def BST_ENABLE_STATS
+ * @brief Enables the per-operation counters reported by BST::stats().
+ *
+ * @details
+ * Defaults to 0, in which case the counters and every statement that
+ * updates them are compiled out, and insert, search, and remove run
+ * exactly the code they would without instrumentation. Define it as 1 on
+ * the compiler command line (consistently for every translation unit) to
+ * count comparisons, visited nodes, rebalances, and node allocations and
+ * releases. Tree-shape statistics are available either way.
+ */
+#ifndef BST_ENABLE_STATS
+#define BST_ENABLE_STATS 0
+#endif
+
 /**
  * @class Node
  * @brief Represents a node within a binary search tree.
@@ -28,6 +60,16 @@
  * binary search tree. Each node maintains self-referential raw pointers to its
  * left and right child nodes and stores a single integer data value.
  *
+ * Each node also records the height of the subtree rooted at it. The height is
+ * maintained by the BST only when it operates in its AVL balancing mode and
+ * is used to detect and repair imbalance through rotations. A leaf has a
+ * height of 1.
+ *
+ * When BST_ORDER_STATISTICS is enabled, each node additionally records the
+ * number of nodes in the subtree rooted at it (1 for a leaf). The BST keeps
+ * this count current through every insert, remove, and rotation, which
+ * allows rank and selection queries in O(height).
+ *
  * Encapsulation is enforced through data hiding. All data members are declared
  * as private and may only be accessed or modified through public accessor methods.
  */
@@ -77,10 +119,39 @@ public:
      */
     void setRight(Node* right);
 
+    /**
+     * @brief Returns the height of the subtree rooted at this node.
+     * @return The stored subtree height (1 for a leaf).
+     */
+    int getHeight() const;
+
+    /**
+     * @brief Sets the height of the subtree rooted at this node.
+     * @param height The new subtree height.
+     */
+    void setHeight(int height);
+
+#if BST_ORDER_STATISTICS
+    /**
+     * @brief Returns the number of nodes in the subtree rooted at this node.
+     */
+    unsigned int getSize() const;
+
+    /**
+     * @brief Sets the number of nodes in the subtree rooted at this node.
+     * @param size The new subtree size.
+     */
+    void setSize(unsigned int size);
+#endif
+
 private:
     int value;
+    int height;
     Node* left;
     Node* right;
+#if BST_ORDER_STATISTICS
+    unsigned int size;
+#endif
 };
 
 #endif // NODE_H
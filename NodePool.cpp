@@ -0,0 +1,319 @@
+/**
+ * @file NodePool.cpp
+ * @brief Implementation of the NodePool class.
+ *
+ * @details
+ * This file contains the implementation of the NodePool slab allocator.
+ * Slabs are obtained as raw, uninitialized memory and nodes are constructed
+ * in place with placement new when they are handed out.
+ *
+ * The implementation is intentionally pointer-based and avoids the use of
+ * STL containers or smart pointers to demonstrate fundamental memory
+ * management concepts in C++.
+ */
+
+#include "NodePool.h"
+#include <new>
+
+/**
+ * Creates a pool with no slabs; the first slab is allocated lazily on the
+ * first call to allocate().
+ */
+NodePool::NodePool(std::size_t nodesPerSlab)
+    : slabCapacity(nodesPerSlab ? nodesPerSlab : 1),
+      slabs(nullptr), shared(nullptr), cursor(nullptr), limit(nullptr), freeList(nullptr) {}
+
+/**
+ * Releases every slab owned by the pool.
+ */
+NodePool::~NodePool() {
+    releaseAll();
+}
+
+/**
+ * Reuses a node from the free list when one is available; otherwise takes
+ * the next unused slot from the current slab.
+ */
+Node* NodePool::allocate(int value) {
+    Node* slot;
+
+    if (freeList) {
+        slot = freeList;
+        freeList = freeList->getLeft();
+    }
+    else {
+        if (cursor == limit)
+            addSlab();
+        slot = cursor++;
+    }
+
+#if BST_ENABLE_STATS
+    allocations++;
+#endif
+    return new (slot) Node(value);
+}
+
+/**
+ * Places the block in its own slab, leaving the bump cursor of the current
+ * slab untouched so its remaining slots are still used by allocate().
+ */
+Node* NodePool::allocateBlock(std::size_t count) {
+#if BST_ENABLE_STATS
+    allocations += count;
+#endif
+    return newSlab(count ? count : 1);
+}
+
+/**
+ * Pushes the node onto the free list, linking it through its left pointer.
+ */
+void NodePool::release(Node* n) {
+#if BST_ENABLE_STATS
+    releases++;
+#endif
+    n->setLeft(freeList);
+    freeList = n;
+}
+
+/**
+ * Links the chain's last node to the current free list head.
+ */
+void NodePool::releaseChain(Node* first, Node* last, std::size_t count) {
+    if (!first) return;
+
+#if BST_ENABLE_STATS
+    releases += count;
+#else
+    (void)count;
+#endif
+    last->setLeft(freeList);
+    freeList = first;
+}
+
+/**
+ * Splices the other pool's slab list, shared references, and free list onto
+ * this pool's. The other pool's unused bump space is given up. Splicing the
+ * free lists walks the other pool's free list once.
+ *
+ * A reference to a shared list this pool already holds is dropped along
+ * with its count, so rejoining the two halves of a split does not leave two
+ * references to the same slabs. Any shared list this pool is then the only
+ * holder of goes back to being plain owned slabs; otherwise every
+ * split/join cycle would nest the storage one level deeper.
+ */
+void NodePool::adopt(NodePool& other) {
+    if (&other == this) return;
+
+    if (other.slabs) {
+        Slab* tail = other.slabs;
+        while (tail->next)
+            tail = tail->next;
+        tail->next = slabs;
+        slabs = other.slabs;
+    }
+
+    while (other.shared) {
+        SharedRef* ref = other.shared;
+        other.shared = ref->next;
+        if (holds(ref->target)) {
+            ref->target->refs.fetch_sub(1);
+            delete ref;
+        }
+        else {
+            ref->next = shared;
+            shared = ref;
+        }
+    }
+
+    SharedRef** link = &shared;
+    while (*link) {
+        SharedRef* ref = *link;
+        if (ref->target->refs.load() == 1) {
+            Slab* tail = ref->target->slabs;
+            if (tail) {
+                while (tail->next)
+                    tail = tail->next;
+                tail->next = slabs;
+                slabs = ref->target->slabs;
+            }
+            delete ref->target;
+            *link = ref->next;
+            delete ref;
+        }
+        else {
+            link = &ref->next;
+        }
+    }
+
+    if (other.freeList) {
+        Node* tail = other.freeList;
+        while (tail->getLeft())
+            tail = tail->getLeft();
+        tail->setLeft(freeList);
+        freeList = other.freeList;
+    }
+
+    other.slabs = nullptr;
+    other.shared = nullptr;
+    other.cursor = other.limit = other.freeList = nullptr;
+}
+
+/**
+ * Converts this pool's own slabs into a shared list, then gives the other
+ * pool a reference to each shared list this pool holds and it does not.
+ * The bump cursor may keep pointing into a shared slab, since this pool
+ * still owns it.
+ */
+void NodePool::share(NodePool& other) {
+    if (&other == this) return;
+
+    if (slabs) {
+        SharedSlabs* owned = new SharedSlabs;
+        owned->refs.store(1);
+        owned->slabs = slabs;
+        shared = new SharedRef{ owned, shared };
+        slabs = nullptr;
+    }
+
+    for (SharedRef* ref = shared; ref; ref = ref->next) {
+        if (other.holds(ref->target))
+            continue;
+        ref->target->refs.fetch_add(1);
+        other.shared = new SharedRef{ ref->target, other.shared };
+    }
+}
+
+/**
+ * Frees the pool's own slabs in one pass over the slab list, drops its
+ * references to shared slabs (freeing any that become unreferenced), and
+ * resets the pool to its empty state.
+ */
+void NodePool::releaseAll() {
+    freeSlabs(slabs);
+    slabs = nullptr;
+
+    while (shared) {
+        SharedRef* next = shared->next;
+        if (shared->target->refs.fetch_sub(1) == 1) {
+            freeSlabs(shared->target->slabs);
+            delete shared->target;
+        }
+        delete shared;
+        shared = next;
+    }
+
+    cursor = limit = freeList = nullptr;
+}
+
+std::size_t NodePool::nodesPerSlab() const {
+    return slabCapacity;
+}
+
+/**
+ * Counts the pool's own slabs and the slabs of every distinct shared list
+ * it holds.
+ */
+std::size_t NodePool::slabCount() const {
+    std::size_t count = 0;
+    for (const Slab* s = slabs; s; s = s->next)
+        count++;
+    for (const SharedRef* ref = shared; ref; ref = ref->next) {
+        if (!firstRef(ref)) continue;
+        for (const Slab* s = ref->target->slabs; s; s = s->next)
+            count++;
+    }
+    return count;
+}
+
+/**
+ * Sums slab capacities the same way slabCount() counts slabs.
+ */
+std::size_t NodePool::reservedNodes() const {
+    std::size_t nodes = 0;
+    for (const Slab* s = slabs; s; s = s->next)
+        nodes += s->capacity;
+    for (const SharedRef* ref = shared; ref; ref = ref->next) {
+        if (!firstRef(ref)) continue;
+        for (const Slab* s = ref->target->slabs; s; s = s->next)
+            nodes += s->capacity;
+    }
+    return nodes;
+}
+
+std::size_t NodePool::freeNodes() const {
+    std::size_t count = 0;
+    for (const Node* n = freeList; n; n = n->getLeft())
+        count++;
+    return count;
+}
+
+#if BST_ENABLE_STATS
+std::uint64_t NodePool::allocationCount() const {
+    return allocations;
+}
+
+std::uint64_t NodePool::releaseCount() const {
+    return releases;
+}
+
+void NodePool::resetCounts() {
+    allocations = 0;
+    releases = 0;
+}
+#endif
+
+/**
+ * Allocates a standard slab and makes it the target of the bump cursor.
+ */
+void NodePool::addSlab() {
+    cursor = newSlab(slabCapacity);
+    limit = cursor + slabCapacity;
+}
+
+/**
+ * Allocates raw storage for the requested number of nodes and prepends the
+ * slab to the slab list.
+ */
+Node* NodePool::newSlab(std::size_t capacity) {
+    Slab* slab = new Slab;
+    slab->nodes = static_cast<Node*>(::operator new(capacity * sizeof(Node)));
+    slab->capacity = capacity;
+    slab->next = slabs;
+    slabs = slab;
+    return slab->nodes;
+}
+
+/**
+ * Linear in the number of shared references, which adopt() and share() keep
+ * to one per distinct list.
+ */
+bool NodePool::holds(const SharedSlabs* target) const {
+    for (const SharedRef* ref = shared; ref; ref = ref->next) {
+        if (ref->target == target)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Checks the references ahead of ref for the same target.
+ */
+bool NodePool::firstRef(const SharedRef* ref) const {
+    for (const SharedRef* prior = shared; prior != ref; prior = prior->next) {
+        if (prior->target == ref->target)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Deletes each slab's node storage and its header.
+ */
+void NodePool::freeSlabs(Slab* list) {
+    while (list) {
+        Slab* next = list->next;
+        ::operator delete(list->nodes);
+        delete list;
+        list = next;
+    }
+}
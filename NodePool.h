@@ -0,0 +1,245 @@
+/**
+ * @file NodePool.h
+ * @brief Declaration of the NodePool class.
+ *
+ * @details
+ * This header declares the NodePool class, a slab-based allocator that
+ * supplies Node objects to the BST. Nodes are carved out of fixed-size slabs
+ * instead of being allocated individually with new, removed nodes are
+ * recycled through a free list, and the entire pool can be released in one
+ * step.
+ *
+ * Implementation details are defined in NodePool.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "Node.h"
+
+/**
+ * @class NodePool
+ * @brief Slab allocator owning the storage of all nodes in a tree.
+ *
+ * @details
+ * The NodePool obtains raw memory in slabs that each hold a fixed number of
+ * nodes. Allocation first reuses a node from the free list and otherwise
+ * bumps a cursor through the current slab, requesting a new slab only when
+ * the current one is exhausted. This keeps nodes that are allocated together
+ * close together in memory and removes the general-purpose allocator from the
+ * per-insert path.
+ *
+ * Released nodes are threaded onto the free list through their left child
+ * pointer, so the free list itself requires no additional memory.
+ *
+ * Memory Management:
+ * The pool owns every slab it allocates. releaseAll() (also invoked by the
+ * destructor) frees the slabs themselves, which reclaims every node handed
+ * out by the pool in O(number of slabs) rather than O(number of nodes).
+ * Because Node is trivially destructible, no per-node cleanup is required.
+ *
+ * Moving subtrees between trees (BST::join(), BST::split(), and the set
+ * operations) moves nodes between pools without copying them. adopt()
+ * transfers all of another pool's storage to this one. share() instead lets
+ * two pools co-own their slabs, because after a split both trees hold nodes
+ * from the same slabs: shared slabs are reference counted and freed when
+ * the last pool referencing them is released. A shared slab therefore
+ * stays allocated for as long as either tree holds any node from it, so a
+ * small tree can keep a much larger tree's storage alive; BST::split()
+ * avoids sharing when one side is smaller than a slab by copying that side
+ * into its own pool instead.
+ *
+ * @see Node
+ * @see BST
+ */
+
+class NodePool {
+public:
+    /**
+     * @brief Constructs an empty pool.
+     * @param nodesPerSlab Number of nodes carved out of each slab.
+     */
+    explicit NodePool(std::size_t nodesPerSlab = 4096);
+
+    /**
+     * @brief Destroys the pool and frees all slabs.
+     */
+    ~NodePool();
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * @brief Allocates and constructs a node holding the given value.
+     * @param value The integer value stored in the node.
+     * @return Pointer to the newly constructed node.
+     */
+    Node* allocate(int value);
+
+    /**
+     * @brief Reserves storage for count nodes in one contiguous block.
+     * @param count Number of consecutive node slots required.
+     * @return Pointer to uninitialized storage for count nodes. Each slot
+     *         must be constructed with placement new before use.
+     * @details The block is placed in a dedicated slab sized to fit it
+     * exactly, so bulk-built trees occupy a single contiguous region.
+     */
+    Node* allocateBlock(std::size_t count);
+
+    /**
+     * @brief Returns a single node to the pool for later reuse.
+     * @param n Pointer to a node previously obtained from this pool.
+     */
+    void release(Node* n);
+
+    /**
+     * @brief Returns a chain of nodes to the pool in O(1).
+     * @param first First node of the chain.
+     * @param last  Last node of the chain.
+     * @param count Number of nodes in the chain, for the release counter.
+     * @details The nodes must already be linked from first to last through
+     * their left pointers, the same layout the free list uses.
+     */
+    void releaseChain(Node* first, Node* last, std::size_t count);
+
+    /**
+     * @brief Takes over all of another pool's storage and free nodes.
+     * @param other Pool to empty; its nodes stay valid and now belong to this pool.
+     * @details Shared lists are kept once each, and a list no other pool
+     * references any more becomes owned storage again.
+     */
+    void adopt(NodePool& other);
+
+    /**
+     * @brief Makes another pool a co-owner of this pool's current storage.
+     * @param other Pool that will keep this pool's slabs alive as well.
+     * @details Used when nodes allocated here end up in two trees. The
+     * shared slabs are freed once both pools have released them, even if
+     * one pool only still uses a few of their nodes.
+     */
+    void share(NodePool& other);
+
+    /**
+     * @brief Frees every slab, invalidating all nodes from this pool.
+     * @details Shared slabs are only freed if no other pool still
+     * references them.
+     */
+    void releaseAll();
+
+    /**
+     * @brief Returns the number of nodes carved out of each regular slab.
+     */
+    std::size_t nodesPerSlab() const;
+
+    /**
+     * @brief Returns the number of slabs the pool holds, owned or shared.
+     * @details Each shared list is counted once, however it was reached.
+     */
+    std::size_t slabCount() const;
+
+    /**
+     * @brief Returns the total node capacity of the slabs the pool holds.
+     * @details Each shared list is counted once per pool; shared slabs
+     * are counted by every pool that holds them.
+     */
+    std::size_t reservedNodes() const;
+
+    /**
+     * @brief Returns the number of released nodes waiting on the free list.
+     * @note Runs in O(length of the free list).
+     */
+    std::size_t freeNodes() const;
+
+#if BST_ENABLE_STATS
+    /**
+     * @brief Returns the number of nodes handed out since the last reset.
+     */
+    std::uint64_t allocationCount() const;
+
+    /**
+     * @brief Returns the number of nodes released individually or in
+     *        chains since the last reset.
+     * @details Freeing whole slabs through releaseAll() is not counted.
+     */
+    std::uint64_t releaseCount() const;
+
+    /**
+     * @brief Zeroes the allocation and release counters.
+     */
+    void resetCounts();
+#endif
+
+private:
+    /**
+     * @brief Header describing one slab of node storage.
+     */
+    struct Slab {
+        Slab* next;
+        Node* nodes;
+        std::size_t capacity;
+    };
+
+    /**
+     * @brief A list of slabs co-owned by several pools.
+     */
+    struct SharedSlabs {
+        std::atomic<std::size_t> refs;
+        Slab* slabs;
+    };
+
+    /**
+     * @brief One pool's reference to a SharedSlabs list.
+     */
+    struct SharedRef {
+        SharedSlabs* target;
+        SharedRef* next;
+    };
+
+    std::size_t slabCapacity;
+    Slab* slabs;
+    SharedRef* shared;
+    Node* cursor;
+    Node* limit;
+    Node* freeList;
+#if BST_ENABLE_STATS
+    std::uint64_t allocations = 0;
+    std::uint64_t releases = 0;
+#endif
+
+    /**
+     * @brief Allocates a fresh slab and makes it the bump target.
+     */
+    void addSlab();
+
+    /**
+     * @brief Allocates a slab of the given capacity and links it in.
+     * @return Pointer to the slab's node storage.
+     */
+    Node* newSlab(std::size_t capacity);
+
+    /**
+     * @brief Returns true if the pool already references the shared list.
+     */
+    bool holds(const SharedSlabs* target) const;
+
+    /**
+     * @brief Returns true if no earlier reference in the list has ref's target.
+     */
+    bool firstRef(const SharedRef* ref) const;
+
+    /**
+     * @brief Frees a list of slabs and their node storage.
+     */
+    static void freeSlabs(Slab* list);
+};
+
+#endif // NODEPOOL_H
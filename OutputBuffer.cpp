@@ -0,0 +1,84 @@
+/**
+ * @file OutputBuffer.cpp
+ * @brief Implementation of the OutputBuffer class.
+ *
+ * @details
+ * This file contains the implementation of the chunked output buffer. The
+ * buffer is always flushed before it could overflow, so every append is a
+ * bounds check followed by a plain memory write.
+ */
+
+#include "OutputBuffer.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+/**
+ * Longest decimal representation of a long long, including the sign.
+ */
+const std::size_t kMaxIntChars = 20;
+
+} // namespace
+
+/**
+ * Allocates the buffer; capacities too small to hold one integer are
+ * raised so appendInt() can always format in place.
+ */
+OutputBuffer::OutputBuffer(std::FILE* stream, std::size_t size)
+    : out(stream), buffer(nullptr),
+      capacity(size < kMaxIntChars ? kMaxIntChars : size), used(0) {
+    buffer = new char[capacity];
+}
+
+/**
+ * Flushes pending output before releasing the buffer.
+ */
+OutputBuffer::~OutputBuffer() {
+    flush();
+    delete[] buffer;
+}
+
+/**
+ * Formats the value directly into the buffer with std::to_chars.
+ */
+void OutputBuffer::appendInt(long long value) {
+    if (capacity - used < kMaxIntChars)
+        flush();
+
+    std::to_chars_result result = std::to_chars(buffer + used, buffer + capacity, value);
+    used = static_cast<std::size_t>(result.ptr - buffer);
+}
+
+void OutputBuffer::append(char c) {
+    if (used == capacity)
+        flush();
+    buffer[used++] = c;
+}
+
+/**
+ * Copies the text into the buffer, flushing as often as needed; text longer
+ * than the whole buffer is written through directly.
+ */
+void OutputBuffer::append(const char* text, std::size_t length) {
+    if (length > capacity - used)
+        flush();
+
+    if (length > capacity) {
+        std::fwrite(text, 1, length, out);
+        return;
+    }
+
+    std::memcpy(buffer + used, text, length);
+    used += length;
+}
+
+/**
+ * Hands the pending bytes to the stream in a single fwrite().
+ */
+void OutputBuffer::flush() {
+    if (used) {
+        std::fwrite(buffer, 1, used, out);
+        used = 0;
+    }
+}
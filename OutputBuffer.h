@@ -0,0 +1,88 @@
+/**
+ * @file OutputBuffer.h
+ * @brief Declaration of the OutputBuffer class.
+ *
+ * @details
+ * This header declares OutputBuffer, a large fixed-size character buffer
+ * that formats integers and text in memory and hands them to a C stream in
+ * large chunks. It replaces per-value formatted stream output for bulk
+ * dumps of tree contents.
+ *
+ * Implementation details are defined in OutputBuffer.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <cstddef>
+#include <cstdio>
+
+/**
+ * @class OutputBuffer
+ * @brief Chunked writer that formats integers with std::to_chars.
+ *
+ * @details
+ * Writing each value with std::cout << value costs a locale-aware formatting
+ * call and a stream-state check per value. OutputBuffer instead converts
+ * integers with std::to_chars directly into a single heap buffer (64 KiB by
+ * default) and issues one fwrite() whenever the buffer fills. A chunk that
+ * large bypasses the C stream's own buffer, so each flush is normally a
+ * single write system call.
+ *
+ * The buffer is flushed automatically by the destructor. The OutputBuffer
+ * does not own the FILE stream it writes to.
+ */
+
+class OutputBuffer {
+public:
+    /**
+     * @brief Constructs a buffer that writes to the given stream.
+     * @param out      Destination stream (for example stdout).
+     * @param capacity Buffer size in bytes.
+     */
+    explicit OutputBuffer(std::FILE* out, std::size_t capacity = 1 << 16);
+
+    /**
+     * @brief Flushes any pending output and frees the buffer.
+     */
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /**
+     * @brief Appends the decimal representation of an integer.
+     */
+    void appendInt(long long value);
+
+    /**
+     * @brief Appends a single character.
+     */
+    void append(char c);
+
+    /**
+     * @brief Appends a run of characters.
+     * @param text   Pointer to the characters.
+     * @param length Number of characters to append.
+     */
+    void append(const char* text, std::size_t length);
+
+    /**
+     * @brief Writes all pending output to the stream.
+     */
+    void flush();
+
+private:
+    std::FILE* out;
+    char* buffer;
+    std::size_t capacity;
+    std::size_t used;
+};
+
+#endif // OUTPUTBUFFER_H
@@ -0,0 +1,332 @@
+/**
+ * @file PersistentBST.cpp
+ * @brief Implementation of the PersistentBST class.
+ *
+ * @details
+ * This file contains the path-copying AVL operations and the reference
+ * counting that reclaims superseded versions.
+ *
+ * Functions that build trees follow one ownership rule: node pointers
+ * passed in are references the callee takes over, and the node returned is
+ * a reference the caller owns. Reusing a subtree from an existing version
+ * therefore always goes through retain(), and a node that is only being
+ * read (such as a child being rotated up) is released once its parts have
+ * been retained into the new nodes. A freshly built node released this way
+ * is freed at once, so rotations never leak intermediate copies.
+ */
+
+#include "PersistentBST.h"
+#include "OutputBuffer.h"
+#include <iostream>
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// Snapshot
+// ---------------------------------------------------------------------------
+
+PersistentBST::Snapshot::Snapshot() : root(nullptr), count(0) {}
+
+/**
+ * Adopts a reference the caller has already taken.
+ */
+PersistentBST::Snapshot::Snapshot(PNode* root, std::size_t count) : root(root), count(count) {}
+
+PersistentBST::Snapshot::Snapshot(const Snapshot& other) : root(retain(other.root)), count(other.count) {}
+
+PersistentBST::Snapshot::Snapshot(Snapshot&& other) noexcept : root(other.root), count(other.count) {
+    other.root = nullptr;
+    other.count = 0;
+}
+
+/**
+ * Copy-and-swap: other is already a copy (or moved-from value), so
+ * swapping hands our old version to its destructor.
+ */
+PersistentBST::Snapshot& PersistentBST::Snapshot::operator=(Snapshot other) noexcept {
+    std::swap(root, other.root);
+    std::swap(count, other.count);
+    return *this;
+}
+
+PersistentBST::Snapshot::~Snapshot() {
+    release(root);
+}
+
+bool PersistentBST::Snapshot::search(int value) const {
+    return searchFrom(root, value);
+}
+
+std::size_t PersistentBST::Snapshot::size() const {
+    return count;
+}
+
+bool PersistentBST::Snapshot::isEmpty() const {
+    return root == nullptr;
+}
+
+/**
+ * Formats every value into an OutputBuffer during an in-order visit.
+ */
+void PersistentBST::Snapshot::writeInorder(std::FILE* out) const {
+    OutputBuffer buffer(out);
+
+    forEachInorder([&buffer](int value) {
+        buffer.appendInt(value);
+        buffer.append(' ');
+    });
+
+    buffer.append('\n');
+}
+
+void PersistentBST::Snapshot::inorder() const {
+    if (!root) return;
+
+    std::cout.flush();
+    writeInorder(stdout);
+    std::fflush(stdout);
+}
+
+// ---------------------------------------------------------------------------
+// PersistentBST
+// ---------------------------------------------------------------------------
+
+PersistentBST::PersistentBST() : root(nullptr), nodeCount(0) {}
+
+PersistentBST::~PersistentBST() {
+    release(root);
+}
+
+/**
+ * Records the search path through the current version, then builds a new
+ * leaf and copies the path above it, rebalancing each copy.
+ */
+bool PersistentBST::insert(int value) {
+    std::lock_guard<std::mutex> writer(writeMutex);
+
+    PNode* path[kMaxHeight];
+    bool wentLeft[kMaxHeight];
+    int depth = 0;
+
+    for (PNode* current = root; current; ) {
+        if (value == current->value)
+            return false;
+
+        path[depth] = current;
+        wentLeft[depth] = value < current->value;
+        current = wentLeft[depth] ? current->left : current->right;
+        depth++;
+    }
+
+    PNode* newRoot = rebuild(path, wentLeft, depth, make(value, nullptr, nullptr));
+    publish(newRoot, nodeCount + 1);
+    return true;
+}
+
+/**
+ * Records the path to the node holding value. A node with at most one child
+ * is replaced by that child. A node with two children is replaced by a copy
+ * carrying its in-order successor's value, over the right subtree with the
+ * successor removed; that subtree's left spine is copied as well.
+ */
+bool PersistentBST::remove(int value) {
+    std::lock_guard<std::mutex> writer(writeMutex);
+
+    PNode* path[kMaxHeight];
+    bool wentLeft[kMaxHeight];
+    int depth = 0;
+
+    PNode* target = root;
+    while (target && target->value != value) {
+        path[depth] = target;
+        wentLeft[depth] = value < target->value;
+        target = wentLeft[depth] ? target->left : target->right;
+        depth++;
+    }
+
+    if (!target)
+        return false;
+
+    PNode* replacement;
+    if (!target->left || !target->right) {
+        replacement = retain(target->left ? target->left : target->right);
+    }
+    else {
+        PNode* spine[kMaxHeight];
+        bool spineLeft[kMaxHeight];
+        int spineDepth = 0;
+
+        PNode* successor = target->right;
+        while (successor->left) {
+            spine[spineDepth] = successor;
+            spineLeft[spineDepth] = true;
+            successor = successor->left;
+            spineDepth++;
+        }
+
+        PNode* right = rebuild(spine, spineLeft, spineDepth, retain(successor->right));
+        replacement = balance(successor->value, retain(target->left), right);
+    }
+
+    PNode* newRoot = rebuild(path, wentLeft, depth, replacement);
+    publish(newRoot, nodeCount - 1);
+    return true;
+}
+
+/**
+ * Searches through a short-lived snapshot so the version cannot be freed
+ * mid-search.
+ */
+bool PersistentBST::search(int value) const {
+    return snapshot().search(value);
+}
+
+std::size_t PersistentBST::size() const {
+    std::lock_guard<std::mutex> guard(rootMutex);
+    return nodeCount;
+}
+
+/**
+ * The root's reference is taken under the lock that publish() swaps roots
+ * under, so the root cannot be released between reading it and retaining it.
+ */
+PersistentBST::Snapshot PersistentBST::snapshot() const {
+    std::lock_guard<std::mutex> guard(rootMutex);
+    return Snapshot(retain(root), nodeCount);
+}
+
+int PersistentBST::heightOf(const PNode* node) {
+    return node ? node->height : 0;
+}
+
+PersistentBST::PNode* PersistentBST::retain(PNode* node) {
+    if (node)
+        node->refs.fetch_add(1, std::memory_order_relaxed);
+    return node;
+}
+
+/**
+ * Frees the node if this was its last reference, then drops the references
+ * it held on its children. The nodes being freed form a tree, and each
+ * visited node pushes at most two children, so a depth-first walk needs at
+ * most kMaxHeight stack slots.
+ */
+void PersistentBST::release(PNode* node) {
+    PNode* stack[kMaxHeight + 1];
+    int depth = 0;
+
+    if (node)
+        stack[depth++] = node;
+
+    while (depth > 0) {
+        PNode* current = stack[--depth];
+        if (current->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            continue;
+
+        if (current->left)
+            stack[depth++] = current->left;
+        if (current->right)
+            stack[depth++] = current->right;
+        delete current;
+    }
+}
+
+PersistentBST::PNode* PersistentBST::make(int value, PNode* left, PNode* right) {
+    PNode* node = new PNode;
+    node->value = value;
+    node->left = left;
+    node->right = right;
+    int lh = heightOf(left);
+    int rh = heightOf(right);
+    node->height = 1 + (lh > rh ? lh : rh);
+    node->refs.store(1, std::memory_order_relaxed);
+    return node;
+}
+
+/**
+ * The four AVL cases, with each rotation expressed as building new nodes
+ * from the retained pieces of the heavy child (and, for double rotations,
+ * grandchild) and then releasing that child.
+ */
+PersistentBST::PNode* PersistentBST::balance(int value, PNode* left, PNode* right) {
+    int lh = heightOf(left);
+    int rh = heightOf(right);
+
+    if (lh > rh + 1) {
+        PNode* ll = left->left;
+        PNode* lr = left->right;
+        PNode* result;
+
+        if (heightOf(ll) >= heightOf(lr)) {
+            result = make(left->value, retain(ll), make(value, retain(lr), right));
+        }
+        else {
+            result = make(lr->value,
+                make(left->value, retain(ll), retain(lr->left)),
+                make(value, retain(lr->right), right));
+        }
+
+        release(left);
+        return result;
+    }
+
+    if (rh > lh + 1) {
+        PNode* rl = right->left;
+        PNode* rr = right->right;
+        PNode* result;
+
+        if (heightOf(rr) >= heightOf(rl)) {
+            result = make(right->value, make(value, left, retain(rl)), retain(rr));
+        }
+        else {
+            result = make(rl->value,
+                make(value, left, retain(rl->left)),
+                make(right->value, retain(rl->right), retain(rr)));
+        }
+
+        release(right);
+        return result;
+    }
+
+    return make(value, left, right);
+}
+
+/**
+ * At each level the untouched sibling subtree is shared with the old
+ * version (retained) and the rebuilt child is owned.
+ */
+PersistentBST::PNode* PersistentBST::rebuild(PNode* const* path, const bool* wentLeft, int depth, PNode* subtree) {
+    for (int i = depth - 1; i >= 0; i--) {
+        PNode* old = path[i];
+        if (wentLeft[i])
+            subtree = balance(old->value, subtree, retain(old->right));
+        else
+            subtree = balance(old->value, retain(old->left), subtree);
+    }
+
+    return subtree;
+}
+
+/**
+ * The old root's reference is dropped after the lock is released, since
+ * freeing the superseded path can take a while.
+ */
+void PersistentBST::publish(PNode* newRoot, std::size_t newCount) {
+    PNode* oldRoot;
+    {
+        std::lock_guard<std::mutex> guard(rootMutex);
+        oldRoot = root;
+        root = newRoot;
+        nodeCount = newCount;
+    }
+
+    release(oldRoot);
+}
+
+bool PersistentBST::searchFrom(const PNode* node, int value) {
+    while (node) {
+        if (value == node->value)
+            return true;
+        node = value < node->value ? node->left : node->right;
+    }
+    return false;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file PersistentBST.h
+ * @brief Declaration of the PersistentBST class.
+ *
+ * @details
+ * This header declares PersistentBST, a persistent (path-copying) AVL tree
+ * of integers. Nodes are never modified once they are part of a published
+ * tree: insert() and remove() build new copies of the O(log n) nodes on the
+ * path from the root and share every other subtree with the previous
+ * version. A consistent view of the tree is therefore just a reference to
+ * some version's root, and taking one (snapshot()) costs O(1) no matter how
+ * large the tree is.
+ *
+ * Implementation details are defined in PersistentBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef PERSISTENTBST_H
+#define PERSISTENTBST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+
+/**
+ * @class PersistentBST
+ * @brief AVL tree with O(1) snapshots for readers that run alongside writers.
+ *
+ * @details
+ * Every node carries an atomic reference count: one reference for each
+ * parent that links to it and one for each tree version or Snapshot whose
+ * root it is. When a writer publishes a new root, it drops the old root's
+ * reference. Any node that no remaining version reaches is then freed, and
+ * nodes still shared with newer versions or held by snapshots stay alive.
+ * A long scan over a snapshot never blocks writers and never sees a
+ * half-applied update, and its nodes remain valid until the snapshot is
+ * destroyed, even if the PersistentBST itself is destroyed first.
+ *
+ * Writers are serialized by a mutex. Publishing a new root and taking a
+ * snapshot both hold a second, short-lived lock for only a pointer swap or
+ * a reference-count increment, so readers never wait for a write to finish.
+ *
+ * Each insert() or remove() allocates O(log n) nodes and frees the path
+ * nodes of the superseded version unless a snapshot still holds them.
+ */
+
+class PersistentBST {
+private:
+    struct PNode;
+
+public:
+    /**
+     * @class Snapshot
+     * @brief An immutable view of the tree as of one published version.
+     *
+     * @details
+     * Copying a snapshot shares the same version and costs one
+     * reference-count increment. A default-constructed snapshot is empty.
+     */
+    class Snapshot {
+    public:
+        Snapshot();
+        Snapshot(const Snapshot& other);
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot other) noexcept;
+        ~Snapshot();
+
+        /**
+         * @brief Searches for a value in this version.
+         * @return true if found, false otherwise.
+         */
+        bool search(int value) const;
+
+        /**
+         * @brief Returns the number of values in this version.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Returns true if this version holds no values.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Calls a visitor with every value in ascending order.
+         * @param visit Callable invoked as visit(int) for each value.
+         */
+        template <class Visitor>
+        void forEachInorder(Visitor visit) const;
+
+        /**
+         * @brief Calls a visitor with every value in [low, high), ascending.
+         * @param low   Inclusive lower bound.
+         * @param high  Exclusive upper bound.
+         * @param visit Callable invoked as visit(int) for each value.
+         * @note Runs in O(height + k) for k visited values.
+         */
+        template <class Visitor>
+        void forEachInRange(int low, int high, Visitor visit) const;
+
+        /**
+         * @brief Writes all values in ascending order to a C stream.
+         * @param out Destination stream.
+         */
+        void writeInorder(std::FILE* out) const;
+
+        /**
+         * @brief Prints all values in ascending order to standard output.
+         */
+        void inorder() const;
+
+    private:
+        friend class PersistentBST;
+
+        PNode* root;
+        std::size_t count;
+
+        Snapshot(PNode* root, std::size_t count);
+    };
+
+    /**
+     * @brief Constructs an empty tree.
+     */
+    PersistentBST();
+
+    /**
+     * @brief Drops the current version. Outstanding snapshots stay valid.
+     */
+    ~PersistentBST();
+
+    PersistentBST(const PersistentBST&) = delete;
+    PersistentBST& operator=(const PersistentBST&) = delete;
+
+    /**
+     * @brief Publishes a new version containing value.
+     * @param value The integer value to insert.
+     * @return true if inserted, false if the value was already present
+     *         (no new version is published).
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Publishes a new version without value.
+     * @param value The value to remove.
+     * @return true if the value was found and removed, false otherwise.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Searches the current version for a value.
+     * @return true if found, false otherwise.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Returns the number of values in the current version.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Takes an O(1) snapshot of the current version.
+     * @return A Snapshot that stays consistent while writers continue.
+     */
+    Snapshot snapshot() const;
+
+private:
+    /**
+     * @struct PNode
+     * @brief Immutable tree node with an intrusive reference count.
+     */
+    struct PNode {
+        int value;
+        int height;
+        PNode* left;
+        PNode* right;
+        std::atomic<unsigned int> refs;
+    };
+
+    /**
+     * @brief Bound on the height of any AVL tree this class can hold.
+     * @details An AVL tree with 2^32 nodes is less than 1.45 * 32 < 48
+     *          levels high, so this leaves ample headroom.
+     */
+    static const int kMaxHeight = 96;
+
+    PNode* root;
+    std::size_t nodeCount;
+    /** Serializes insert() and remove(). */
+    std::mutex writeMutex;
+    /** Guards root and nodeCount against a concurrent snapshot(). */
+    mutable std::mutex rootMutex;
+
+    static int heightOf(const PNode* node);
+
+    /**
+     * @brief Adds a reference to a node (if any) and returns it.
+     */
+    static PNode* retain(PNode* node);
+
+    /**
+     * @brief Drops a reference; frees the node and, transitively, any
+     *        children whose last reference it held.
+     */
+    static void release(PNode* node);
+
+    /**
+     * @brief Creates a node, taking ownership of the references to left and right.
+     */
+    static PNode* make(int value, PNode* left, PNode* right);
+
+    /**
+     * @brief Creates an AVL-balanced node from value and two subtrees whose
+     *        heights differ by at most two, taking ownership of both.
+     * @details Rotations build new nodes instead of relinking existing
+     *          ones, because the subtrees may be shared with other versions.
+     */
+    static PNode* balance(int value, PNode* left, PNode* right);
+
+    /**
+     * @brief Rebuilds a copied path bottom-up above a new subtree.
+     * @param path      Nodes from the root down, of the old version.
+     * @param wentLeft  Direction taken at each node of path.
+     * @param depth     Number of nodes in path.
+     * @param subtree   Owned replacement for the subtree below path[depth - 1].
+     * @return The owned root of the new version.
+     */
+    static PNode* rebuild(PNode* const* path, const bool* wentLeft, int depth, PNode* subtree);
+
+    /**
+     * @brief Swaps in a new root and drops the reference to the old one.
+     */
+    void publish(PNode* newRoot, std::size_t newCount);
+
+    static bool searchFrom(const PNode* node, int value);
+};
+
+// ---------------------------------------------------------------------------
+// Template member definitions
+// ---------------------------------------------------------------------------
+
+/**
+ * In-order walk with a fixed-size explicit stack; the AVL height bound
+ * keeps it from overflowing.
+ */
+template <class Visitor>
+void PersistentBST::Snapshot::forEachInorder(Visitor visit) const {
+    const PNode* stack[kMaxHeight];
+    int depth = 0;
+    const PNode* current = root;
+
+    while (current || depth > 0) {
+        while (current) {
+            stack[depth++] = current;
+            current = current->left;
+        }
+
+        current = stack[--depth];
+        visit(current->value);
+        current = current->right;
+    }
+}
+
+/**
+ * Seeds the stack with the ancestors whose values are at least low, which
+ * is exactly the stack an in-order walk would hold on reaching the first
+ * value in range, then walks forward until a value reaches high.
+ */
+template <class Visitor>
+void PersistentBST::Snapshot::forEachInRange(int low, int high, Visitor visit) const {
+    const PNode* stack[kMaxHeight];
+    int depth = 0;
+    const PNode* current = root;
+
+    while (current) {
+        if (current->value < low) {
+            current = current->right;
+        }
+        else {
+            stack[depth++] = current;
+            current = current->left;
+        }
+    }
+
+    while (depth > 0) {
+        current = stack[--depth];
+        if (current->value >= high)
+            return;
+        visit(current->value);
+
+        for (current = current->right; current; current = current->left)
+            stack[depth++] = current;
+    }
+}
+
+#endif // PERSISTENTBST_H
@@ -9,46 +9,44 @@
  * 
  * The implementation is intentionally pointer-based and avoids the use of
  * STL containers or smart pointers to demonstrate fundamental memory management
- * concepts in C++. 
+ * concepts in C++. Elements are kept in a raw ring buffer.
  */
 
 #include "Queue.h"
-#include <iostream>
 
 /**
- * Destroys the queue by removing all remaining nodes.
+ * Creates an empty queue, optionally reserving an initial buffer.
+ */
+Queue::Queue(std::size_t initialCapacity)
+    : items(nullptr), head(0), count(0), capacity(0) {
+    reserve(initialCapacity);
+}
+
+/**
+ * Destroys the queue by releasing its buffer.
  */
 Queue::~Queue() {
-    // Remove all nodes from front to rear.
-    while (!isEmpty()) {
-        dequeue();
-    }
+    delete[] items;
 }
 
 /**
- * Appends a node to the queue.
+ * Appends a node to the queue, doubling the buffer when it is full.
  */
 void Queue::enqueue(Node* n) {
-    QueueNode* q = new QueueNode(n);
-    if (!rear) {
-        front = rear = q;
-    }
-    else {
-        rear->next = q;
-        rear = q;
-    }
+    if (count == capacity)
+        reserve(capacity ? capacity * 2 : 16);
+    items[(head + count) & (capacity - 1)] = n;
+    count++;
 }
 
 /**
  * Dequeues the front element and returns the associated tree node pointer.
  */
 Node* Queue::dequeue() {
-    if (!front) return nullptr;
-    QueueNode* temp = front;
-    Node* result = temp->data;
-    front = front->next;
-    if (!front) rear = nullptr;
-    delete temp;
+    if (count == 0) return nullptr;
+    Node* result = items[head];
+    head = (head + 1) & (capacity - 1);
+    count--;
     return result;
 }
 
@@ -56,5 +54,41 @@ Node* Queue::dequeue() {
  * Determines whether the queue has any elements.
  */
 bool Queue::isEmpty() const {
-    return front == nullptr;
+    return count == 0;
+}
+
+/**
+ * Reports the number of stored elements.
+ */
+std::size_t Queue::size() const {
+    return count;
+}
+
+/**
+ * Grows the buffer to the next power of two that holds the requested
+ * capacity, unwrapping the existing elements to the front of the new buffer.
+ */
+void Queue::reserve(std::size_t minCapacity) {
+    if (minCapacity <= capacity) return;
+
+    std::size_t newCapacity = capacity ? capacity : 16;
+    while (newCapacity < minCapacity)
+        newCapacity *= 2;
+
+    Node** grown = new Node*[newCapacity];
+    for (std::size_t i = 0; i < count; i++)
+        grown[i] = items[(head + i) & (capacity - 1)];
+
+    delete[] items;
+    items = grown;
+    head = 0;
+    capacity = newCapacity;
+}
+
+/**
+ * Forgets all elements; the buffer is kept for reuse.
+ */
+void Queue::clear() {
+    head = 0;
+    count = 0;
 }
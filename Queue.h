@@ -22,6 +22,7 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include <cstddef>
 #include "Node.h"
 
 /**
@@ -33,47 +34,41 @@
  * It is used to support non-recursive, level-order traversal operations within
  * a binary search tree.
  * 
+ * The elements are stored in a contiguous ring buffer whose capacity is always
+ * a power of two, so positions wrap with a mask instead of a division. When
+ * the buffer fills up it doubles in size, giving amortized O(1) enqueue() and
+ * dequeue() with no per-element allocation. The buffer is kept when the queue
+ * is emptied, so a Queue that is reused across traversals stops allocating
+ * once it has grown to the widest level it needs.
+ *
  * The Queue does not assume ownership of the tree nodes it stores; it manages
- * only the queue nodes required to support these operations.
+ * only the buffer required to support these operations.
  * 
  * Supported operations include:
  * - enqueue(): Adds a node pointer to the end of the queue.
  * - dequeue(): Removes and returns a node pointer from the front of the queue.
  * - isEmpty(): Checks whether the queue is empty.
+ * - size(): Returns the number of stored node pointers.
+ * - reserve(): Pre-allocates capacity for a number of elements.
+ * - clear(): Removes all elements while keeping the allocated capacity.
  */
 
-/**
- * @brief Internal node type used by the Queue class.
- *
- * @details
- * QueueNode stores a pointer to a tree Node and a link to the next queue node.
- * This struct is used only to implement the queue's internal linked list and
- * does not assume ownership of the Node* it stores.
- */
-struct QueueNode {
-    Node* data;
-    QueueNode* next;
-
-    /**
-     * @brief Constructs a QueueNode with the specified node pointer.
-     * @param data Pointer to the Node stored in this queue element.
-     */
-    QueueNode(Node* data) : data(data), next(nullptr) {}
-};
-
 class Queue {
 public:
     /**
      * @brief Constructs an empty queue.
-     * @note Initializes the queue with its front and rear pointers set to nullptr.
+     * @param initialCapacity Number of elements to reserve up front.
      */
-    Queue() : front(nullptr), rear(nullptr) {}
+    explicit Queue(std::size_t initialCapacity = 0);
 
     /**
-     * @brief Destroys the Queue.
+     * @brief Destroys the Queue and frees its buffer.
      */
     ~Queue();
 
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
     /**
      * @brief Adds a node to the end of the queue.
      * @param n Pointer to the Node added to the rear of the queue.
@@ -82,7 +77,7 @@ public:
 
     /**
      * @brief Removes and returns the node at the front of the queue.
-     * @return Pointer to the node removed from the queue.
+     * @return Pointer to the node removed from the queue, or nullptr if empty.
      */
     Node* dequeue();
 
@@ -92,9 +87,27 @@ public:
      */
     bool isEmpty() const;
 
+    /**
+     * @brief Returns the number of elements in the queue.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Ensures capacity for at least the given number of elements.
+     * @param capacity Minimum number of elements the buffer must hold.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Removes all elements without releasing the buffer.
+     */
+    void clear();
+
 private:
-    QueueNode* front;
-    QueueNode* rear;
+    Node** items;
+    std::size_t head;
+    std::size_t count;
+    std::size_t capacity;
 };
 
 #endif // QUEUE_H
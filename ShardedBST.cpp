@@ -0,0 +1,337 @@
+/**
+ * @file ShardedBST.cpp
+ * @brief Implementation of the ShardedBST class.
+ *
+ * @details
+ * This file contains shard routing, splitter learning, and the parallel
+ * batch operations. Routing is a binary search over the splitters, which
+ * for any practical shard count fit in a cache line or two.
+ */
+
+#include "ShardedBST.h"
+#include "OutputBuffer.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/**
+ * A batch lookup remembers each value's position so results can be
+ * scattered back into caller order after sorting.
+ */
+struct Query {
+    int value;
+    std::size_t index;
+};
+
+std::size_t defaultShardCount() {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+std::size_t poolSize(std::size_t shardCount) {
+    std::size_t hardware = defaultShardCount();
+    return shardCount < hardware ? shardCount : hardware;
+}
+
+} // namespace
+
+/**
+ * Initial splitters divide [INT_MIN, INT_MAX] into equal-width ranges.
+ */
+ShardedBST::ShardedBST(std::size_t shardCount, BalancePolicy policy)
+    : count(shardCount ? shardCount : defaultShardCount()),
+      policy(policy), pool(poolSize(count)) {
+    shards = new Shard[count];
+    for (std::size_t i = 0; i < count; i++)
+        shards[i].tree = new BST(policy);
+
+    splitters = new int[count - 1];
+    const std::int64_t width = (static_cast<std::int64_t>(1) << 32) / static_cast<std::int64_t>(count);
+    for (std::size_t i = 0; i + 1 < count; i++)
+        splitters[i] = static_cast<int>(INT_MIN + width * static_cast<std::int64_t>(i + 1));
+}
+
+ShardedBST::~ShardedBST() {
+    for (std::size_t i = 0; i < count; i++)
+        delete shards[i].tree;
+    delete[] shards;
+    delete[] splitters;
+}
+
+/**
+ * BST::insert() reports nothing, so a change in size tells whether the
+ * value was new.
+ */
+bool ShardedBST::insert(int value) {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+    Shard& shard = shards[shardFor(value)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::size_t before = shard.tree->size();
+    shard.tree->insert(value);
+    return shard.tree->size() != before;
+}
+
+bool ShardedBST::search(int value) const {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+    const Shard& shard = shards[shardFor(value)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.tree->search(value);
+}
+
+bool ShardedBST::remove(int value) {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+    Shard& shard = shards[shardFor(value)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.tree->remove(value);
+}
+
+std::size_t ShardedBST::size() const {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+    std::size_t total = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        total += shards[i].tree->size();
+    }
+
+    return total;
+}
+
+std::size_t ShardedBST::shardCount() const {
+    return count;
+}
+
+std::size_t ShardedBST::shardSize(std::size_t shard) const {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+    std::lock_guard<std::mutex> lock(shards[shard].mutex);
+    return shards[shard].tree->size();
+}
+
+/**
+ * Sorts and deduplicates a private copy of the batch, learns splitters from
+ * it if the container is empty, then inserts each shard's run in parallel.
+ * An empty shard is replaced by a tree bulk-built from its run; a non-empty
+ * one receives its run by ordinary insertion.
+ */
+std::size_t ShardedBST::insertBatch(const int* values, std::size_t n) {
+    if (n == 0)
+        return 0;
+
+    int* sorted = new int[n];
+    std::copy(values, values + n, sorted);
+    std::sort(sorted, sorted + n);
+    n = static_cast<std::size_t>(std::unique(sorted, sorted + n) - sorted);
+
+    {
+        std::unique_lock<std::shared_mutex> layout(layoutMutex);
+        bool empty = true;
+        for (std::size_t i = 0; i < count && empty; i++)
+            empty = shards[i].tree->size() == 0;
+        if (empty)
+            learnSplitters(sorted, n);
+    }
+
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+
+    std::size_t* bounds = new std::size_t[count + 1];
+    std::size_t* added = new std::size_t[count];
+    partition(sorted, n, bounds);
+
+    pool.parallelFor(count, [&](std::size_t i) {
+        added[i] = 0;
+        const int* first = sorted + bounds[i];
+        const int* last = sorted + bounds[i + 1];
+        if (first == last)
+            return;
+
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::size_t before = shard.tree->size();
+
+        if (before == 0) {
+            delete shard.tree;
+            shard.tree = new BST(first, last, policy);
+        }
+        else {
+            for (const int* p = first; p != last; ++p)
+                shard.tree->insert(*p);
+        }
+
+        added[i] = shard.tree->size() - before;
+    });
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++)
+        total += added[i];
+
+    delete[] added;
+    delete[] bounds;
+    delete[] sorted;
+    return total;
+}
+
+/**
+ * Sorts the queries with their original positions, so that each shard
+ * receives one contiguous, ascending run. Each run goes through the shard's
+ * interleaved BST::searchBatch(), and its results are scattered back.
+ */
+void ShardedBST::searchBatch(const int* values, std::size_t n, bool* results) const {
+    if (n == 0)
+        return;
+
+    Query* queries = new Query[n];
+    for (std::size_t i = 0; i < n; i++)
+        queries[i] = Query{ values[i], i };
+    std::sort(queries, queries + n, [](const Query& a, const Query& b) { return a.value < b.value; });
+
+    int* sorted = new int[n];
+    bool* hits = new bool[n];
+    for (std::size_t i = 0; i < n; i++)
+        sorted[i] = queries[i].value;
+
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+
+    std::size_t* bounds = new std::size_t[count + 1];
+    partition(sorted, n, bounds);
+
+    pool.parallelFor(count, [&](std::size_t i) {
+        std::size_t first = bounds[i];
+        std::size_t last = bounds[i + 1];
+        if (first == last)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].tree->searchBatch(sorted + first, last - first, hits + first);
+        }
+
+        for (std::size_t j = first; j < last; j++)
+            results[queries[j].index] = hits[j];
+    });
+
+    delete[] bounds;
+    delete[] hits;
+    delete[] sorted;
+    delete[] queries;
+}
+
+/**
+ * Sorts a copy of the sample to find its quantiles, then redistributes the
+ * current contents under the new splitters.
+ */
+void ShardedBST::repartition(const int* sample, std::size_t sampleCount) {
+    if (sampleCount == 0)
+        return;
+
+    int* sortedSample = new int[sampleCount];
+    std::copy(sample, sample + sampleCount, sortedSample);
+    std::sort(sortedSample, sortedSample + sampleCount);
+
+    std::unique_lock<std::shared_mutex> layout(layoutMutex);
+    learnSplitters(sortedSample, sampleCount);
+    delete[] sortedSample;
+
+    std::size_t n;
+    int* all = collectAll(n);
+    rebuildShards(all, n);
+    delete[] all;
+}
+
+/**
+ * The current contents are already sorted, so they serve directly as the
+ * sample.
+ */
+void ShardedBST::repartition() {
+    std::unique_lock<std::shared_mutex> layout(layoutMutex);
+
+    std::size_t n;
+    int* all = collectAll(n);
+    if (n > 0) {
+        learnSplitters(all, n);
+        rebuildShards(all, n);
+    }
+    delete[] all;
+}
+
+/**
+ * Formats every value into an OutputBuffer during an in-order visit.
+ */
+void ShardedBST::writeInorder(std::FILE* out) const {
+    OutputBuffer buffer(out);
+
+    forEachInorder([&buffer](int value) {
+        buffer.appendInt(value);
+        buffer.append(' ');
+    });
+
+    buffer.append('\n');
+}
+
+void ShardedBST::inorder() const {
+    std::cout.flush();
+    writeInorder(stdout);
+    std::fflush(stdout);
+}
+
+/**
+ * Counts the splitters that are not greater than value.
+ */
+std::size_t ShardedBST::shardFor(int value) const {
+    return static_cast<std::size_t>(std::upper_bound(splitters, splitters + count - 1, value) - splitters);
+}
+
+/**
+ * Splitter i is the value at the (i + 1) / count quantile, so each shard
+ * receives about n / count of the sample. Repeated sample values can yield
+ * equal splitters; the shards between them simply stay empty.
+ */
+void ShardedBST::learnSplitters(const int* sorted, std::size_t n) {
+    for (std::size_t i = 0; i + 1 < count; i++)
+        splitters[i] = sorted[(i + 1) * n / count];
+}
+
+void ShardedBST::partition(const int* sorted, std::size_t n, std::size_t* bounds) const {
+    bounds[0] = 0;
+    for (std::size_t i = 0; i + 1 < count; i++)
+        bounds[i + 1] = static_cast<std::size_t>(std::lower_bound(sorted + bounds[i], sorted + n, splitters[i]) - sorted);
+    bounds[count] = n;
+}
+
+/**
+ * Each shard is rebuilt on the pool from its run of the sorted array.
+ */
+void ShardedBST::rebuildShards(const int* sorted, std::size_t n) {
+    std::size_t* bounds = new std::size_t[count + 1];
+    partition(sorted, n, bounds);
+
+    pool.parallelFor(count, [&](std::size_t i) {
+        delete shards[i].tree;
+        shards[i].tree = new BST(sorted + bounds[i], sorted + bounds[i + 1], policy);
+    });
+
+    delete[] bounds;
+}
+
+/**
+ * Shards are ordered and disjoint, so concatenating their in-order
+ * contents yields one sorted array.
+ */
+int* ShardedBST::collectAll(std::size_t& n) const {
+    n = 0;
+    for (std::size_t i = 0; i < count; i++)
+        n += shards[i].tree->size();
+
+    int* all = new int[n > 0 ? n : 1];
+    int* out = all;
+    for (std::size_t i = 0; i < count; i++)
+        out = shards[i].tree->copyInorder(out);
+
+    return all;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file ShardedBST.h
+ * @brief Declaration of the ShardedBST class.
+ *
+ * @details
+ * This header declares ShardedBST, a container that splits the key space
+ * into contiguous ranges and keeps each range in its own independent BST
+ * (a shard) with its own lock. Point operations touch exactly one shard,
+ * so threads working on different key ranges never contend, and batch
+ * operations process all shards in parallel on a ThreadPool.
+ *
+ * Implementation details are defined in ShardedBST.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef SHARDEDBST_H
+#define SHARDEDBST_H
+
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include "BST.h"
+#include "ThreadPool.h"
+
+/**
+ * @class ShardedBST
+ * @brief Range-partitioned set of BST shards for parallel point and bulk work.
+ *
+ * @details
+ * Shard i holds the values v with splitter[i - 1] <= v < splitter[i], so
+ * the shards are ordered and disjoint, and an in-order traversal is simply
+ * each shard's traversal in turn.
+ *
+ * Splitters start out dividing the full int range evenly. Because real
+ * keys are rarely uniform, they are learned from the data: the first batch
+ * inserted into an empty container sets them to that batch's quantiles, and
+ * repartition() recomputes them from a sample or from the current contents
+ * and redistributes the values, rebuilding every shard with BST's O(n) bulk
+ * constructor.
+ *
+ * Batch operations sort their input once, which partitions it by shard as a
+ * side effect (each shard's values form one contiguous run), and then hand
+ * each run to a pool thread that holds only that shard's lock. An empty
+ * shard receiving a batch is rebuilt in one pass from the sorted run rather
+ * than by repeated insertion.
+ *
+ * A reader-writer lock protects the splitters: every operation holds it
+ * shared, so operations on different shards run in parallel, and only
+ * repartition() holds it exclusively.
+ */
+
+class ShardedBST {
+public:
+    /**
+     * @brief Constructs an empty container.
+     * @param shardCount Number of shards; 0 selects one per hardware thread.
+     * @param policy     Balancing policy of every shard.
+     * @details The thread pool has one thread per shard, capped at the
+     *          number of hardware threads.
+     */
+    explicit ShardedBST(std::size_t shardCount = 0, BalancePolicy policy = BalancePolicy::AVL);
+
+    /**
+     * @brief Destroys every shard and stops the thread pool.
+     */
+    ~ShardedBST();
+
+    ShardedBST(const ShardedBST&) = delete;
+    ShardedBST& operator=(const ShardedBST&) = delete;
+
+    /**
+     * @brief Inserts a value into its shard.
+     * @return true if inserted, false if the value was already present.
+     */
+    bool insert(int value);
+
+    /**
+     * @brief Searches the value's shard.
+     * @return true if found, false otherwise.
+     */
+    bool search(int value) const;
+
+    /**
+     * @brief Removes a value from its shard.
+     * @return true if the value was found and removed, false otherwise.
+     */
+    bool remove(int value);
+
+    /**
+     * @brief Returns the total number of values across all shards.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Returns the number of shards.
+     */
+    std::size_t shardCount() const;
+
+    /**
+     * @brief Returns the number of values held by one shard.
+     * @param shard Shard index in [0, shardCount()).
+     */
+    std::size_t shardSize(std::size_t shard) const;
+
+    /**
+     * @brief Inserts many values, processing the shards in parallel.
+     * @param values Values to insert; duplicates are ignored.
+     * @param count  Number of values.
+     * @return The number of values that were not already present.
+     * @note The first batch inserted into an empty container also sets the
+     *       splitters to that batch's quantiles.
+     */
+    std::size_t insertBatch(const int* values, std::size_t count);
+
+    /**
+     * @brief Looks up many values, processing the shards in parallel.
+     * @param values  Values to look up.
+     * @param count   Number of values.
+     * @param results Output array of count flags, in the order of values.
+     */
+    void searchBatch(const int* values, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Learns splitters from a sample of keys and redistributes the contents.
+     * @param sample      Keys representative of the expected distribution.
+     * @param sampleCount Number of keys in sample; 0 keeps the current splitters.
+     */
+    void repartition(const int* sample, std::size_t sampleCount);
+
+    /**
+     * @brief Learns splitters from the current contents, evening out the shards.
+     */
+    void repartition();
+
+    /**
+     * @brief Calls a visitor with every value in ascending order.
+     * @param visit Callable invoked as visit(int) for each value.
+     * @details Shards are visited in key order, each under its own lock, so
+     *          writers to other shards are not blocked during the walk.
+     */
+    template <class Visitor>
+    void forEachInorder(Visitor visit) const;
+
+    /**
+     * @brief Writes all values in ascending order to a C stream.
+     */
+    void writeInorder(std::FILE* out) const;
+
+    /**
+     * @brief Prints all values in ascending order to standard output.
+     */
+    void inorder() const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief One key range: its tree and the lock that guards it.
+     * @details Padded to a cache line so that locking neighbouring shards
+     *          from different cores does not cause false sharing.
+     */
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        BST* tree;
+    };
+
+    Shard* shards;
+    std::size_t count;
+    /** count - 1 ascending boundaries; shard i starts at splitters[i - 1]. */
+    int* splitters;
+    BalancePolicy policy;
+    /** Held shared by every operation and exclusively by repartition(). */
+    mutable std::shared_mutex layoutMutex;
+    mutable ThreadPool pool;
+
+    /**
+     * @brief Returns the index of the shard whose range contains value.
+     */
+    std::size_t shardFor(int value) const;
+
+    /**
+     * @brief Sets the splitters to the quantiles of a sorted array.
+     */
+    void learnSplitters(const int* sorted, std::size_t n);
+
+    /**
+     * @brief Finds where each shard's run begins in a sorted array.
+     * @param bounds Output array of count + 1 offsets; shard i's run is
+     *               [bounds[i], bounds[i + 1]).
+     */
+    void partition(const int* sorted, std::size_t n, std::size_t* bounds) const;
+
+    /**
+     * @brief Replaces every shard with one built from a sorted array.
+     * @note The caller must hold layoutMutex exclusively.
+     */
+    void rebuildShards(const int* sorted, std::size_t n);
+
+    /**
+     * @brief Copies the contents of every shard, in order, into a new array.
+     * @param n Receives the number of values copied.
+     * @note The caller must hold layoutMutex exclusively.
+     */
+    int* collectAll(std::size_t& n) const;
+};
+
+// ---------------------------------------------------------------------------
+// Template member definitions
+// ---------------------------------------------------------------------------
+
+template <class Visitor>
+void ShardedBST::forEachInorder(Visitor visit) const {
+    std::shared_lock<std::shared_mutex> layout(layoutMutex);
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        shards[i].tree->forEachInorder(visit);
+    }
+}
+
+#endif // SHARDEDBST_H
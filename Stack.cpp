@@ -4,51 +4,94 @@
  *
  * @details
  * This file contains the implementation of the Stack class member functions,
- * which are used to support non-recursive traversal and deletion operations
- * within a binary search tree, including in-order traversal and tree destruction.
+ * which are used to support non-recursive traversal and rebalancing operations
+ * within a binary search tree, including in-order traversal and AVL path
+ * recording.
  *
  * The implementation is intentionally pointer-based and avoids the use of
  * STL containers or smart pointers to demonstrate fundamental memory management
- * concepts in C++. 
+ * concepts in C++. Elements are kept in a raw, growable array.
  */
 
 #include "Stack.h"
-#include <iostream>
 
 /**
- * Destroys the stack by removing all remaining nodes.
+ * Creates an empty stack backed by the inline array, reserving a heap
+ * array only if more room is requested up front.
+ */
+Stack::Stack(std::size_t initialCapacity)
+    : items(inlineItems), count(0), capacity(kInlineCapacity) {
+    reserve(initialCapacity);
+}
+
+/**
+ * Destroys the stack, releasing its heap array if it outgrew the inline one.
  */
 Stack::~Stack() {
-    // Remove all nodes from top to bottom.
-    while (!isEmpty()) {
-        pop();
-    }
+    if (items != inlineItems)
+        delete[] items;
 }
 
 /**
- * Inserts a node pointer at the top of the stack.
+ * Inserts a node pointer at the top of the stack, doubling the array when
+ * it is full.
  */
 void Stack::push(Node* n) {
-    StackNode* s = new StackNode(n);
-    s->next = top;
-    top = s;
+    if (count == capacity)
+        reserve(capacity * 2);
+    items[count++] = n;
 }
 
 /**
  * Pops a node off the stack and returns the stored tree node pointer.
  */
 Node* Stack::pop() {
-    if (!top) return nullptr;
-    StackNode* temp = top;
-    Node* result = temp->data;
-    top = top->next;
-    delete temp;
-    return result;
+    if (count == 0) return nullptr;
+    return items[--count];
+}
+
+/**
+ * Returns the stored tree node pointer at the top of the stack
+ * without modifying the stack.
+ */
+Node* Stack::peek() const {
+    return count ? items[count - 1] : nullptr;
 }
 
 /**
  * Determines whether the stack has any elements.
  */
 bool Stack::isEmpty() const {
-    return top == nullptr;
+    return count == 0;
+}
+
+/**
+ * Reports the number of stored elements.
+ */
+std::size_t Stack::size() const {
+    return count;
+}
+
+/**
+ * Grows the array to at least the requested capacity, copying the existing
+ * elements into the new array.
+ */
+void Stack::reserve(std::size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+
+    Node** grown = new Node*[newCapacity];
+    for (std::size_t i = 0; i < count; i++)
+        grown[i] = items[i];
+
+    if (items != inlineItems)
+        delete[] items;
+    items = grown;
+    capacity = newCapacity;
+}
+
+/**
+ * Forgets all elements; the array is kept for reuse.
+ */
+void Stack::clear() {
+    count = 0;
 }
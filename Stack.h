@@ -5,11 +5,11 @@
  * @details
  * This header declares the Stack class, which is used as an explicit stack
  * to support non-recursive operations within the binary search tree.
- * Specifically, it is utilized by the destroyTree() method invoked by the
- * BST destructor, as well as by the inorder() traversal method.
+ * Specifically, it is utilized by the inorder() traversal method and by the
+ * AVL rebalancing performed in insert() and remove().
  * 
- * Its purpose is to assist in tree traversal and deletion operations while ensuring
- * that all dynamically allocated memory is properly released.
+ * Its purpose is to assist in tree traversal and rebalancing operations while
+ * ensuring that all dynamically allocated memory is properly released.
  *
  * Implementation details are defined in Stack.cpp.
  *
@@ -23,6 +23,7 @@
 #ifndef STACK_H
 #define STACK_H
 
+#include <cstddef>
 #include "Node.h"
 
 /**
@@ -31,50 +32,54 @@
  * 
  * @details
  * The Stack class implements a simple stack structure composed of node pointers.
- * It is used to support traversal and deletion operations within a binary search
- * tree, including non-recursive in-order traversal and tree destruction.
+ * It is used to support traversal and rebalancing operations within a binary
+ * search tree, including non-recursive in-order traversal and recording the
+ * search path that AVL rebalancing walks back up.
  * 
+ * The elements are stored in a single contiguous array that doubles in size
+ * when it fills up, so push() and pop() run in amortized O(1) time and no
+ * memory is allocated per element. The first kInlineCapacity elements live
+ * in an array inside the Stack object itself, so a Stack declared as a local
+ * variable allocates nothing until it grows past that; a walk of a balanced
+ * tree never does. The array is kept when the stack is emptied, so a Stack
+ * that is reused across operations stops allocating once it has grown to the
+ * largest size it needs.
+ *
  * The Stack does not assume ownership of the tree nodes it stores; it manages
- * only the stack nodes required to support these operations.
+ * only the array required to support these operations.
  *
  * Supported operations include:
  * - push(): Adds a node pointer to the top of the stack.
  * - pop(): Removes and returns the top node pointer.
+ * - peek(): Returns the top node pointer without removing it.
  * - isEmpty(): Checks whether the stack is empty.
+ * - size(): Returns the number of stored node pointers.
+ * - reserve(): Pre-allocates capacity for a number of elements.
+ * - clear(): Removes all elements while keeping the allocated capacity.
  */
 
-/**
- * @brief Internal node type used by the Stack class.
- *
- * @details
- * StackNode stores a pointer to a tree Node and a link to the next stack node.
- * This struct is used only to implement the stack's internal linked list and
- * does not assume ownership of the Node* it stores.
- */
-struct StackNode {
-    Node* data;
-    StackNode* next;
-
+class Stack {
+public:
     /**
-     * @brief Constructs a StackNode with the specified node pointer.
-     * @param data Pointer to the Node stored in this stack element.
+     * @brief Number of elements stored without any heap allocation.
      */
-    StackNode(Node* data) : data(data), next(nullptr) {}
-};
+    static const std::size_t kInlineCapacity = 64;
 
-class Stack {
-public:
     /**
      * @brief Constructs an empty Stack.
-     * @note Initializes the stack with its top pointer set to nullptr.
+     * @param initialCapacity Number of elements to reserve up front; the
+     *        heap is only used if this exceeds kInlineCapacity.
      */
-    Stack() : top(nullptr) {}
+    explicit Stack(std::size_t initialCapacity = 0);
 
     /**
-     * @brief Destroys the Stack.
+     * @brief Destroys the Stack and frees its array if it left the inline one.
      */
     ~Stack();
 
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
+
     /**
      * @brief Pushes a node onto the stack.
      * @param n Pointer to the Node being added to the top of the stack.
@@ -83,18 +88,43 @@ public:
 
     /**
      * @brief Removes and returns the node at the top of the stack.
-     * @return Pointer to the node removed from the stack.
+     * @return Pointer to the node removed from the stack, or nullptr if empty.
      */
     Node* pop();
 
+    /**
+     * @brief Returns the node at the top of the stack without removing it.
+     * @return Pointer to the top node, or nullptr if the stack is empty.
+     */
+    Node* peek() const;
+
     /**
      * @brief Checks whether the stack is empty.
      * @return True if the stack contains no elements.
      */
     bool isEmpty() const;
 
+    /**
+     * @brief Returns the number of elements on the stack.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Ensures capacity for at least the given number of elements.
+     * @param capacity Minimum number of elements the array must hold.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Removes all elements without releasing the array.
+     */
+    void clear();
+
 private:
-    StackNode* top;
+    Node** items;
+    std::size_t count;
+    std::size_t capacity;
+    Node* inlineItems[kInlineCapacity];
 };
 
 #endif // STACK_H
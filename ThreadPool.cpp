@@ -0,0 +1,100 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the ThreadPool class.
+ *
+ * @details
+ * Each loop is identified by a generation number. A worker sleeps until the
+ * generation changes, helps drain the loop's iterations, and then reports
+ * back; the caller waits until every worker has reported, so a worker is
+ * never still touching a finished loop's task when the next loop starts.
+ */
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : workers(nullptr), workerCount(threads > 1 ? threads - 1 : 0),
+      currentTask(nullptr), currentCount(0), nextIndex(0),
+      busyWorkers(0), generation(0), stopping(false) {
+    if (workerCount > 0) {
+        workers = new std::thread[workerCount];
+        for (std::size_t i = 0; i < workerCount; i++)
+            workers[i] = std::thread(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::size_t i = 0; i < workerCount; i++)
+        workers[i].join();
+    delete[] workers;
+}
+
+/**
+ * Single-iteration loops and pools without workers run inline, avoiding
+ * the wake-up round trip.
+ */
+void ThreadPool::parallelFor(std::size_t taskCount, const std::function<void(std::size_t)>& task) {
+    if (taskCount == 0)
+        return;
+
+    if (workerCount == 0 || taskCount == 1) {
+        for (std::size_t i = 0; i < taskCount; i++)
+            task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(callMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        currentTask = &task;
+        currentCount = taskCount;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = workerCount;
+        generation++;
+    }
+    wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+    currentTask = nullptr;
+}
+
+std::size_t ThreadPool::threadCount() const {
+    return workerCount + 1;
+}
+
+void ThreadPool::drain() {
+    for (;;) {
+        std::size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (i >= currentCount)
+            return;
+        (*currentTask)(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--busyWorkers == 0)
+            finished.notify_one();
+    }
+}
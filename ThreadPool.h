@@ -0,0 +1,104 @@
+/**
+ * @file ThreadPool.h
+ * @brief Declaration of the ThreadPool class.
+ *
+ * @details
+ * This header declares ThreadPool, a small fixed-size pool of worker
+ * threads that runs data-parallel loops. It is used by ShardedBST to
+ * process the shards of a batch operation on separate cores.
+ *
+ * Implementation details are defined in ThreadPool.cpp.
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#pragma once
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads executing parallel-for loops.
+ *
+ * @details
+ * parallelFor() publishes a loop of taskCount iterations. The workers and
+ * the calling thread claim iterations one at a time from a shared atomic
+ * counter, so uneven iterations (such as shards of different sizes) balance
+ * themselves. The call returns once every iteration has finished.
+ *
+ * The workers are started once by the constructor and sleep on a condition
+ * variable between loops. Calls to parallelFor() from different threads
+ * are serialized.
+ */
+
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the pool.
+     * @param threads Total threads that run each loop, including the
+     *                caller; threads - 1 workers are started. 0 or 1 runs
+     *                every loop on the calling thread.
+     */
+    explicit ThreadPool(std::size_t threads);
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Runs task(i) for every i in [0, taskCount) and waits for all of them.
+     * @param taskCount Number of iterations.
+     * @param task      Callable invoked once per index; must be safe to run
+     *                  concurrently for different indices.
+     */
+    void parallelFor(std::size_t taskCount, const std::function<void(std::size_t)>& task);
+
+    /**
+     * @brief Returns the number of threads that run each loop, including the caller.
+     */
+    std::size_t threadCount() const;
+
+private:
+    std::thread* workers;
+    std::size_t workerCount;
+
+    /** Serializes parallelFor() callers. */
+    std::mutex callMutex;
+    /** Guards the loop description below and the wake-up state. */
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(std::size_t)>* currentTask;
+    std::size_t currentCount;
+    std::atomic<std::size_t> nextIndex;
+    std::size_t busyWorkers;
+    unsigned long generation;
+    bool stopping;
+
+    /**
+     * @brief Claims and runs iterations of the current loop until none remain.
+     */
+    void drain();
+
+    /**
+     * @brief Body of each worker thread.
+     */
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
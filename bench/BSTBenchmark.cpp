@@ -0,0 +1,628 @@
+/**
+ * @file BSTBenchmark.cpp
+ * @brief Baseline micro-benchmark suite for BST and BPlusTree across sizes, key distributions, and workloads.
+ *
+ * @details
+ * For every tree size from 10^3 up to the requested maximum (in powers of
+ * ten) and every key distribution, this benchmark builds a tree and times
+ * a fixed sequence of phases:
+ *
+ * | Phase        | Work                                                        |
+ * |--------------|-------------------------------------------------------------|
+ * | insert       | Build the tree, inserting the keys in distribution order    |
+ * | search-hit   | Look up keys that are present                               |
+ * | search-miss  | Look up keys that fall between present keys                 |
+ * | mix-95/5     | 95% lookups, 5% updates (half inserts, half removes)        |
+ * | mix-50/50    | 50% lookups, 50% updates                                    |
+ * | inorder      | forEachInorder() over the whole tree (cost per node)        |
+ * | morris       | forEachInorderStackless() over the whole tree (per node)    |
+ * | levelorder   | forEachLevelOrder() over the whole tree (cost per node)     |
+ * | remove       | Remove every key, in distribution order                     |
+ *
+ * The bplus engine runs the same phases against a BPlusTree, except morris
+ * and levelorder, which have no B+-tree counterpart.
+ *
+ * The tree holds the even keys of the data set, so odd keys are guaranteed
+ * misses. Updates insert or remove the odd neighbour of a chosen key, which
+ * keeps the tree between n and 2n values for the whole run.
+ *
+ * Distributions decide both the insertion order and which keys the lookup
+ * and update phases touch:
+ * - uniform: keys inserted in random order, accessed uniformly at random.
+ * - sorted / reverse: keys inserted in ascending / descending order and
+ *   accessed by a sweep in the same direction.
+ * - zipf: random insertion order; accesses follow a Zipf distribution
+ *   (theta 0.99) whose hot keys are scattered across the key space.
+ * - clustered: keys form dense runs of 64 with random gaps between runs;
+ *   runs are inserted in random order, and accesses pick a random run and
+ *   walk it.
+ *
+ * Each row reports ns/op, millions of ops per second, and the process's
+ * peak resident set size so far. On Linux, when perf_event_open() is
+ * permitted, it also reports cycles, instructions per cycle, last-level
+ * cache misses, and branch misses per op; otherwise those columns read
+ * "n/a". Short phases are repeated until they cover at least opsPerPhase
+ * operations, so small trees are timed over many runs rather than one.
+ *
+ * With --csv the same data is printed as comma-separated values, suitable
+ * for saving a baseline and diffing it against a later run.
+ *
+ * Usage:
+ *   BSTBenchmark [maxSize] [opsPerPhase] [avl|none|bplus] [--csv]
+ *
+ * Defaults are maxSize 1000000, opsPerPhase 1000000, and avl. A size of
+ * 10^8 needs several GB of memory. Without balancing, sorted and reverse
+ * insertion degenerate the tree into a list, so those runs are skipped
+ * above 10^3 keys.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 -march=native -I. bench/BSTBenchmark.cpp
+ *       BST.cpp Node.cpp NodePool.cpp Stack.cpp Queue.cpp FrozenBST.cpp
+ *       OutputBuffer.cpp KeyFormat.cpp MappedFile.cpp BloomFilter.cpp
+ *       BPlusTree.cpp -o BSTBenchmark
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "BPlusTree.h"
+#include "BST.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+enum class Distribution { Uniform, Sorted, Reverse, Zipf, Clustered };
+
+const Distribution kDistributions[] = {
+    Distribution::Uniform, Distribution::Sorted, Distribution::Reverse,
+    Distribution::Zipf, Distribution::Clustered
+};
+
+const char* distributionName(Distribution d) {
+    switch (d) {
+    case Distribution::Uniform:   return "uniform";
+    case Distribution::Sorted:    return "sorted";
+    case Distribution::Reverse:   return "reverse";
+    case Distribution::Zipf:      return "zipf";
+    case Distribution::Clustered: return "clustered";
+    }
+    return "?";
+}
+
+const std::size_t kClusterSize = 64;
+
+/** Written by every phase so the compiler cannot discard the work. */
+volatile std::uint64_t sink;
+
+/**
+ * Hardware counters for one phase, read as a group so they cover exactly
+ * the same instructions.
+ */
+struct Counters {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cacheMisses = 0;
+    std::uint64_t branchMisses = 0;
+};
+
+/**
+ * Times a phase, possibly over several start()/stop() intervals, and
+ * collects hardware counters alongside when the kernel allows it.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer() : groupFd(-1), nanos(0) {
+#if defined(__linux__)
+        static const std::uint64_t configs[4] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int i = 0; i < 4; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+            if (fd < 0) {
+                closeCounters();
+                break;
+            }
+            fds[i] = fd;
+            if (i == 0)
+                groupFd = fd;
+        }
+        if (groupFd >= 0)
+            ::ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~PhaseTimer() {
+        closeCounters();
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void start() {
+#if defined(__linux__)
+        if (groupFd >= 0)
+            ::ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        began = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        nanos += std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - began).count();
+#if defined(__linux__)
+        if (groupFd >= 0)
+            ::ioctl(groupFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    double elapsedNs() const { return nanos; }
+
+    bool hasCounters() const { return groupFd >= 0; }
+
+    Counters counters() const {
+        Counters c;
+#if defined(__linux__)
+        std::uint64_t values[5] = { 0, 0, 0, 0, 0 };
+        if (groupFd >= 0 && ::read(groupFd, values, sizeof(values)) == sizeof(values)) {
+            c.cycles = values[1];
+            c.instructions = values[2];
+            c.cacheMisses = values[3];
+            c.branchMisses = values[4];
+        }
+#endif
+        return c;
+    }
+
+private:
+    int groupFd;
+    int fds[4] = { -1, -1, -1, -1 };
+    double nanos;
+    std::chrono::steady_clock::time_point began;
+
+    void closeCounters() {
+#if defined(__linux__)
+        for (int i = 0; i < 4; i++) {
+            if (fds[i] >= 0)
+                ::close(fds[i]);
+            fds[i] = -1;
+        }
+#endif
+        groupFd = -1;
+    }
+};
+
+/**
+ * Zipf sampler over ranks [0, n) using the method of Gray et al. ("Quickly
+ * Generating Billion-Record Synthetic Databases"): O(n) setup to compute
+ * the normalizing constant, then O(1) memory and time per sample.
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(std::size_t n, double theta) : n(n), theta(theta) {
+        zetaN = zeta(n);
+        double zeta2 = zeta(2);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+    }
+
+    std::size_t operator()(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetaN;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + std::pow(0.5, theta))
+            return 1;
+        std::size_t rank = static_cast<std::size_t>(
+            static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+
+private:
+    std::size_t n;
+    double theta;
+    double zetaN;
+    double alpha;
+    double eta;
+
+    double zeta(std::size_t count) const {
+        double sum = 0;
+        for (std::size_t i = 1; i <= count; i++)
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+};
+
+/**
+ * One data set: the keys in insertion order, plus the stream of key
+ * indices that the lookup and update phases touch.
+ */
+struct Workload {
+    std::vector<int> insertOrder;
+    std::vector<std::uint32_t> accesses;
+};
+
+/**
+ * Keys are even, so key + 1 is always absent from the initial tree.
+ */
+Workload makeWorkload(Distribution d, std::size_t n, std::size_t accessCount, std::mt19937_64& rng) {
+    Workload w;
+    w.insertOrder.resize(n);
+
+    if (d == Distribution::Clustered) {
+        // Runs of kClusterSize consecutive even keys separated by random gaps.
+        std::int64_t next = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            if (i % kClusterSize == 0)
+                next += 2 * static_cast<std::int64_t>(1 + rng() % (4 * kClusterSize));
+            w.insertOrder[i] = static_cast<int>(next);
+            next += 2;
+        }
+        std::size_t clusters = (n + kClusterSize - 1) / kClusterSize;
+        std::vector<std::size_t> order(clusters);
+        for (std::size_t c = 0; c < clusters; c++)
+            order[c] = c;
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<int> sorted = w.insertOrder;
+        std::size_t out = 0;
+        for (std::size_t c : order) {
+            std::size_t first = c * kClusterSize;
+            std::size_t last = std::min(first + kClusterSize, n);
+            for (std::size_t i = first; i < last; i++)
+                w.insertOrder[out++] = sorted[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < n; i++)
+            w.insertOrder[i] = static_cast<int>(2 * i);
+        if (d == Distribution::Reverse)
+            std::reverse(w.insertOrder.begin(), w.insertOrder.end());
+        else if (d != Distribution::Sorted)
+            std::shuffle(w.insertOrder.begin(), w.insertOrder.end(), rng);
+    }
+
+    // Accesses index insertOrder, so sweeps follow the insertion order and
+    // Zipf hot ranks land on randomly placed keys.
+    w.accesses.resize(accessCount);
+    if (d == Distribution::Zipf) {
+        ZipfGenerator zipf(n, 0.99);
+        for (std::size_t i = 0; i < accessCount; i++)
+            w.accesses[i] = static_cast<std::uint32_t>(zipf(rng));
+    } else if (d == Distribution::Sorted || d == Distribution::Reverse) {
+        for (std::size_t i = 0; i < accessCount; i++)
+            w.accesses[i] = static_cast<std::uint32_t>(i % n);
+    } else if (d == Distribution::Clustered) {
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < accessCount; i++) {
+            if (i % kClusterSize == 0)
+                position = (rng() % ((n + kClusterSize - 1) / kClusterSize)) * kClusterSize;
+            w.accesses[i] = static_cast<std::uint32_t>(std::min(position + i % kClusterSize, n - 1));
+        }
+    } else {
+        for (std::size_t i = 0; i < accessCount; i++)
+            w.accesses[i] = static_cast<std::uint32_t>(rng() % n);
+    }
+
+    return w;
+}
+
+double peakRssMiB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+#else
+    return 0;
+#endif
+}
+
+struct Report {
+    bool csv;
+    /** Run the phases against a BPlusTree; policy is ignored then. */
+    bool bplus;
+    BalancePolicy policy;
+
+    const char* engineName() const {
+        if (bplus)
+            return "bplus";
+        return policy == BalancePolicy::AVL ? "avl" : "none";
+    }
+
+    void header() const {
+        if (csv) {
+            std::printf("policy,size,distribution,phase,ops,ns_per_op,mops_per_s,peak_rss_mib,"
+                        "cycles_per_op,ipc,llc_misses_per_op,branch_misses_per_op\n");
+        } else {
+            std::printf("%-10s %-10s %-12s %10s %9s %9s %8s %6s %9s %9s\n",
+                "size", "dist", "phase", "ns/op", "Mops/s", "RSS MiB",
+                "cyc/op", "IPC", "LLC/op", "brmiss/op");
+        }
+    }
+
+    void row(std::size_t size, Distribution d, const char* phase,
+             std::size_t ops, const PhaseTimer& timer) const {
+        double perOp = timer.elapsedNs() / static_cast<double>(ops);
+        double mops = 1e3 / perOp;
+        double rss = peakRssMiB();
+        Counters c = timer.counters();
+        double count = static_cast<double>(ops);
+        bool have = timer.hasCounters() && c.cycles > 0;
+
+        if (csv) {
+            std::printf("%s,%zu,%s,%s,%zu,%.2f,%.3f,%.1f,", engineName(),
+                size, distributionName(d), phase, ops, perOp, mops, rss);
+            if (have)
+                std::printf("%.1f,%.2f,%.3f,%.3f\n", c.cycles / count,
+                    static_cast<double>(c.instructions) / static_cast<double>(c.cycles),
+                    c.cacheMisses / count, c.branchMisses / count);
+            else
+                std::printf(",,,\n");
+        } else {
+            std::printf("%-10zu %-10s %-12s %10.1f %9.2f %9.1f ", size, distributionName(d), phase,
+                perOp, mops, rss);
+            if (have)
+                std::printf("%8.1f %6.2f %9.3f %9.3f\n", c.cycles / count,
+                    static_cast<double>(c.instructions) / static_cast<double>(c.cycles),
+                    c.cacheMisses / count, c.branchMisses / count);
+            else
+                std::printf("%8s %6s %9s %9s\n", "n/a", "n/a", "n/a", "n/a");
+        }
+        std::fflush(stdout);
+    }
+
+    void skipped(std::size_t size, Distribution d) const {
+        if (!csv)
+            std::printf("%-10zu %-10s (skipped: unbalanced tree would degenerate)\n",
+                size, distributionName(d));
+    }
+};
+
+/**
+ * Creates an empty tree of the engine being measured.
+ */
+template <class Tree>
+Tree* newTree(const Report& report);
+
+template <>
+BST* newTree<BST>(const Report& report) {
+    return new BST(report.policy);
+}
+
+template <>
+BPlusTree* newTree<BPlusTree>(const Report&) {
+    return new BPlusTree;
+}
+
+/**
+ * Interleaves lookups with updates of odd keys. Returns the number of
+ * operations that found or changed something, for the sink.
+ */
+template <class Tree>
+std::uint64_t runMix(Tree& tree, const Workload& w, int updatePercent, std::size_t ops) {
+    std::uint64_t hits = 0;
+    std::size_t accessCount = w.accesses.size();
+    for (std::size_t i = 0; i < ops; i++) {
+        int key = w.insertOrder[w.accesses[i % accessCount]];
+        // A multiplicative hash of i spreads the updates evenly.
+        int dice = static_cast<int>((static_cast<std::uint32_t>(i) * 2654435761u) >> 25) * 100 / 128;
+        if (dice < updatePercent / 2) {
+            tree.insert(key + 1);
+        } else if (dice < updatePercent) {
+            hits += tree.remove(key + 1);
+        } else {
+            hits += tree.search(key);
+        }
+    }
+    return hits;
+}
+
+template <class Tree>
+void runDataSet(const Report& report, std::size_t n, Distribution d,
+                std::size_t opsPerPhase, std::mt19937_64& rng) {
+    const std::size_t buildRepeats = std::max<std::size_t>(1, opsPerPhase / n);
+    Workload w = makeWorkload(d, n, opsPerPhase, rng);
+
+    // insert: repeated builds for small trees, keeping the last one.
+    Tree* tree = nullptr;
+    {
+        PhaseTimer timer;
+        for (std::size_t r = 0; r < buildRepeats; r++) {
+            delete tree;
+            tree = newTree<Tree>(report);
+            timer.start();
+            for (int key : w.insertOrder)
+                tree->insert(key);
+            timer.stop();
+        }
+        report.row(n, d, "insert", n * buildRepeats, timer);
+    }
+
+    {
+        PhaseTimer timer;
+        std::uint64_t hits = 0;
+        timer.start();
+        for (std::size_t i = 0; i < opsPerPhase; i++)
+            hits += tree->search(w.insertOrder[w.accesses[i]]);
+        timer.stop();
+        sink = hits;
+        report.row(n, d, "search-hit", opsPerPhase, timer);
+    }
+
+    {
+        PhaseTimer timer;
+        std::uint64_t hits = 0;
+        timer.start();
+        for (std::size_t i = 0; i < opsPerPhase; i++)
+            hits += tree->search(w.insertOrder[w.accesses[i]] + 1);
+        timer.stop();
+        sink = hits;
+        report.row(n, d, "search-miss", opsPerPhase, timer);
+    }
+
+    {
+        PhaseTimer timer;
+        timer.start();
+        sink = runMix(*tree, w, 5, opsPerPhase);
+        timer.stop();
+        report.row(n, d, "mix-95/5", opsPerPhase, timer);
+    }
+
+    {
+        PhaseTimer timer;
+        timer.start();
+        sink = runMix(*tree, w, 50, opsPerPhase);
+        timer.stop();
+        report.row(n, d, "mix-50/50", opsPerPhase, timer);
+    }
+
+    // Traversals: whole passes until at least opsPerPhase nodes are visited.
+    std::size_t nodes = tree->size();
+    std::size_t passes = std::max<std::size_t>(1, opsPerPhase / std::max<std::size_t>(1, nodes));
+    {
+        PhaseTimer timer;
+        std::uint64_t sum = 0;
+        timer.start();
+        for (std::size_t p = 0; p < passes; p++)
+            tree->forEachInorder([&sum](int value) { sum += static_cast<unsigned int>(value); });
+        timer.stop();
+        sink = sum;
+        report.row(n, d, "inorder", nodes * passes, timer);
+    }
+
+    if constexpr (std::is_same<Tree, BST>::value) {
+        {
+            PhaseTimer timer;
+            std::uint64_t sum = 0;
+            timer.start();
+            for (std::size_t p = 0; p < passes; p++)
+                tree->forEachInorderStackless([&sum](int value) { sum += static_cast<unsigned int>(value); });
+            timer.stop();
+            sink = sum;
+            report.row(n, d, "morris", nodes * passes, timer);
+        }
+
+        {
+            PhaseTimer timer;
+            std::uint64_t sum = 0;
+            timer.start();
+            for (std::size_t p = 0; p < passes; p++)
+                tree->forEachLevelOrder([&sum](int value) { sum += static_cast<unsigned int>(value); });
+            timer.stop();
+            sink = sum;
+            report.row(n, d, "levelorder", nodes * passes, timer);
+        }
+    }
+
+    // remove: every even key in insertion order, on freshly built trees.
+    {
+        PhaseTimer timer;
+        std::uint64_t removed = 0;
+        for (std::size_t r = 0; r < buildRepeats; r++) {
+            if (r > 0) {
+                delete tree;
+                tree = newTree<Tree>(report);
+                for (int key : w.insertOrder)
+                    tree->insert(key);
+            }
+            timer.start();
+            for (int key : w.insertOrder)
+                removed += tree->remove(key);
+            timer.stop();
+        }
+        sink = removed;
+        report.row(n, d, "remove", n * buildRepeats, timer);
+    }
+
+    delete tree;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t maxSize = 1000000;
+    std::size_t opsPerPhase = 1000000;
+    Report report;
+    report.csv = false;
+    report.bplus = false;
+    report.policy = BalancePolicy::AVL;
+
+    int position = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            report.csv = true;
+        } else if (std::strcmp(argv[i], "none") == 0) {
+            report.policy = BalancePolicy::None;
+            report.bplus = false;
+        } else if (std::strcmp(argv[i], "avl") == 0) {
+            report.policy = BalancePolicy::AVL;
+            report.bplus = false;
+        } else if (std::strcmp(argv[i], "bplus") == 0) {
+            report.bplus = true;
+        } else {
+            if (position == 0)
+                maxSize = std::strtoull(argv[i], nullptr, 10);
+            else if (position == 1)
+                opsPerPhase = std::strtoull(argv[i], nullptr, 10);
+            position++;
+        }
+    }
+    if (opsPerPhase == 0) opsPerPhase = 1;
+
+    if (!report.csv) {
+        std::printf("policy %s, sizes 1000..%zu, %zu ops per phase\n",
+            report.engineName(), maxSize, opsPerPhase);
+    }
+    report.header();
+
+    std::mt19937_64 rng(12345);
+    for (std::size_t n = 1000; n <= maxSize; n *= 10) {
+        for (Distribution d : kDistributions) {
+            bool degenerate = !report.bplus && report.policy == BalancePolicy::None
+                && (d == Distribution::Sorted || d == Distribution::Reverse) && n > 1000;
+            if (degenerate) {
+                report.skipped(n, d);
+                continue;
+            }
+            if (report.bplus)
+                runDataSet<BPlusTree>(report, n, d, opsPerPhase, rng);
+            else
+                runDataSet<BST>(report, n, d, opsPerPhase, rng);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file BatchSearchBenchmark.cpp
+ * @brief Compares BST::searchBatch() and FrozenBST against a loop of BST::search().
+ *
+ * @details
+ * This benchmark builds a tree of random keys, then looks up the same set of
+ * query keys (a mix of present and absent values) several ways: one search()
+ * call per key, searchBatch() over batches of the requested size, and the
+ * same two patterns against a FrozenBST snapshot of the tree. It reports
+ * nanoseconds per lookup for each method and the speedup over the loop.
+ *
+ * The interleaved path pays off once the tree no longer fits in the last
+ * level cache, so the default size is chosen to exceed typical LLC sizes.
+ *
+ * Usage:
+ *   BatchSearchBenchmark [treeSize] [queryCount] [batchSize]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 -march=native -I. bench/BatchSearchBenchmark.cpp
+ *       BST.cpp Node.cpp NodePool.cpp Stack.cpp Queue.cpp FrozenBST.cpp
+ *       OutputBuffer.cpp KeyFormat.cpp MappedFile.cpp BloomFilter.cpp
+ *       -o BatchSearchBenchmark
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "BST.h"
+
+namespace {
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t treeSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::size_t queryCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+    std::size_t batchSize = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 256;
+    if (batchSize == 0) batchSize = 1;
+
+    std::mt19937 rng(12345);
+
+    // Even keys are inserted, so odd queries are guaranteed misses.
+    BST tree(BalancePolicy::AVL);
+    for (std::size_t i = 0; i < treeSize; i++)
+        tree.insert(static_cast<int>(rng() % (treeSize * 4)) & ~1);
+
+    int* queries = new int[queryCount];
+    bool* results = new bool[queryCount];
+    for (std::size_t i = 0; i < queryCount; i++)
+        queries[i] = static_cast<int>(rng() % (treeSize * 4));
+
+    // Loop of single searches.
+    std::size_t loopHits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queryCount; i++)
+        loopHits += tree.search(queries[i]);
+    double loopNs = elapsedNs(start);
+
+    // Batched, interleaved searches.
+    std::size_t batchHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queryCount; i += batchSize) {
+        std::size_t n = (queryCount - i < batchSize) ? queryCount - i : batchSize;
+        tree.searchBatch(queries + i, n, results + i);
+    }
+    double batchNs = elapsedNs(start);
+
+    for (std::size_t i = 0; i < queryCount; i++)
+        batchHits += results[i];
+
+    // Frozen snapshot, single and batched.
+    FrozenBST snapshot = tree.freeze();
+
+    std::size_t frozenHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queryCount; i++)
+        frozenHits += snapshot.search(queries[i]);
+    double frozenNs = elapsedNs(start);
+
+    std::size_t frozenBatchHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queryCount; i += batchSize) {
+        std::size_t n = (queryCount - i < batchSize) ? queryCount - i : batchSize;
+        snapshot.searchBatch(queries + i, n, results + i);
+    }
+    double frozenBatchNs = elapsedNs(start);
+
+    for (std::size_t i = 0; i < queryCount; i++)
+        frozenBatchHits += results[i];
+
+    std::printf("tree size      : %zu\n", treeSize);
+    std::printf("queries        : %zu (batch size %zu)\n", queryCount, batchSize);
+    std::printf("search() loop  : %8.1f ns/lookup (%zu hits)\n", loopNs / queryCount, loopHits);
+    std::printf("searchBatch()  : %8.1f ns/lookup (%zu hits)\n", batchNs / queryCount, batchHits);
+    std::printf("  speedup      : %8.2fx\n", loopNs / batchNs);
+    std::printf("frozen search  : %8.1f ns/lookup (%zu hits)\n", frozenNs / queryCount, frozenHits);
+    std::printf("  speedup      : %8.2fx\n", loopNs / frozenNs);
+    std::printf("frozen batch   : %8.1f ns/lookup (%zu hits)\n", frozenBatchNs / queryCount, frozenBatchHits);
+    std::printf("  speedup      : %8.2fx\n", loopNs / frozenBatchNs);
+
+    delete[] queries;
+    delete[] results;
+
+    bool consistent = loopHits == batchHits && loopHits == frozenHits
+        && loopHits == frozenBatchHits;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file ConcurrentBenchmark.cpp
+ * @brief Multi-threaded stress test and throughput benchmark for the concurrent trees.
+ *
+ * @details
+ * This benchmark runs the same randomized workload against three trees:
+ * an AVL-balanced BST behind one global mutex (the baseline), ConcurrentBST,
+ * and LockFreeBST. The tree is prefilled with half of the key range, then each
+ * thread performs a random mix of search(), insert(), and remove() for a
+ * fixed time. It reports total throughput for each thread count from 1 up
+ * to the requested maximum, doubling each step.
+ *
+ * Every run is also a stress test. Each thread keeps the net number of
+ * successful inserts minus removes it performed; afterwards the prefill
+ * plus those totals must equal both size() and the number of keys in the
+ * range that search() still finds. A mismatch is reported and makes the
+ * program exit with status 1.
+ *
+ * Usage:
+ *   ConcurrentBenchmark [maxThreads] [keyRange] [updatePercent] [millisPerRun]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 -pthread -I. bench/ConcurrentBenchmark.cpp
+ *       BST.cpp Node.cpp NodePool.cpp Stack.cpp Queue.cpp FrozenBST.cpp
+ *       OutputBuffer.cpp KeyFormat.cpp MappedFile.cpp BloomFilter.cpp
+ *       ConcurrentBST.cpp LockFreeBST.cpp EpochReclaimer.cpp -o ConcurrentBenchmark
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "BST.h"
+#include "ConcurrentBST.h"
+#include "LockFreeBST.h"
+
+namespace {
+
+/**
+ * The baseline: the sequential tree serialized by a single mutex.
+ */
+class LockedBST {
+public:
+    bool insert(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t before = tree.size();
+        tree.insert(value);
+        return tree.size() != before;
+    }
+
+    bool search(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.search(value);
+    }
+
+    bool remove(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.remove(value);
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.size();
+    }
+
+private:
+    std::mutex mutex;
+    BST tree{ BalancePolicy::AVL };
+};
+
+struct RunResult {
+    double opsPerSecond;
+    bool consistent;
+};
+
+/**
+ * Runs one timed workload on a fresh tree and checks the final contents.
+ */
+template <class Tree>
+RunResult runWorkload(int threads, int keyRange, int updatePercent, int millis) {
+    Tree tree;
+    long long expected = 0;
+
+    // The concurrent trees do not rebalance, so prefill in random order.
+    std::mt19937 fill(7);
+    std::vector<int> initial;
+    for (int k = 0; k < keyRange; k++)
+        if (fill() & 1)
+            initial.push_back(k);
+    std::shuffle(initial.begin(), initial.end(), fill);
+    for (int k : initial)
+        expected += tree.insert(k);
+
+    std::atomic<bool> start(false);
+    std::atomic<bool> stop(false);
+    std::vector<long long> ops(threads, 0);
+    std::vector<long long> net(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(1000 + t);
+            long long done = 0;
+            long long delta = 0;
+            while (!start.load(std::memory_order_acquire)) {}
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 64; i++) {
+                    unsigned int r = rng();
+                    int key = static_cast<int>((r >> 8) % static_cast<unsigned int>(keyRange));
+                    int dice = static_cast<int>(r & 0xFF) * 100 / 256;
+                    if (dice < updatePercent / 2)
+                        delta += tree.insert(key);
+                    else if (dice < updatePercent)
+                        delta -= tree.remove(key);
+                    else
+                        tree.search(key);
+                }
+                done += 64;
+            }
+
+            ops[t] = done;
+            net[t] = delta;
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+    stop.store(true);
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    long long totalOps = 0;
+    for (int t = 0; t < threads; t++) {
+        totalOps += ops[t];
+        expected += net[t];
+    }
+
+    long long found = 0;
+    for (int k = 0; k < keyRange; k++)
+        found += tree.search(k);
+
+    RunResult result;
+    result.opsPerSecond = totalOps / seconds;
+    result.consistent = found == expected && static_cast<long long>(tree.size()) == expected;
+    return result;
+}
+
+template <class Tree>
+bool runSeries(const char* name, int maxThreads, int keyRange, int updatePercent, int millis) {
+    bool ok = true;
+    double single = 0;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RunResult r = runWorkload<Tree>(threads, keyRange, updatePercent, millis);
+        if (threads == 1)
+            single = r.opsPerSecond;
+        std::printf("%-14s %3d threads : %8.2f Mops/s  (%5.2fx)%s\n", name, threads,
+            r.opsPerSecond / 1e6, r.opsPerSecond / single, r.consistent ? "" : "  INCONSISTENT");
+        ok = ok && r.consistent;
+    }
+
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : (hardware > 0 ? hardware : 4);
+    int keyRange = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    int updatePercent = argc > 3 ? std::atoi(argv[3]) : 10;
+    int millis = argc > 4 ? std::atoi(argv[4]) : 1000;
+    if (maxThreads < 1) maxThreads = 1;
+    if (keyRange < 1) keyRange = 1;
+
+    std::printf("key range %d, %d%% updates, %d ms per run\n", keyRange, updatePercent, millis);
+
+    bool ok = runSeries<LockedBST>("mutex BST", maxThreads, keyRange, updatePercent, millis);
+    ok = runSeries<ConcurrentBST>("ConcurrentBST", maxThreads, keyRange, updatePercent, millis) && ok;
+    ok = runSeries<LockFreeBST>("LockFreeBST", maxThreads, keyRange, updatePercent, millis) && ok;
+
+    return ok ? 0 : 1;
+}
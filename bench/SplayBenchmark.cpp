@@ -0,0 +1,209 @@
+/**
+ * @file SplayBenchmark.cpp
+ * @brief Compares splay, AVL, and unbalanced trees under skewed (Zipfian) lookups.
+ *
+ * @details
+ * This benchmark builds trees of the same random keys under each balancing
+ * policy and times the same stream of lookups against each. The lookups
+ * follow a Zipf distribution (theta 0.99 by default, so about 90% of them
+ * hit the hottest few percent of keys); the hot keys are scattered across
+ * the key space, so they are not clustered in one subtree. Configurations:
+ *
+ * | Tree         | Setup                                                        |
+ * |--------------|--------------------------------------------------------------|
+ * | none         | BalancePolicy::None, keys inserted in random order           |
+ * | avl          | BalancePolicy::AVL                                           |
+ * | splay        | BalancePolicy::Splay; every lookup splays                    |
+ * | splay/k      | BalancePolicy::Splay with setSplayInterval(k): one lookup in |
+ * |              | k splays, the rest are plain descents                        |
+ * | splay-frozen | splay tree warmed up by half the lookups, then switched to   |
+ * |              | BalancePolicy::None so lookups stop adjusting it             |
+ *
+ * Each row reports nanoseconds per lookup and, when the library is built
+ * with BST_ENABLE_STATS set to 1, the average number of nodes visited per
+ * lookup (the depth at which it ended). The counters add the same small
+ * cost to every configuration.
+ *
+ * Typical result with the defaults: splay visits about 17 nodes per lookup
+ * against AVL's 19, yet takes roughly twice AVL's time, and splay/16 still
+ * takes 10-30% longer than AVL. Only splay-frozen matches or beats AVL.
+ * With theta 1.2, splay/16 and above match AVL and splay-frozen is
+ * about 35% faster.
+ *
+ * Usage:
+ *   SplayBenchmark [treeSize] [lookupCount] [theta] [k]
+ *
+ * Defaults are 10^6 keys, 10^7 lookups, theta 0.99, and k = 16.
+ *
+ * Build (from the repository root; add -DBST_ENABLE_STATS=1 for the
+ * nodes-per-lookup column):
+ *   g++ -std=c++17 -O2 -march=native -I. bench/SplayBenchmark.cpp
+ *       BST.cpp Node.cpp NodePool.cpp Stack.cpp Queue.cpp FrozenBST.cpp
+ *       OutputBuffer.cpp KeyFormat.cpp MappedFile.cpp BloomFilter.cpp
+ *       -o SplayBenchmark
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "BST.h"
+
+namespace {
+
+/** Written by every run so the compiler cannot discard the lookups. */
+volatile std::uint64_t sink;
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Zipf sampler over ranks [0, n) using the method of Gray et al. ("Quickly
+ * Generating Billion-Record Synthetic Databases"), as in BSTBenchmark.
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(std::size_t n, double theta) : n(n), theta(theta) {
+        zetaN = zeta(n);
+        double zeta2 = zeta(2);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+    }
+
+    std::size_t operator()(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetaN;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + std::pow(0.5, theta))
+            return 1;
+        std::size_t rank = static_cast<std::size_t>(
+            static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+
+private:
+    std::size_t n;
+    double theta;
+    double zetaN;
+    double alpha;
+    double eta;
+
+    double zeta(std::size_t count) const {
+        double sum = 0;
+        for (std::size_t i = 1; i <= count; i++)
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+};
+
+/**
+ * Looks up every key in [first, last) through access(), so splay trees
+ * adapt, and returns the number found.
+ */
+std::uint64_t lookupAll(BST& tree, const int* first, const int* last) {
+    std::uint64_t found = 0;
+    for (const int* key = first; key != last; ++key)
+        found += tree.access(*key);
+    return found;
+}
+
+/**
+ * Times the lookups against a tree and prints one row. Counters are reset
+ * first, so nodes per lookup covers exactly the timed lookups.
+ */
+void report(const char* name, BST& tree, const int* first, const int* last) {
+    tree.resetCounters();
+
+    auto start = std::chrono::steady_clock::now();
+    sink = lookupAll(tree, first, last);
+    double ns = elapsedNs(start);
+
+    std::size_t count = static_cast<std::size_t>(last - first);
+    BSTStats stats = tree.stats();
+    std::printf("%-13s %10.1f", name, ns / static_cast<double>(count));
+    if (stats.countersEnabled && stats.searches > 0)
+        std::printf(" %14.2f", static_cast<double>(stats.nodesVisited) / static_cast<double>(stats.searches));
+    else
+        std::printf(" %14s", "n/a");
+    std::printf(" %8zu\n", stats.height);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t treeSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t lookupCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    double theta = argc > 3 ? std::atof(argv[3]) : 0.99;
+    unsigned int interval = argc > 4 ? static_cast<unsigned int>(std::strtoul(argv[4], nullptr, 10)) : 16;
+    if (treeSize == 0) treeSize = 1;
+    if (lookupCount < 2) lookupCount = 2;
+
+    std::mt19937_64 rng(12345);
+
+    // Distinct keys in random insertion order.
+    int* keys = new int[treeSize];
+    for (std::size_t i = 0; i < treeSize; i++)
+        keys[i] = static_cast<int>(i * 2);
+    std::shuffle(keys, keys + treeSize, rng);
+
+    // Zipf rank r looks up byRank[r], an independent shuffle of the keys,
+    // so hotness is unrelated to both key order and insertion order (keys
+    // inserted early sit near the root of the unbalanced tree).
+    int* byRank = new int[treeSize];
+    std::copy(keys, keys + treeSize, byRank);
+    std::shuffle(byRank, byRank + treeSize, rng);
+
+    ZipfGenerator zipf(treeSize, theta);
+    int* lookups = new int[lookupCount];
+    for (std::size_t i = 0; i < lookupCount; i++)
+        lookups[i] = byRank[zipf(rng)];
+    delete[] byRank;
+
+    std::printf("%zu keys, %zu lookups, Zipf theta %.2f\n", treeSize, lookupCount, theta);
+    std::printf("%-13s %10s %14s %8s\n", "tree", "ns/lookup", "nodes/lookup", "height");
+
+    const BalancePolicy policies[] = { BalancePolicy::None, BalancePolicy::AVL, BalancePolicy::Splay };
+    const char* names[] = { "none", "avl", "splay" };
+
+    for (int p = 0; p < 3; p++) {
+        BST tree(policies[p]);
+        for (std::size_t i = 0; i < treeSize; i++)
+            tree.insert(keys[i]);
+        report(names[p], tree, lookups, lookups + lookupCount);
+    }
+
+    {
+        BST tree(BalancePolicy::Splay);
+        tree.setSplayInterval(interval);
+        for (std::size_t i = 0; i < treeSize; i++)
+            tree.insert(keys[i]);
+        char name[32];
+        std::snprintf(name, sizeof(name), "splay/%u", interval);
+        report(name, tree, lookups, lookups + lookupCount);
+    }
+
+    // Warm up on the first half, freeze, and replay the second half.
+    {
+        BST tree(BalancePolicy::Splay);
+        for (std::size_t i = 0; i < treeSize; i++)
+            tree.insert(keys[i]);
+        std::size_t half = lookupCount / 2;
+        sink = lookupAll(tree, lookups, lookups + half);
+        tree.setBalancePolicy(BalancePolicy::None);
+        report("splay-frozen", tree, lookups + half, lookups + lookupCount);
+    }
+
+    delete[] lookups;
+    delete[] keys;
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file BSTMapTest.cpp
+ * @brief Checks BSTMap against std::map under random operations.
+ *
+ * @details
+ * Runs the same random sequence of emplace, insert, find, contains, and
+ * remove calls against a BSTMap and a std::map, comparing every result,
+ * and compares the size and in-order contents every 10000 operations. A
+ * second part exercises a std::string key with std::string_view and
+ * string-literal lookups through the transparent default comparator, a
+ * custom (non-transparent) comparator, and a value type without a default
+ * constructor built in place by emplace.
+ *
+ * Prints "OK" and exits with status 0 when every check passes; otherwise
+ * prints the first failing check and exits with status 1.
+ *
+ * Usage:
+ *   BSTMapTest [operations] [seed]
+ *
+ * Defaults are 200000 operations and seed 1.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Wextra -I. tests/BSTMapTest.cpp BSTMap.cpp
+ *       -o BSTMapTest
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include "BSTMap.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+
+/**
+ * Reports a failed check with its line and ends the program.
+ */
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            std::printf("FAILED line %d: %s\n", __LINE__, #condition);      \
+            std::exit(1);                                                  \
+        }                                                                  \
+    } while (0)
+
+namespace {
+
+/**
+ * Compares a map's in-order contents with the reference and returns the
+ * number of nodes visited, so the caller can check size() too.
+ */
+template <class Map, class Reference>
+std::size_t checkContents(const Map& map, const Reference& reference) {
+    auto it = reference.begin();
+    std::size_t visited = 0;
+    map.forEach([&](const auto& key, const auto& value) {
+        CHECK(it != reference.end());
+        CHECK(key == it->first);
+        CHECK(value == it->second);
+        ++it;
+        visited++;
+    });
+    CHECK(it == reference.end());
+    return visited;
+}
+
+/**
+ * A value with no default constructor, so emplace() must construct it in place.
+ */
+struct Record {
+    Record(int a, int b) : sum(a + b) {}
+    int sum;
+};
+
+/**
+ * Orders strings by length first; deliberately not transparent.
+ */
+struct ByLength {
+    bool operator()(const std::string& a, const std::string& b) const {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    }
+};
+
+void randomOperations(std::size_t operations, unsigned int seed) {
+    std::mt19937 rng(seed);
+    BSTMap<int, std::uint64_t> map;
+    std::map<int, std::uint64_t> reference;
+    const int keyRange = 5000;
+
+    for (std::size_t i = 0; i < operations; i++) {
+        int key = static_cast<int>(rng() % keyRange);
+        std::uint64_t value = rng();
+
+        switch (rng() % 5) {
+        case 0: {
+            std::pair<std::uint64_t*, bool> result = map.emplace(key, value);
+            bool inserted = reference.emplace(key, value).second;
+            CHECK(result.second == inserted);
+            CHECK(*result.first == reference[key]);
+            break;
+        }
+        case 1:
+            CHECK(map.insert(key, value) == reference.emplace(key, value).second);
+            break;
+        case 2: {
+            std::uint64_t* found = map.find(key);
+            auto expected = reference.find(key);
+            CHECK((found != nullptr) == (expected != reference.end()));
+            if (found) {
+                CHECK(*found == expected->second);
+                *found = value;
+                expected->second = value;
+            }
+            break;
+        }
+        case 3:
+            CHECK(map.contains(key) == (reference.count(key) > 0));
+            break;
+        default:
+            CHECK(map.remove(key) == (reference.erase(key) > 0));
+            break;
+        }
+
+        if (i % 10000 == 0 || i + 1 == operations) {
+            CHECK(map.size() == reference.size());
+            CHECK(map.isEmpty() == reference.empty());
+            CHECK(checkContents(map, reference) == reference.size());
+        }
+    }
+
+    map.clear();
+    CHECK(map.isEmpty());
+    CHECK(map.find(0) == nullptr);
+}
+
+void stringKeys() {
+    BSTMap<std::string, int> map;
+    CHECK(map.insert("delta", 4));
+    CHECK(map.insert("alpha", 1));
+    CHECK(map.insert("charlie", 3));
+    CHECK(!map.insert("alpha", 100));
+    CHECK(map.emplace(std::string("bravo"), 2).second);
+
+    std::string_view view = "charlie";
+    const int* found = map.find(view);
+    CHECK(found && *found == 3);
+    CHECK(map.contains("bravo"));
+    CHECK(!map.contains(std::string_view("echo")));
+    CHECK(map.remove(std::string_view("delta")));
+    CHECK(!map.remove("delta"));
+
+    std::map<std::string, int> reference = { { "alpha", 1 }, { "bravo", 2 }, { "charlie", 3 } };
+    CHECK(checkContents(map, reference) == 3);
+
+    BSTMap<std::string, int, ByLength> byLength;
+    CHECK(byLength.insert("ccc", 3));
+    CHECK(byLength.insert("a", 1));
+    CHECK(byLength.insert("bb", 2));
+    std::map<std::string, int, ByLength> lengthReference = { { "a", 1 }, { "bb", 2 }, { "ccc", 3 } };
+    CHECK(checkContents(byLength, lengthReference) == 3);
+    CHECK(byLength.find(std::string("bb")) != nullptr);
+
+    BSTMap<int, Record> records;
+    std::pair<Record*, bool> made = records.emplace(7, 3, 4);
+    CHECK(made.second && made.first->sum == 7);
+    CHECK(!records.emplace(7, 0, 0).second);
+    CHECK(records.find(7)->sum == 7);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    unsigned int seed = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+    randomOperations(operations, seed);
+    stringKeys();
+
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file SplitJoinTest.cpp
+ * @brief Checks that repeated BST::split() and BST::join() keep the node
+ *        storage constant.
+ *
+ * @details
+ * Splits an AVL tree several slabs in size around its middle value and
+ * joins the halves back together, over and over. Both halves are larger
+ * than one pool slab, so every split shares the pool's slabs between the
+ * two trees and every join brings the shared storage back into one pool.
+ * After each cycle the tree must hold the same values, and stats() must
+ * report the slab count and reserved bytes it reported before the first
+ * split. Each half must report no more slabs than the whole tree.
+ *
+ * Prints "OK" and exits with status 0 when every check passes; otherwise
+ * prints the first failing check and exits with status 1.
+ *
+ * Usage:
+ *   SplitJoinTest [values] [cycles]
+ *
+ * Defaults are 100000 values and 40 cycles.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Wextra -pthread -I. tests/SplitJoinTest.cpp
+ *       BST.cpp BloomFilter.cpp FrozenBST.cpp KeyFormat.cpp MappedFile.cpp
+ *       Node.cpp NodePool.cpp OutputBuffer.cpp Queue.cpp Stack.cpp
+ *       -o SplitJoinTest
+ *
+ * @author Arto Baltayan
+ * @date January 2026
+ * @version 1.0
+ */
+
+#include "BST.h"
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Reports a failed check with its line and ends the program.
+ */
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            std::printf("FAILED line %d: %s\n", __LINE__, #condition);      \
+            std::exit(1);                                                  \
+        }                                                                  \
+    } while (0)
+
+namespace {
+
+/**
+ * Checks that the tree holds exactly 0 .. count - 1 in order.
+ */
+void checkContents(const BST& tree, int count) {
+    int expected = 0;
+    tree.forEachInorder([&expected](int value) {
+        CHECK(value == expected);
+        expected++;
+    });
+    CHECK(expected == count);
+    CHECK(tree.size() == static_cast<std::size_t>(count));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int cycles = argc > 2 ? std::atoi(argv[2]) : 40;
+    int pivot = count / 2;
+
+    BST tree(BalancePolicy::AVL);
+    for (int i = 0; i < count; i++)
+        tree.insert(i);
+
+    BSTStats before = tree.stats();
+    CHECK(before.slabCount > 2);
+
+    for (int cycle = 0; cycle < cycles; cycle++) {
+        BST greater(BalancePolicy::AVL);
+        CHECK(tree.split(pivot, greater));
+        CHECK(tree.stats().slabCount <= before.slabCount);
+        CHECK(greater.stats().slabCount <= before.slabCount);
+
+        CHECK(tree.join(pivot, greater));
+        CHECK(greater.size() == 0);
+
+        BSTStats after = tree.stats();
+        CHECK(after.slabCount == before.slabCount);
+        CHECK(after.reservedBytes == before.reservedBytes);
+        checkContents(tree, count);
+    }
+
+    std::printf("OK\n");
+    return 0;
+}